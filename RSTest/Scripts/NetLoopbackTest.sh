@@ -0,0 +1,56 @@
+#!/usr/bin/env bash
+# Runs a dedicated server and N headless bot clients on this machine for each client count, and collects the server's
+# net reports (bandwidth per connection, game thread time each client adds over the empty server) from Saved/NetReports.
+#
+# Needs a packaged or staged Linux build with the RSTestServer target:
+#   NetLoopbackTest.sh <ServerBinary> <ClientBinary> [ClientCounts...]
+# e.g. NetLoopbackTest.sh Binaries/Linux/RSTestServer Binaries/Linux/RSTest 2 8 32
+
+set -euo pipefail
+
+if [ $# -lt 2 ]; then
+	echo "Usage: $0 <ServerBinary> <ClientBinary> [ClientCounts...]"
+	exit 1
+fi
+
+SERVER="$1"
+CLIENT="$2"
+shift 2
+CLIENT_COUNTS=("${@:-2 8 32}")
+CLIENT_COUNTS=(${CLIENT_COUNTS[@]})
+
+MAP="/Game/FirstPersonCPP/Maps/FirstPersonExampleMap"
+PORT="${RS_NET_PORT:-7777}"
+MEASURE_SECONDS="${RS_NET_SECONDS:-60}"
+LOG_DIR="${RS_NET_LOG_DIR:-NetLoopbackLogs}"
+
+mkdir -p "$LOG_DIR"
+
+for COUNT in "${CLIENT_COUNTS[@]}"; do
+	echo "Net loopback test: $COUNT clients"
+
+	"$SERVER" "$MAP" -server -port="$PORT" -unattended -log -RSNetReport="$MEASURE_SECONDS" -RSNetReportClients="$COUNT" \
+		-abslog="$LOG_DIR/Server-$COUNT.log" > /dev/null 2>&1 &
+	SERVER_PID=$!
+
+	# Give the server time to load the map and measure its baseline with nobody connected before the clients start knocking
+	sleep 15
+
+	CLIENT_PIDS=()
+	for ((i = 0; i < COUNT; i++)); do
+		"$CLIENT" 127.0.0.1:"$PORT" -game -nullrhi -nosound -unattended -RSNetBot \
+			-abslog="$LOG_DIR/Client-$COUNT-$i.log" > /dev/null 2>&1 &
+		CLIENT_PIDS+=($!)
+		sleep 0.5
+	done
+
+	# The server quits by itself once its report is written
+	wait "$SERVER_PID" || true
+
+	for PID in "${CLIENT_PIDS[@]}"; do
+		kill "$PID" 2> /dev/null || true
+	done
+	wait || true
+done
+
+echo "Reports are in the server's Saved/NetReports"
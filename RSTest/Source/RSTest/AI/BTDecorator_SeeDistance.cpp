@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BTDecorator_SeeDistance.h"
+#include "AIController.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+
+UBTDecorator_SeeDistance::UBTDecorator_SeeDistance()
+{
+	NodeName = TEXT("See Distance");
+
+	_playerPositionKey.SelectedKeyName = TEXT("PlayerLocation");
+	_playerPositionKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTDecorator_SeeDistance, _playerPositionKey));
+
+	_sightRange = 3000.f;
+}
+
+void UBTDecorator_SeeDistance::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	if (UBlackboardData* blackboardAsset = GetBlackboardAsset())
+	{
+		_playerPositionKey.ResolveSelectedKey(*blackboardAsset);
+	}
+}
+
+bool UBTDecorator_SeeDistance::CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const
+{
+	const UBlackboardComponent* blackboard = OwnerComp.GetBlackboardComponent();
+	const AAIController* controller = OwnerComp.GetAIOwner();
+	const APawn* pawn = controller ? controller->GetPawn() : nullptr;
+	if (!blackboard || !pawn)
+	{
+		return false;
+	}
+
+	const FVector playerPosition = blackboard->GetValueAsVector(_playerPositionKey.SelectedKeyName);
+	return FVector::DistSquared(playerPosition, pawn->GetActorLocation()) <= FMath::Square(_sightRange);
+}
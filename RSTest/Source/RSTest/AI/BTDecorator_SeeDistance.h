@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTDecorator.h"
+#include "BTDecorator_SeeDistance.generated.h"
+
+/**
+ * Native Decorator_SeeDistance. Passes while the player position is within sight range of the pawn.
+ * (Decorator_CanSeeTarget and Decorator_CanAttack are plain bool checks, the engine's Blackboard decorator already covers them natively)
+ */
+UCLASS(meta = (DisplayName = "See Distance"))
+class RSTEST_API UBTDecorator_SeeDistance : public UBTDecorator
+{
+	GENERATED_BODY()
+
+public:
+	UBTDecorator_SeeDistance();
+
+	//Variables
+protected:
+	UPROPERTY(EditAnywhere, Category = "See Distance Data")
+	FBlackboardKeySelector _playerPositionKey;
+
+	UPROPERTY(EditAnywhere, Category = "See Distance Data", meta = (ClampMin = 0))
+	float _sightRange;
+
+	//Functions
+public:
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+
+protected:
+	virtual bool CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const override;
+};
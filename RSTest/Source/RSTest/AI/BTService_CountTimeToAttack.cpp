@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BTService_CountTimeToAttack.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "Engine/World.h"
+
+UBTService_CountTimeToAttack::UBTService_CountTimeToAttack()
+{
+	NodeName = TEXT("Count Time To Attack Again");
+	bNotifyBecomeRelevant = true;
+
+	Interval = 0.2f;
+	RandomDeviation = 0.05f;
+
+	_timeSinceLastAttackKey.SelectedKeyName = TEXT("TimeSinceLastAttack");
+	_timeSinceLastAttackKey.AddFloatFilter(this, GET_MEMBER_NAME_CHECKED(UBTService_CountTimeToAttack, _timeSinceLastAttackKey));
+
+	_canAttackKey.SelectedKeyName = TEXT("CanAttack");
+	_canAttackKey.AddBoolFilter(this, GET_MEMBER_NAME_CHECKED(UBTService_CountTimeToAttack, _canAttackKey));
+
+	_timeBetweenAttacks = 2.f;
+}
+
+void UBTService_CountTimeToAttack::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	if (UBlackboardData* blackboardAsset = GetBlackboardAsset())
+	{
+		_timeSinceLastAttackKey.ResolveSelectedKey(*blackboardAsset);
+		_canAttackKey.ResolveSelectedKey(*blackboardAsset);
+	}
+}
+
+void UBTService_CountTimeToAttack::OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	Super::OnBecomeRelevant(OwnerComp, NodeMemory);
+
+	FCountTimeMemory* memory = reinterpret_cast<FCountTimeMemory*>(NodeMemory);
+	memory->LastCountTime = OwnerComp.GetWorld()->GetTimeSeconds();
+}
+
+void UBTService_CountTimeToAttack::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
+
+	UBlackboardComponent* blackboard = OwnerComp.GetBlackboardComponent();
+	if (!blackboard)
+	{
+		return;
+	}
+
+	// Time since the last count rather than this frame's delta, the service doesn't run every frame
+	FCountTimeMemory* memory = reinterpret_cast<FCountTimeMemory*>(NodeMemory);
+	const float worldTime = OwnerComp.GetWorld()->GetTimeSeconds();
+	const float elapsed = worldTime - memory->LastCountTime;
+	memory->LastCountTime = worldTime;
+
+	if (blackboard->GetValueAsBool(_canAttackKey.SelectedKeyName))
+	{
+		return;
+	}
+
+	const float timeSinceLastAttack = blackboard->GetValueAsFloat(_timeSinceLastAttackKey.SelectedKeyName) + elapsed;
+	blackboard->SetValueAsFloat(_timeSinceLastAttackKey.SelectedKeyName, timeSinceLastAttack);
+
+	if (timeSinceLastAttack >= _timeBetweenAttacks)
+	{
+		blackboard->SetValueAsBool(_canAttackKey.SelectedKeyName, true);
+	}
+}
@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTService.h"
+#include "BTService_CountTimeToAttack.generated.h"
+
+/**
+ * Native Service_CountTimeToAttackAgain. Adds up the time since the last attack and allows attacking again once it's long enough.
+ */
+UCLASS(meta = (DisplayName = "Count Time To Attack Again"))
+class RSTEST_API UBTService_CountTimeToAttack : public UBTService
+{
+	GENERATED_BODY()
+
+public:
+	UBTService_CountTimeToAttack();
+
+	//Variables
+protected:
+	UPROPERTY(EditAnywhere, Category = "Attack Timer Data")
+	FBlackboardKeySelector _timeSinceLastAttackKey;
+
+	UPROPERTY(EditAnywhere, Category = "Attack Timer Data")
+	FBlackboardKeySelector _canAttackKey;
+
+	UPROPERTY(EditAnywhere, Category = "Attack Timer Data", meta = (ClampMin = 0))
+	float _timeBetweenAttacks;
+
+private:
+	struct FCountTimeMemory
+	{
+		float LastCountTime;
+	};
+
+	//Functions
+public:
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+
+	virtual uint16 GetInstanceMemorySize() const override { return sizeof(FCountTimeMemory); }
+
+protected:
+	virtual void OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+
+	virtual void TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+};
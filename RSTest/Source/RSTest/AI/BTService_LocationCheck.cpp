@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BTService_LocationCheck.h"
+#include "AIController.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "Systems/VisibilityService.h"
+
+UBTService_LocationCheck::UBTService_LocationCheck()
+{
+	NodeName = TEXT("Location Check");
+	bNotifyBecomeRelevant = true;
+
+	Interval = 0.25f;
+	RandomDeviation = 0.05f;
+
+	_targetLocationKey.SelectedKeyName = TEXT("PlayerLocation");
+	_targetLocationKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTService_LocationCheck, _targetLocationKey));
+
+	_canSeeTargetKey.SelectedKeyName = TEXT("CanSeePlayer");
+	_canSeeTargetKey.AddBoolFilter(this, GET_MEMBER_NAME_CHECKED(UBTService_LocationCheck, _canSeeTargetKey));
+
+	_timeSinceLastSeenKey.SelectedKeyName = TEXT("TimeSinceLastSeenPlayer");
+	_timeSinceLastSeenKey.AddFloatFilter(this, GET_MEMBER_NAME_CHECKED(UBTService_LocationCheck, _timeSinceLastSeenKey));
+
+	_sightDistance = 5000.f;
+	_sightConeHalfAngle = 180.f;
+}
+
+void UBTService_LocationCheck::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	if (UBlackboardData* blackboardAsset = GetBlackboardAsset())
+	{
+		_targetLocationKey.ResolveSelectedKey(*blackboardAsset);
+		_canSeeTargetKey.ResolveSelectedKey(*blackboardAsset);
+		_timeSinceLastSeenKey.ResolveSelectedKey(*blackboardAsset);
+	}
+}
+
+void UBTService_LocationCheck::OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	Super::OnBecomeRelevant(OwnerComp, NodeMemory);
+
+	FLocationCheckMemory* memory = reinterpret_cast<FLocationCheckMemory*>(NodeMemory);
+	memory->LastCheckTime = OwnerComp.GetWorld()->GetTimeSeconds();
+}
+
+void UBTService_LocationCheck::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
+
+	UBlackboardComponent* blackboard = OwnerComp.GetBlackboardComponent();
+	const AAIController* controller = OwnerComp.GetAIOwner();
+	APawn* pawn = controller ? controller->GetPawn() : nullptr;
+	if (!blackboard || !pawn)
+	{
+		return;
+	}
+
+	// Time since the last check rather than this frame's delta, the service doesn't run every frame
+	FLocationCheckMemory* memory = reinterpret_cast<FLocationCheckMemory*>(NodeMemory);
+	const float worldTime = OwnerComp.GetWorld()->GetTimeSeconds();
+	const float elapsed = worldTime - memory->LastCheckTime;
+	memory->LastCheckTime = worldTime;
+
+	// The result can be a few frames old, traces are spread out over frames by the service
+	bool canSee = false;
+	float resultAge = 0.f;
+	if (AVisibilityService* visibilityService = AVisibilityService::Get(pawn))
+	{
+		visibilityService->RequestVisibility(pawn, _sightDistance, _sightConeHalfAngle);
+		visibilityService->GetVisibility(pawn, canSee, resultAge);
+	}
+
+	const APawn* target = UGameplayStatics::GetPlayerPawn(pawn, 0);
+	if (target && canSee)
+	{
+		blackboard->SetValueAsVector(_targetLocationKey.SelectedKeyName, target->GetActorLocation());
+		blackboard->SetValueAsBool(_canSeeTargetKey.SelectedKeyName, true);
+		blackboard->SetValueAsFloat(_timeSinceLastSeenKey.SelectedKeyName, 0.f);
+	}
+	else
+	{
+		blackboard->SetValueAsBool(_canSeeTargetKey.SelectedKeyName, false);
+		blackboard->SetValueAsFloat(_timeSinceLastSeenKey.SelectedKeyName, blackboard->GetValueAsFloat(_timeSinceLastSeenKey.SelectedKeyName) + elapsed);
+	}
+}
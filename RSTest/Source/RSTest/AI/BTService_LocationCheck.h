@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTService.h"
+#include "BTService_LocationCheck.generated.h"
+
+/**
+ * Native Service_LocationCheck. Asks the visibility service whether the pawn can see the player and, while it can,
+ * keeps the target location up to date. Assumes there's only 1 player.
+ */
+UCLASS(meta = (DisplayName = "Location Check"))
+class RSTEST_API UBTService_LocationCheck : public UBTService
+{
+	GENERATED_BODY()
+
+public:
+	UBTService_LocationCheck();
+
+	//Variables
+protected:
+	UPROPERTY(EditAnywhere, Category = "Location Check Data")
+	FBlackboardKeySelector _targetLocationKey;
+
+	UPROPERTY(EditAnywhere, Category = "Location Check Data")
+	FBlackboardKeySelector _canSeeTargetKey;
+
+	UPROPERTY(EditAnywhere, Category = "Location Check Data")
+	FBlackboardKeySelector _timeSinceLastSeenKey;
+
+	UPROPERTY(EditAnywhere, Category = "Location Check Data", meta = (ClampMin = 0))
+	float _sightDistance;
+
+	// Half angle of the view cone, 180 sees all around
+	UPROPERTY(EditAnywhere, Category = "Location Check Data", meta = (ClampMin = 0, ClampMax = 180))
+	float _sightConeHalfAngle;
+
+private:
+	struct FLocationCheckMemory
+	{
+		float LastCheckTime;
+	};
+
+	//Functions
+public:
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+
+	virtual uint16 GetInstanceMemorySize() const override { return sizeof(FLocationCheckMemory); }
+
+protected:
+	virtual void OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+
+	virtual void TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+};
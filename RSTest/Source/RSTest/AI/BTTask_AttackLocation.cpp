@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BTTask_AttackLocation.h"
+#include "AIController.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "Enemies/BaseEnemy.h"
+#include "Systems/AttackTokenDirector.h"
+
+UBTTask_AttackLocation::UBTTask_AttackLocation()
+{
+	NodeName = TEXT("Attack Location");
+
+	_attackLocationKey.SelectedKeyName = TEXT("PlayerLocation");
+	_attackLocationKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_AttackLocation, _attackLocationKey));
+
+	_canAttackKey.SelectedKeyName = TEXT("CanAttack");
+	_canAttackKey.AddBoolFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_AttackLocation, _canAttackKey));
+
+	_timeSinceLastAttackKey.SelectedKeyName = TEXT("TimeSinceLastAttack");
+	_timeSinceLastAttackKey.AddFloatFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_AttackLocation, _timeSinceLastAttackKey));
+}
+
+void UBTTask_AttackLocation::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	if (UBlackboardData* blackboardAsset = GetBlackboardAsset())
+	{
+		_attackLocationKey.ResolveSelectedKey(*blackboardAsset);
+		_canAttackKey.ResolveSelectedKey(*blackboardAsset);
+		_timeSinceLastAttackKey.ResolveSelectedKey(*blackboardAsset);
+	}
+}
+
+EBTNodeResult::Type UBTTask_AttackLocation::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	UBlackboardComponent* blackboard = OwnerComp.GetBlackboardComponent();
+	const AAIController* controller = OwnerComp.GetAIOwner();
+	ABaseEnemy* enemy = controller ? Cast<ABaseEnemy>(controller->GetPawn()) : nullptr;
+	if (!blackboard || !enemy)
+	{
+		return EBTNodeResult::Failed;
+	}
+
+	// The cooldown starts now either way, a dropped attack is just a missed turn
+	const FVector attackLocation = blackboard->GetValueAsVector(_attackLocationKey.SelectedKeyName);
+	if (AAttackTokenDirector* attackDirector = AAttackTokenDirector::Get(enemy))
+	{
+		attackDirector->QueueAttack(enemy, attackLocation);
+	}
+	else
+	{
+		enemy->Attack(attackLocation);
+	}
+
+	blackboard->SetValueAsBool(_canAttackKey.SelectedKeyName, false);
+	blackboard->SetValueAsFloat(_timeSinceLastAttackKey.SelectedKeyName, 0.f);
+
+	return EBTNodeResult::Succeeded;
+}
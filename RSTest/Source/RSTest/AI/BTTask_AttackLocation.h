@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "BTTask_AttackLocation.generated.h"
+
+/**
+ * Native Task_AttackLocation. The pawn queues an attack on the location in the blackboard, then has to wait to attack again.
+ * The attack itself runs once the attack token director grants it, which may be a few frames later or not at all.
+ */
+UCLASS(meta = (DisplayName = "Attack Location"))
+class RSTEST_API UBTTask_AttackLocation : public UBTTaskNode
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_AttackLocation();
+
+	//Variables
+protected:
+	UPROPERTY(EditAnywhere, Category = "Attack Data")
+	FBlackboardKeySelector _attackLocationKey;
+
+	UPROPERTY(EditAnywhere, Category = "Attack Data")
+	FBlackboardKeySelector _canAttackKey;
+
+	UPROPERTY(EditAnywhere, Category = "Attack Data")
+	FBlackboardKeySelector _timeSinceLastAttackKey;
+
+	//Functions
+public:
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+
+protected:
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+};
@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BTTask_RotateToTarget.h"
+#include "AIController.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+
+UBTTask_RotateToTarget::UBTTask_RotateToTarget()
+{
+	NodeName = TEXT("Rotate To Target");
+
+	_targetLocationKey.SelectedKeyName = TEXT("PlayerLocation");
+	_targetLocationKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_RotateToTarget, _targetLocationKey));
+}
+
+void UBTTask_RotateToTarget::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	if (UBlackboardData* blackboardAsset = GetBlackboardAsset())
+	{
+		_targetLocationKey.ResolveSelectedKey(*blackboardAsset);
+	}
+}
+
+EBTNodeResult::Type UBTTask_RotateToTarget::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	const UBlackboardComponent* blackboard = OwnerComp.GetBlackboardComponent();
+	const AAIController* controller = OwnerComp.GetAIOwner();
+	APawn* pawn = controller ? controller->GetPawn() : nullptr;
+	if (!blackboard || !pawn)
+	{
+		return EBTNodeResult::Failed;
+	}
+
+	const FVector toTarget = blackboard->GetValueAsVector(_targetLocationKey.SelectedKeyName) - pawn->GetActorLocation();
+	pawn->SetActorRotation(FRotator(0.f, toTarget.Rotation().Yaw, 0.f));
+
+	return EBTNodeResult::Succeeded;
+}
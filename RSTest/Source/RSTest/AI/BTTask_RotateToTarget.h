@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "BTTask_RotateToTarget.generated.h"
+
+/**
+ * Native Task_RotateToTarget. Turns the pawn to face the target location, yaw only.
+ */
+UCLASS(meta = (DisplayName = "Rotate To Target"))
+class RSTEST_API UBTTask_RotateToTarget : public UBTTaskNode
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_RotateToTarget();
+
+	//Variables
+protected:
+	UPROPERTY(EditAnywhere, Category = "Rotate Data")
+	FBlackboardKeySelector _targetLocationKey;
+
+	//Functions
+public:
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+
+protected:
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+};
@@ -1,8 +1,9 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "LifeSystem.h"
-#include "TimerManager.h"
-#include "Engine.h"
+#include "RSTestStats.h"
+#include "GameFramework/Actor.h"
+#include "Net/UnrealNetwork.h"
 
 ULifeSystem::ULifeSystem()
 {
@@ -10,43 +11,142 @@ ULifeSystem::ULifeSystem()
 
 	_maxHealth = 5;
 	_invulnerabilityWindowSeconds = 0.5f;
+	_replicatedHealth = _maxHealth;
+	_replicatedIsDead = false;
+
+	SetIsReplicated(true);
 }
 
 void ULifeSystem::BeginPlay()
 {
 	Super::BeginPlay();
 
-	_isDead = false;
-	_canTakeDamage = true;
-	_health = _maxHealth;
-	CheckForDeath(); // In case they start at 0 health
+	_healthRegistry = AHealthRegistry::Get(this);
+	if (AHealthRegistry* healthRegistry = GetHealthRegistry())
+	{
+		_healthHandle = healthRegistry->Register(this, _maxHealth, _invulnerabilityWindowSeconds);
+	}
+
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		_replicatedHealth = _maxHealth;
+		_replicatedIsDead = GetIsDead();
+	}
+	else if (_replicatedHealth != _maxHealth || _replicatedIsDead)
+	{
+		// Joined after this took damage, the rep notify ran before there was a registry entry to write to
+		OnRep_ReplicatedHealth();
+	}
 }
 
-void ULifeSystem::OnTakeDamage(float damageAmount)
+void ULifeSystem::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
-	if (!_isDead && _canTakeDamage)
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ULifeSystem, _replicatedHealth);
+	DOREPLIFETIME(ULifeSystem, _replicatedIsDead);
+}
+
+void ULifeSystem::OnRep_ReplicatedHealth()
+{
+	// Goes through the registry so the client's health UI and death listeners hear about it the same way the server's do.
+	// Both properties share this notify, when they arrive together the second call finds nothing left to change
+	if (AHealthRegistry* healthRegistry = GetHealthRegistry())
 	{
-		DecreaseHealth(damageAmount);
-		if (!CheckForDeath())
-		{
-			_canTakeDamage = false;
-			FTimerHandle invulnerableWindowHandle;
-			GetWorld()->GetTimerManager().SetTimer(invulnerableWindowHandle, this, &ULifeSystem::EndInvulnerability, _invulnerabilityWindowSeconds);
-		}
+		healthRegistry->SetReplicatedState(_healthHandle, _replicatedHealth, _replicatedIsDead);
 	}
 }
 
-void ULifeSystem::EndInvulnerability()
+void ULifeSystem::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	_canTakeDamage = true;
+	if (AHealthRegistry* healthRegistry = GetHealthRegistry())
+	{
+		healthRegistry->Unregister(_healthHandle);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+float ULifeSystem::GetHealth() const
+{
+	const AHealthRegistry* healthRegistry = GetHealthRegistry();
+	return healthRegistry ? healthRegistry->GetHealth(_healthHandle) : _maxHealth;
 }
 
-bool ULifeSystem::CheckForDeath()
+void ULifeSystem::SetHealth(float newHealth)
 {
-	if (_health <= 0)
+	if (AHealthRegistry* healthRegistry = GetHealthRegistry())
 	{
-		_isDead = true;
+		healthRegistry->SetHealth(_healthHandle, newHealth);
 	}
-	return _isDead;
 }
 
+void ULifeSystem::IncreaseHealth(float increaseAmount)
+{
+	if (AHealthRegistry* healthRegistry = GetHealthRegistry())
+	{
+		healthRegistry->AddHealth(_healthHandle, increaseAmount);
+	}
+}
+
+void ULifeSystem::DecreaseHealth(float decreaseAmount)
+{
+	if (AHealthRegistry* healthRegistry = GetHealthRegistry())
+	{
+		healthRegistry->AddHealth(_healthHandle, -decreaseAmount);
+	}
+}
+
+void ULifeSystem::ResetHealth()
+{
+	if (AHealthRegistry* healthRegistry = GetHealthRegistry())
+	{
+		healthRegistry->ResetEntry(_healthHandle);
+	}
+}
+
+bool ULifeSystem::GetIsDead() const
+{
+	const AHealthRegistry* healthRegistry = GetHealthRegistry();
+	return healthRegistry && healthRegistry->GetIsDead(_healthHandle);
+}
+
+bool ULifeSystem::GetIsInvulnerable() const
+{
+	const AHealthRegistry* healthRegistry = GetHealthRegistry();
+	return healthRegistry && healthRegistry->GetIsInvulnerable(_healthHandle);
+}
+
+void ULifeSystem::BroadcastHealthChanged(float newHealth, float oldHealth, bool died)
+{
+	AActor* owner = GetOwner();
+	if (owner && owner->Role == ROLE_Authority && owner->GetNetMode() != NM_Standalone)
+	{
+		const bool isDead = GetIsDead();
+		if (_replicatedHealth != newHealth || _replicatedIsDead != isDead)
+		{
+			_replicatedHealth = newHealth;
+			_replicatedIsDead = isDead;
+			owner->ForceNetUpdate();
+		}
+	}
+
+	OnHealthChangedNative.Broadcast(this, newHealth, oldHealth);
+	OnHealthChanged.Broadcast(newHealth, oldHealth);
+
+	if (died)
+	{
+		OnDeathNative.Broadcast(this);
+		OnDeath.Broadcast();
+	}
+}
+
+void ULifeSystem::OnTakeDamage(float damageAmount)
+{
+	RSTEST_SCOPE_COUNTER(TakeDamage);
+
+	if (AHealthRegistry* healthRegistry = GetHealthRegistry())
+	{
+		healthRegistry->ApplyDamage(_healthHandle, damageAmount);
+	}
+}
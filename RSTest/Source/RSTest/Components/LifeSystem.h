@@ -4,9 +4,17 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Systems/HealthRegistry.h"
 #include "LifeSystem.generated.h"
 
+class ULifeSystem;
 
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FLifeSystemHealthChangedNative, ULifeSystem* /*lifeSystem*/, float /*newHealth*/, float /*oldHealth*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FLifeSystemDeathNative, ULifeSystem* /*lifeSystem*/);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FLifeSystemHealthChanged, float, newHealth, float, oldHealth);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FLifeSystemDeath);
+
+// Health itself lives in AHealthRegistry, this component registers on BeginPlay and reads/writes through its handle
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class RSTEST_API ULifeSystem : public UActorComponent
 {
@@ -23,38 +31,70 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "Life System Data")
 	float _invulnerabilityWindowSeconds;
 
+	// Copy of the server's health for clients, only sent when it changes
+	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedHealth)
+	float _replicatedHealth;
+
+	// Sent alongside health, being at 0 health isn't the same as having been killed
+	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedHealth)
+	bool _replicatedIsDead;
+
 private:
-	float _health;
+	TWeakObjectPtr<AHealthRegistry> _healthRegistry;
+	FHealthHandle _healthHandle;
 
-	bool _isDead;
-	bool _canTakeDamage;
+	//Events
+public:
+	// Fired whenever health actually changes, so UI and other listeners don't have to poll
+	FLifeSystemHealthChangedNative OnHealthChangedNative;
+	FLifeSystemDeathNative OnDeathNative;
+
+	UPROPERTY(BlueprintAssignable, Category = "Life System Events")
+	FLifeSystemHealthChanged OnHealthChanged;
+
+	UPROPERTY(BlueprintAssignable, Category = "Life System Events")
+	FLifeSystemDeath OnDeath;
 
 	//GettersAndSetters
 public:
 	UFUNCTION(BlueprintCallable, Category = "Life System GetSet")
-	float GetHealth() const { return _health; }
+	float GetHealth() const;
 	UFUNCTION(BlueprintCallable, Category = "Life System GetSet")
-	void SetHealth(float newHealth) { _health = newHealth; }
+	void SetHealth(float newHealth);
 
 	UFUNCTION(BlueprintCallable, Category = "Life System GetSet")
-	void IncreaseHealth(float increaseAmount) { _health += increaseAmount; if (_health > _maxHealth) { _health = _maxHealth; } };
+	void IncreaseHealth(float increaseAmount);
 	UFUNCTION(BlueprintCallable, Category = "Life System GetSet")
-	void DecreaseHealth(float decreaseAmount) { _health -= decreaseAmount;  if (_health < 0) { _health = 0; } };
+	void DecreaseHealth(float decreaseAmount);
 
 	UFUNCTION(BlueprintCallable, Category = "Life System GetSet")
 	float GetMaxHealth() const { return _maxHealth; }
 
 	UFUNCTION(BlueprintCallable, Category = "Life System GetSet")
-	bool GetIsDead() const { return _isDead; }
+	bool GetIsDead() const;
+
+	UFUNCTION(BlueprintCallable, Category = "Life System GetSet")
+	bool GetIsInvulnerable() const;
+
+	// Full health and alive again, used when a pooled owner is reused
+	UFUNCTION(BlueprintCallable, Category = "Life System GetSet")
+	void ResetHealth();
 
 	UFUNCTION(BlueprintCallable, Category = "Enemy Reactions")
 	virtual void OnTakeDamage(float damageAmount); // TakeDamage is being used by Pawn class
 
+	// Called by the health registry after this component's entry has changed
+	void BroadcastHealthChanged(float newHealth, float oldHealth, bool died);
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 protected:
 	virtual void BeginPlay() override;
 
-	virtual void EndInvulnerability();
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	UFUNCTION()
+	void OnRep_ReplicatedHealth();
 
-	virtual bool CheckForDeath();	
-	
+	AHealthRegistry* GetHealthRegistry() const { return _healthRegistry.Get(); }
 };
@@ -1,25 +1,177 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "BaseEnemy.h"
+#include "AIController.h"
+#include "BrainComponent.h"
 #include "TimerManager.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "GameFramework/CharacterMovementComponent.h"
 #include "Components/LifeSystem.h"
+#include "Systems/AssetPreloader.h"
+#include "Systems/AttackTokenDirector.h"
+#include "Systems/EnemyDirector.h"
+#include "Systems/HitboxHistory.h"
+#include "Systems/TickPolicy.h"
+#include "Systems/VisibilityService.h"
 
 ABaseEnemy::ABaseEnemy()
 {
+	// Nothing native runs per frame, movement and AI tick as their own components
 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 	LifeSystem = CreateDefaultSubobject<ULifeSystem>(TEXT("LifeSystem"));
 	AddOwnedComponent(LifeSystem);
 
 	_movementSpeed = 1.f;
+	_tickInterval = 0.f;
+	_hitboxSlot = INDEX_NONE;
+
+	_isActiveInPool = false;
+	_isAsleep = false;
+	_sleepWhenKilled = false;
 }
 
-void ABaseEnemy::OnAttacked(AActor* attackedBy, float attemptedDamage)
+void ABaseEnemy::BeginPlay()
 {
-	// CAUTION: attackedBy actor is usually destroyed after this call if it's a player projectile
-	LifeSystem->OnTakeDamage(attemptedDamage);
-	if (LifeSystem->GetIsDead())
+	Super::BeginPlay();
+
+	// Pooled enemies are put to sleep straight after this, which takes it back off
+	_liveToken.SetLive(true);
+
+	SetActorTickInterval(_tickInterval);
+	SetActorTickActive(this, GetHasBlueprintTick(this), TEXT("BlueprintTick"));
+
+	// Pooled enemies stay registered while asleep, their collision being off keeps them out of rewound hits
+	if (AHitboxHistory* hitboxHistory = AHitboxHistory::Get(this))
+	{
+		_hitboxSlot = hitboxHistory->Register(this);
+	}
+
+	// Normally done at map start already, this covers enemies spawned from classes that weren't in the manifest
+	if (AAssetPreloader* preloader = AAssetPreloader::Get(this))
+	{
+		preloader->PreloadEnemyClass(GetClass());
+	}
+}
+
+void ABaseEnemy::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	_liveToken.SetLive(false);
+
+	if (AHitboxHistory* hitboxHistory = AHitboxHistory::Get(this))
+	{
+		hitboxHistory->Unregister(_hitboxSlot);
+	}
+
+	if (_ownerDirector.IsValid())
+	{
+		_ownerDirector->ForgetEnemy(this);
+		_ownerDirector = nullptr;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool ABaseEnemy::ActivateFromPool(const FVector& location, const FRotator& rotation)
+{
+	SetActorEnableCollision(true);
+
+	// Same as spawning with AdjustIfPossibleButDontSpawnIfColliding
+	if (!TeleportTo(location, rotation))
+	{
+		SetActorEnableCollision(false);
+		return false;
+	}
+
+	_isActiveInPool = true;
+	_isAsleep = false;
+	_liveToken.SetLive(true);
+
+	// Pooled enemies are dormant while they wait, their channel only comes back when they're used again
+	SetNetDormancy(DORM_Awake);
+
+	SetActorHiddenInGame(false);
+	SetActorTickActive(this, GetHasBlueprintTick(this), TEXT("BlueprintTick"));
+	GetCharacterMovement()->SetDefaultMovementMode();
+
+	LifeSystem->ResetHealth();
+
+	AAIController* aiController = Cast<AAIController>(GetController());
+	if (aiController)
+	{
+		// Nothing from the previous life should carry over, only SelfActor is filled in up front
+		if (UBlackboardComponent* blackboard = aiController->GetBlackboardComponent())
+		{
+			if (const UBlackboardData* blackboardAsset = blackboard->GetBlackboardAsset())
+			{
+				for (int32 keyID = 0; keyID < blackboardAsset->GetNumKeys(); keyID++)
+				{
+					blackboard->ClearValue((FBlackboard::FKey)keyID);
+				}
+			}
+			blackboard->SetValueAsObject(FBlackboard::KeySelf, this);
+		}
+
+		if (aiController->BrainComponent)
+		{
+			aiController->BrainComponent->RestartLogic();
+		}
+	}
+
+	return true;
+}
+
+void ABaseEnemy::DeactivateToPool()
+{
+	_isActiveInPool = false;
+	_isAsleep = true;
+	_liveToken.SetLive(false);
+
+	if (AAIController* aiController = Cast<AAIController>(GetController()))
+	{
+		aiController->StopMovement();
+		if (aiController->BrainComponent)
+		{
+			aiController->BrainComponent->StopLogic(TEXT("Returned to pool"));
+		}
+	}
+
+	if (AVisibilityService* visibilityService = AVisibilityService::Get(this))
+	{
+		visibilityService->RemoveRequest(this);
+	}
+
+	if (AAttackTokenDirector* attackDirector = AAttackTokenDirector::Get(this))
+	{
+		attackDirector->CancelAttack(this);
+	}
+
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickActive(this, false, NAME_None);
+
+	// Sends the hidden state before going quiet
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void ABaseEnemy::OnKilled()
+{
+	// Called by the damage queue once the frame's hits are applied, nothing else refers to us by now
+	if (_ownerDirector.IsValid())
+	{
+		_ownerDirector->ReleaseEnemy(this);
+	}
+	else if (_sleepWhenKilled)
+	{
+		DeactivateToPool();
+	}
+	else
 	{
 		Destroy();
 	}
-}
\ No newline at end of file
+}
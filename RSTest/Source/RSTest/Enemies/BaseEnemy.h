@@ -4,12 +4,15 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "Interfaces/Damageable.h"
+#include "RSTestStats.h"
 #include "BaseEnemy.generated.h"
 
+class AEnemyDirector;
 class ULifeSystem;
 
 UCLASS()
-class RSTEST_API ABaseEnemy : public ACharacter
+class RSTEST_API ABaseEnemy : public ACharacter, public IDamageable
 {
 	GENERATED_BODY()
 	
@@ -26,12 +29,66 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "Enemy Data")
 	float _movementSpeed;
 
+	// Seconds between ticks, 0 ticks every frame. Enemies only tick at all if their blueprint has a Tick event
+	UPROPERTY(EditDefaultsOnly, Category = "Enemy Data", meta = (ClampMin = 0))
+	float _tickInterval;
+
+private:
+	// Column in the hitbox history, for lag compensated hits
+	int32 _hitboxSlot;
+
 	//Functions
-protected:
+public:
+	// Soft references this enemy needs at runtime, streamed in by the asset preloader before it's likely to use them
+	virtual void GatherPreloadAssets(TArray<FSoftObjectPath>& outAssets) const {}
+
 	UFUNCTION(BlueprintCallable, Category = "Enemy Actions")
 	virtual void Attack(const FVector& attackLocation) {};
 
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	//Pooling
+private:
+	TWeakObjectPtr<AEnemyDirector> _ownerDirector;
+
+	bool _isActiveInPool;
+
+	// Put to sleep by DeactivateToPool, pooled or not
+	bool _isAsleep;
+
+	// Set by the arena snapshot on enemies that aren't pooled, so a restore has them to wake back up
+	bool _sleepWhenKilled;
+
+	TRSTestLiveToken<ERSTestGauge::LiveEnemies> _liveToken;
+
 public:
-	virtual void OnAttacked(AActor* attackedBy, float attemptedDamage);
-	
+	void SetOwnerDirector(AEnemyDirector* director) { _ownerDirector = director; }
+
+	bool GetIsActiveInPool() const { return _isActiveInPool; }
+
+	// Owned by an enemy director, which puts it to sleep instead of destroying it
+	bool GetIsPooled() const { return _ownerDirector.IsValid(); }
+
+	bool GetIsAsleep() const { return _isAsleep; }
+
+	// An enemy outside a pool is put to sleep when it's killed instead of being destroyed
+	void SetSleepWhenKilled(bool sleepWhenKilled) { _sleepWhenKilled = sleepWhenKilled; }
+
+	// Places a sleeping enemy and wakes it up with full health and a fresh blackboard, returns false if it couldn't be placed
+	virtual bool ActivateFromPool(const FVector& location, const FRotator& rotation);
+
+	// Hides the enemy and stops its movement and AI until it's activated again
+	virtual void DeactivateToPool();
+
+	//IDamageable
+public:
+	virtual EDamageTeam GetDamageTeam() const override { return EDamageTeam::DT_Enemy; }
+
+	virtual ULifeSystem* GetLifeSystem() const override { return LifeSystem; }
+
+	virtual void OnKilled() override;
+
 };
@@ -1,112 +1,334 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "EEarthChanneler.h"
-#include "ConstructorHelpers.h"
 #include "Runtime/Engine/Classes/Engine/World.h"
 #include "CollisionQueryParams.h"
 #include "Runtime/Engine/Classes/Kismet/KismetMathLibrary.h"
 #include "Powers/EarthSpike.h"
+#include "Runtime/Engine/Classes/Particles/ParticleSystem.h"
 #include "Runtime/Engine/Classes/Particles/ParticleSystemComponent.h"
-#include "Runtime/Engine/Classes/Kismet/GameplayStatics.h"
+#include "RSTestStats.h"
+#include "Systems/ArenaSpatialIndex.h"
+#include "Systems/CombatReplicator.h"
+#include "Systems/EmitterPool.h"
+#include "Systems/EnemyDirector.h"
+#include "Systems/SpikeManager.h"
+#include "Systems/WorldManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogEarthChanneler, Log, All);
 
 AEEarthChanneler::AEEarthChanneler()
 {
-	//EarthSpike.cpp
-	static ConstructorHelpers::FObjectFinder<UClass> earthSpike(TEXT("Class'/Game/Blueprints/Attacks/EarthSpike.EarthSpike_C'"));
-	if (earthSpike.Object)
+	//EarthSpike.cpp - soft so nothing is loaded until the asset preloader streams it in
+	_earthSpike = TSoftClassPtr<AEarthSpike>(FSoftClassPath(TEXT("/Game/Blueprints/Attacks/EarthSpike.EarthSpike_C")));
+	_attackBeamVFX = TSoftObjectPtr<UParticleSystem>(FSoftObjectPath(TEXT("/Game/VFX/EarthSpikeBeam.EarthSpikeBeam")));
+
+	_attackRaycastLength = 5000.0f;
+	_attackTraceDirections = EAttackTraceDirections::ATD_Cardinal4;
+	_attackTraceFloorAndCeiling = false;
+	_useArenaIndexForAnchors = true;
+	_indexedAnchorCheckDistance = 50.f;
+}
+
+void AEEarthChanneler::GatherPreloadAssets(TArray<FSoftObjectPath>& outAssets) const
+{
+	Super::GatherPreloadAssets(outAssets);
+
+	outAssets.Add(_earthSpike.ToSoftObjectPath());
+	outAssets.Add(_attackBeamVFX.ToSoftObjectPath());
+}
+
+void AEEarthChanneler::BeginPlay()
+{
+	Super::BeginPlay();
+
+	BuildAttackTraceDirections();
+	_attackTraceDelegate.BindUObject(this, &AEEarthChanneler::OnAttackTraceDone);
+	_nextAttackId = 0;
+}
+
+void AEEarthChanneler::DeactivateToPool()
+{
+	Super::DeactivateToPool();
+
+	// Traces still in flight find no attack to report back to and are dropped
+	_pendingAttacks.Reset();
+}
+
+void AEEarthChanneler::BuildAttackTraceDirections()
+{
+	_attackTraceDirectionList.Reset();
+
+	// Right, left, forward, back first - the order the attack has always searched in
+	_attackTraceDirectionList.Add(FVector::RightVector);
+	_attackTraceDirectionList.Add(-FVector::RightVector);
+	_attackTraceDirectionList.Add(FVector::ForwardVector);
+	_attackTraceDirectionList.Add(-FVector::ForwardVector);
+
+	int32 horizontalDirectionCount = 4;
+	if (_attackTraceDirections == EAttackTraceDirections::ATD_Compass8)
+	{
+		horizontalDirectionCount = 8;
+	}
+	else if (_attackTraceDirections == EAttackTraceDirections::ATD_Compass16)
 	{
-		_earthSpike = earthSpike.Object;
+		horizontalDirectionCount = 16;
 	}
 
-	static ConstructorHelpers::FObjectFinder<UParticleSystem> beamParticle (TEXT("/Game/VFX/EarthSpikeBeam.EarthSpikeBeam"));
-	if (beamParticle.Succeeded())
+	const float angleStep = 360.f / horizontalDirectionCount;
+	for (int32 i = 0; i < horizontalDirectionCount; i++)
 	{
-		_attackBeamVFX = beamParticle.Object;
+		const float angle = angleStep * i;
+		if (FMath::IsNearlyZero(FMath::Fmod(angle, 90.f)))
+		{
+			continue; // Already added above
+		}
+		_attackTraceDirectionList.Add(FRotator(0.f, angle, 0.f).Vector());
 	}
 
-	_attackRaycastLength = 5000.0f;
+	if (_attackTraceFloorAndCeiling)
+	{
+		_attackTraceDirectionList.Add(FVector::UpVector);
+		_attackTraceDirectionList.Add(-FVector::UpVector);
+	}
 }
 
+// Anchor traces are issued as one async batch, the spike is spawned when they come back next frame so an attack never waits on physics.
+// Directions the arena index can answer skip the trace, and if it answers all of them the spike is spawned straight away
 void AEEarthChanneler::Attack(const FVector& attackLocation)
 {
+	RSTEST_SCOPE_COUNTER(ChannelerAttack);
+
 	Super::Attack(attackLocation);
 
 	UWorld* const world = GetWorld();
-	if (world)
+	if (world && _attackTraceDirectionList.Num() > 0)
 	{
-		FVector* closestSpawnPosition = nullptr;
-		FHitResult hitData(ForceInit);
+		FPendingAttack pendingAttack;
+		pendingAttack.Id = ++_nextAttackId;
+		pendingAttack.AttackLocation = attackLocation;
+		pendingAttack.TracesOutstanding = 0;
+		pendingAttack.HasSpawnPosition = false;
 
-		FCollisionQueryParams traceParams(FName(TEXT("AttackTracer")), false, this);
-
-		for (int i = 1; i <= 4; i++)
+		TArray<FVector, TInlineAllocator<16>> tracedDirections;
+		int32 checkTraceCount = 0;
+		for (const FVector& traceDirection : _attackTraceDirectionList)
 		{
-			FVector traceHitLocation;
-			FVector traceDirection;
-			if (i < 3)
+			bool hasAnchor = false;
+			FVector anchorLocation;
+			if (!FindIndexedAnchor(attackLocation, traceDirection, hasAnchor, anchorLocation, checkTraceCount))
 			{
-				traceDirection = FVector::RightVector;
+				tracedDirections.Add(traceDirection);
 			}
-			else
+			else if (hasAnchor &&
+				(!pendingAttack.HasSpawnPosition ||
+				(pendingAttack.SpawnPosition - attackLocation).SizeSquared() > (anchorLocation - attackLocation).SizeSquared()))
 			{
-				traceDirection = FVector::ForwardVector;
+				pendingAttack.SpawnPosition = anchorLocation;
+				pendingAttack.HasSpawnPosition = true;
 			}
+		}
 
-			if (i % 2 == 0)
-			{
-				traceDirection *= -1;
-			}
+		pendingAttack.TracesOutstanding = tracedDirections.Num();
+
+		// Checks of indexed anchors are traces too, counted with the rest
+		const int32 traceCount = tracedDirections.Num() + checkTraceCount;
+		INC_DWORD_STAT_BY(STAT_ChannelerAnchorTraces, traceCount);
+		FRSTestQueryCounters::ChannelerAnchorTraces += traceCount;
+		if (AEnemyDirector* enemyDirector = AEnemyDirector::Get(this))
+		{
+			enemyDirector->AddAnchorTraces(traceCount);
+		}
+
+		const int32 attackIndex = _pendingAttacks.Add(pendingAttack);
+		if (tracedDirections.Num() == 0)
+		{
+			FinishPendingAttack(attackIndex);
+			return;
+		}
+
+		FCollisionQueryParams traceParams(FName(TEXT("AttackTracer")), false, this);
 
-			world->LineTraceSingleByChannel(
-				hitData, //result
+		for (const FVector& traceDirection : tracedDirections)
+		{
+			world->AsyncLineTraceByChannel(
+				EAsyncTraceType::Single,
 				attackLocation, //start
 				attackLocation + (traceDirection * _attackRaycastLength), //end
 				ECC_Visibility, //collison channel
-				traceParams
+				traceParams,
+				FCollisionResponseParams::DefaultResponseParam,
+				&_attackTraceDelegate,
+				pendingAttack.Id
 			);
+		}
+	}
+}
 
-			if (hitData.GetActor() && 
-				!hitData.GetActor()->IsA(ACharacter::StaticClass()) && 
-				(closestSpawnPosition == nullptr || 
-				(*closestSpawnPosition - attackLocation).Size() > (hitData.Location - attackLocation).Size()))
-			{
-				traceHitLocation = FVector(hitData.Location);
-				closestSpawnPosition = &traceHitLocation;
-			}
+// Returns false when the direction has to be traced
+bool AEEarthChanneler::FindIndexedAnchor(const FVector& attackLocation, const FVector& traceDirection, bool& outHasAnchor, FVector& outAnchorLocation, int32& outTraceCount) const
+{
+	outHasAnchor = false;
+
+	AArenaSpatialIndex* arenaIndex = _useArenaIndexForAnchors ? AArenaSpatialIndex::Get(this) : nullptr;
+	if (!arenaIndex || !arenaIndex->GetIsBuilt())
+	{
+		return false;
+	}
+
+	if (traceDirection.Equals(-FVector::UpVector))
+	{
+		AActor* tile = nullptr;
+		float tileTopZ = 0.f;
+		if (!arenaIndex->GetTileUnder(attackLocation, tile, tileTopZ) || tileTopZ > attackLocation.Z)
+		{
+			return false;
 		}
 
-		if (closestSpawnPosition != nullptr)
+		if (attackLocation.Z - tileTopZ <= _attackRaycastLength)
 		{
-			CreateEarthSpike(*closestSpawnPosition, attackLocation);
+			outHasAnchor = true;
+			outAnchorLocation = FVector(attackLocation.X, attackLocation.Y, tileTopZ);
 		}
 	}
+	else
+	{
+		EArenaDirection arenaDirection;
+		if (!AArenaSpatialIndex::GetArenaDirection(traceDirection, arenaDirection))
+		{
+			return false;
+		}
+
+		AActor* wall = nullptr;
+		if (!arenaIndex->FindNearestWall(attackLocation, arenaDirection, _attackRaycastLength, outHasAnchor, outAnchorLocation, wall))
+		{
+			return false;
+		}
+	}
+
+	// The index only knows the static arena, a spike standing anywhere along the way could be hit first
+	const FVector pathEnd = outHasAnchor ? outAnchorLocation : attackLocation + traceDirection * _attackRaycastLength;
+	const FBox pathBounds = FBox(attackLocation.ComponentMin(pathEnd), attackLocation.ComponentMax(pathEnd)).ExpandBy(_indexedAnchorCheckDistance);
+	const ASpikeManager* spikeManager = GetWorldManager<ASpikeManager>(this, false);
+	if (spikeManager && spikeManager->GetOverlapsSpike(pathBounds))
+	{
+		outHasAnchor = false;
+		return false;
+	}
+
+	if (outHasAnchor)
+	{
+		// The index works from bounds, one short trace across the surface it found makes sure there's really something there
+		FCollisionQueryParams traceParams(FName(TEXT("AttackAnchorCheck")), false, this);
+		FHitResult hitData;
+		outTraceCount++;
+		if (!GetWorld()->LineTraceSingleByChannel(hitData, outAnchorLocation - traceDirection * _indexedAnchorCheckDistance,
+				outAnchorLocation + traceDirection * _indexedAnchorCheckDistance, ECC_Visibility, traceParams) ||
+			hitData.bStartPenetrating ||
+			!hitData.GetActor() ||
+			hitData.GetActor()->IsA(ACharacter::StaticClass()))
+		{
+			outHasAnchor = false;
+			return false;
+		}
+		outAnchorLocation = hitData.Location;
+	}
+	return true;
+}
+
+void AEEarthChanneler::OnAttackTraceDone(const FTraceHandle& traceHandle, FTraceDatum& traceData)
+{
+	const int32 attackIndex = _pendingAttacks.IndexOfByPredicate([&traceData](const FPendingAttack& pendingAttack) { return pendingAttack.Id == traceData.UserData; });
+	if (attackIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	FPendingAttack& pendingAttack = _pendingAttacks[attackIndex];
+	pendingAttack.TracesOutstanding--;
+
+	const FHitResult* hitData = traceData.OutHits.Num() > 0 ? &traceData.OutHits[0] : nullptr;
+	if (hitData && hitData->bBlockingHit &&
+		hitData->GetActor() &&
+		!hitData->GetActor()->IsA(ACharacter::StaticClass()) &&
+		(!pendingAttack.HasSpawnPosition ||
+		(pendingAttack.SpawnPosition - pendingAttack.AttackLocation).SizeSquared() > (hitData->Location - pendingAttack.AttackLocation).SizeSquared()))
+	{
+		pendingAttack.SpawnPosition = hitData->Location;
+		pendingAttack.HasSpawnPosition = true;
+	}
+
+	if (pendingAttack.TracesOutstanding <= 0)
+	{
+		FinishPendingAttack(attackIndex);
+	}
+}
+
+void AEEarthChanneler::FinishPendingAttack(int32 attackIndex)
+{
+	const FPendingAttack finishedAttack = _pendingAttacks[attackIndex];
+	_pendingAttacks.RemoveAtSwap(attackIndex);
+
+	if (finishedAttack.HasSpawnPosition)
+	{
+		CreateEarthSpike(finishedAttack.SpawnPosition, finishedAttack.AttackLocation);
+	}
 }
 
 // This function would ideally be extracted so that the Earth Spike power was easier to be equipped and used by multiple Actors/Characters and enemies could more easily fire any BaseMagicPower.cpp
 void AEEarthChanneler::CreateEarthSpike(const FVector& spawnLocation, const FVector& attackLocation)
 {
+	RSTEST_SCOPE_COUNTER(CreateEarthSpike);
+
+	// Should have been streamed in by the asset preloader, if not take the hitch rather than lose the attack
+	UClass* earthSpikeClass = _earthSpike.Get();
+	if (!earthSpikeClass && !_earthSpike.IsNull())
+	{
+		UE_LOG(LogEarthChanneler, Warning, TEXT("%s wasn't preloaded, loading it synchronously"), *_earthSpike.ToString());
+		earthSpikeClass = _earthSpike.LoadSynchronous();
+	}
+
 	UWorld* const world = GetWorld();
-	if (world && _earthSpike)
+	if (world && earthSpikeClass)
 	{
 		FActorSpawnParameters spawnParams;
 		AEarthSpike* newEarthSpike = world->SpawnActor<AEarthSpike>(
-			_earthSpike,
+			earthSpikeClass,
 			spawnLocation,
-			UKismetMathLibrary::FindLookAtRotation(spawnLocation, attackLocation) + FRotator(-90.f, 0, 0),
+			AEarthSpike::GetSpawnRotation(spawnLocation, attackLocation),
 			spawnParams
 			);
 		newEarthSpike->SetAttackLocation(attackLocation);
 		newEarthSpike->ActivatePowerAfterDelay();
 
-		if (_attackBeamVFX)
+		// Clients get their own copy of the spike, only the server's can hurt anyone
+		if (GetNetMode() != NM_Standalone)
+		{
+			if (ACombatReplicator* combatReplicator = ACombatReplicator::Get(this))
+			{
+				FSpikeSpawnEvent spawnEvent;
+				spawnEvent.SpikeClass = earthSpikeClass;
+				spawnEvent.Location = spawnLocation;
+				spawnEvent.AttackLocation = attackLocation;
+				spawnEvent.SpawnTime = world->GetTimeSeconds();
+				combatReplicator->SendSpikeSpawn(spawnEvent);
+			}
+		}
+
+		// Purely cosmetic, skipped until it has streamed in or when the pool is at its cap for the beam
+		UParticleSystem* attackBeamVFX = _attackBeamVFX.Get();
+		AEmitterPool* emitterPool = attackBeamVFX ? AEmitterPool::Get(this) : nullptr;
+		if (emitterPool)
 		{
-			UParticleSystemComponent* shootBeam = UGameplayStatics::SpawnEmitterAtLocation(
-				GetWorld(),
-				_attackBeamVFX,
+			UParticleSystemComponent* shootBeam = emitterPool->AcquireEmitter(
+				attackBeamVFX,
 				GetActorLocation()
 			);
-			shootBeam->SetBeamSourcePoint(0, GetActorLocation(), 0);
-			shootBeam->SetBeamTargetPoint(0, spawnLocation, 0);
+			if (shootBeam)
+			{
+				shootBeam->SetBeamSourcePoint(0, GetActorLocation(), 0);
+				shootBeam->SetBeamTargetPoint(0, spawnLocation, 0);
+			}
 		}
 
 	}
@@ -4,8 +4,20 @@
 
 #include "CoreMinimal.h"
 #include "Enemies/BaseEnemy.h"
+#include "WorldCollision.h"
 #include "EEarthChanneler.generated.h"
 
+class AEarthSpike;
+class UParticleSystem;
+
+UENUM(BlueprintType)
+enum class EAttackTraceDirections : uint8
+{
+	ATD_Cardinal4 	UMETA(DisplayName = "4 Cardinal"),
+	ATD_Compass8 	UMETA(DisplayName = "8 Compass"),
+	ATD_Compass16 	UMETA(DisplayName = "16 Compass"),
+};
+
 /**
  * 
  */
@@ -17,21 +29,72 @@ class RSTEST_API AEEarthChanneler : public ABaseEnemy
 public:
 	AEEarthChanneler();
 
+	virtual void GatherPreloadAssets(TArray<FSoftObjectPath>& outAssets) const override;
+
+	virtual void Attack(const FVector& attackLocation) override;
+
+	virtual void DeactivateToPool() override;
+
 	//Variables
 protected:
 
 	UPROPERTY(EditDefaultsOnly, Category = "Earth Channeler Attack")
 	float _attackRaycastLength;
 
-	UClass* _earthSpike;
+	// Horizontal directions searched for a surface to grow the spike out of
+	UPROPERTY(EditDefaultsOnly, Category = "Earth Channeler Attack")
+	EAttackTraceDirections _attackTraceDirections;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Earth Channeler Attack")
+	bool _attackTraceFloorAndCeiling;
+
+	// Axis-aligned walls and the floor are looked up in the arena index instead of traced. A direction with a spike near it
+	// is still traced, and every anchor the index finds is checked with one short trace
+	UPROPERTY(EditDefaultsOnly, Category = "Earth Channeler Attack")
+	bool _useArenaIndexForAnchors;
+
+	// How far either side of an indexed anchor its check trace goes, and how close a spike has to be to the path to trace it
+	UPROPERTY(EditDefaultsOnly, Category = "Earth Channeler Attack", meta = (ClampMin = 1))
+	float _indexedAnchorCheckDistance;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Earth Channeler Attack")
+	TSoftClassPtr<AEarthSpike> _earthSpike;
+
+private:
+	// An attack waiting on its anchor traces, which come back the frame after they're issued
+	struct FPendingAttack
+	{
+		uint32 Id;
+		FVector AttackLocation;
+		int32 TracesOutstanding;
+		bool HasSpawnPosition;
+		FVector SpawnPosition;
+	};
+
+	TArray<FVector> _attackTraceDirectionList;
+	TArray<FPendingAttack> _pendingAttacks;
+
+	FTraceDelegate _attackTraceDelegate;
+
+	uint32 _nextAttackId;
 
 	//Functions
 protected:
-	virtual void Attack(const FVector& attackLocation) override;
+	virtual void BeginPlay() override;
+
+	void BuildAttackTraceDirections();
+
+	// outTraceCount goes up by one for each check trace made
+	bool FindIndexedAnchor(const FVector& attackLocation, const FVector& traceDirection, bool& outHasAnchor, FVector& outAnchorLocation, int32& outTraceCount) const;
+
+	void OnAttackTraceDone(const FTraceHandle& traceHandle, FTraceDatum& traceData);
+
+	void FinishPendingAttack(int32 attackIndex);
 
 	void CreateEarthSpike(const FVector& spawnLocation, const FVector& attackLocation);
 
 	//Particles
 protected:
-	UParticleSystem* _attackBeamVFX;
+	UPROPERTY(EditDefaultsOnly, Category = "Earth Channeler Attack")
+	TSoftObjectPtr<UParticleSystem> _attackBeamVFX;
 };
@@ -0,0 +1,502 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ArenaBuilder.h"
+#include "Components/BoxComponent.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Materials/MaterialInterface.h"
+#include "Systems/ArenaSpatialIndex.h"
+#include "Systems/WorldManager.h"
+#if WITH_EDITOR
+#include "ScopedTransaction.h"
+#endif
+
+#define LOCTEXT_NAMESPACE "ArenaBuilder"
+
+DEFINE_LOG_CATEGORY_STATIC(LogArenaBuilder, Log, All);
+
+// Instances can't run a blueprint graph, a tile actor that implements any of these (the FloorTile lifting when something
+// overlaps it) would stop doing it once collapsed
+static bool GetHasBlueprintBehaviour(const AActor* actor)
+{
+	static const FName behaviourEvents[] =
+	{
+		GET_FUNCTION_NAME_CHECKED(AActor, ReceiveBeginPlay),
+		GET_FUNCTION_NAME_CHECKED(AActor, ReceiveTick),
+		GET_FUNCTION_NAME_CHECKED(AActor, ReceiveActorBeginOverlap),
+		GET_FUNCTION_NAME_CHECKED(AActor, ReceiveActorEndOverlap),
+		GET_FUNCTION_NAME_CHECKED(AActor, ReceiveHit),
+		GET_FUNCTION_NAME_CHECKED(AActor, ReceiveAnyDamage),
+	};
+
+	const UClass* actorClass = actor->GetClass();
+	for (const FName& eventName : behaviourEvents)
+	{
+		if (actorClass->IsFunctionImplementedInBlueprint(eventName))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+AArenaBuilder::AArenaBuilder()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+	RootComponent->SetMobility(EComponentMobility::Static);
+
+	_collisionProfile = UCollisionProfile::BlockAll_ProfileName;
+	_mergeCollision = true;
+
+	_generateSize = FIntPoint(50, 50);
+	_generateWallHeight = 3;
+	_generateTileSize = 100.f;
+	_generateFloorType = 0;
+	_generateWallType = 1;
+
+	_collapseFloorClasses.Add(FSoftClassPath(TEXT("/Game/Blueprints/Environment/FloorTile.FloorTile_C")));
+	_collapseWallClasses.Add(FSoftClassPath(TEXT("/Game/Blueprints/Environment/WallSide.WallSide_C")));
+}
+
+void AArenaBuilder::OnConstruction(const FTransform& Transform)
+{
+	Super::OnConstruction(Transform);
+
+	BuildArena();
+}
+
+void AArenaBuilder::ClearBuiltComponents()
+{
+	// Rerunning the construction script destroys these already, this covers building from anywhere else
+	for (UHierarchicalInstancedStaticMeshComponent* component : _instanceComponents)
+	{
+		if (component && !component->IsPendingKill())
+		{
+			component->DestroyComponent();
+		}
+	}
+	for (UBoxComponent* box : _collisionBoxes)
+	{
+		if (box && !box->IsPendingKill())
+		{
+			box->DestroyComponent();
+		}
+	}
+
+	_instanceComponents.Reset();
+	_instanceTiles.Reset();
+	_collisionBoxes.Reset();
+	_tileBounds.Reset();
+	_tileComponents.Reset();
+	_tileInstances.Reset();
+}
+
+void AArenaBuilder::BuildArena()
+{
+	const double buildStartTime = FPlatformTime::Seconds();
+
+	ClearBuiltComponents();
+
+	struct FInstanceGroup
+	{
+		UStaticMesh* Mesh;
+		UMaterialInterface* Material;
+		bool HasCollision;
+		UHierarchicalInstancedStaticMeshComponent* Component;
+	};
+	TArray<FInstanceGroup> groups;
+	TArray<FBox> mergedBoxes;
+
+	const FTransform& actorTransform = GetActorTransform();
+
+	_tileBounds.Reserve(_tiles.Num());
+	_tileComponents.Reserve(_tiles.Num());
+	_tileInstances.Reserve(_tiles.Num());
+
+	for (const FArenaTile& tile : _tiles)
+	{
+		const FArenaTileType* type = _tileTypes.IsValidIndex(tile.Type) ? &_tileTypes[tile.Type] : nullptr;
+		if (!type || !type->Mesh)
+		{
+			// Keeps tile indices lined up with the layout
+			_tileBounds.Add(FBox(ForceInit));
+			_tileComponents.Add(INDEX_NONE);
+			_tileInstances.Add(INDEX_NONE);
+			continue;
+		}
+
+		const FBox localBounds = type->Mesh->GetBounds().GetBox().TransformBy(tile.Transform);
+		_tileBounds.Add(localBounds.TransformBy(actorTransform));
+
+		// Only tiles turned in quarter turns about Z still fill their axis aligned bounds
+		const FRotator rotation = tile.Transform.Rotator();
+		const bool axisAligned = FMath::IsNearlyZero(rotation.Pitch, 0.1f) && FMath::IsNearlyZero(rotation.Roll, 0.1f) &&
+			FMath::IsNearlyZero(FMath::Fmod(FMath::Abs(rotation.Yaw) + 0.1f, 90.f), 0.2f);
+		const bool merged = _mergeCollision && type->MergeCollision && axisAligned;
+		if (merged)
+		{
+			mergedBoxes.Add(localBounds);
+		}
+
+		int32 groupIndex = groups.IndexOfByPredicate([type, merged](const FInstanceGroup& group)
+		{
+			return group.Mesh == type->Mesh && group.Material == type->Material && group.HasCollision == !merged;
+		});
+		if (groupIndex == INDEX_NONE)
+		{
+			FInstanceGroup group;
+			group.Mesh = type->Mesh;
+			group.Material = type->Material;
+			group.HasCollision = !merged;
+
+			group.Component = NewObject<UHierarchicalInstancedStaticMeshComponent>(this, NAME_None, RF_Transactional);
+			group.Component->CreationMethod = EComponentCreationMethod::UserConstructionScript;
+			group.Component->SetupAttachment(RootComponent);
+			group.Component->SetMobility(EComponentMobility::Static);
+			group.Component->SetStaticMesh(type->Mesh);
+			if (type->Material)
+			{
+				group.Component->SetMaterial(0, type->Material);
+			}
+			group.Component->SetCollisionProfileName(group.HasCollision ? _collisionProfile : UCollisionProfile::NoCollision_ProfileName);
+			group.Component->bGenerateOverlapEvents = group.HasCollision; // The wall run triggers need overlaps from whatever collides
+
+			groupIndex = groups.Add(group);
+			_instanceComponents.Add(group.Component);
+			_instanceTiles.AddDefaulted();
+		}
+
+		// Instances are all added before the component is registered so its tree and bodies are only built once
+		const int32 instance = groups[groupIndex].Component->AddInstance(tile.Transform);
+		_tileComponents.Add(groupIndex);
+		_tileInstances.Add(instance);
+
+		TArray<int32>& instanceTiles = _instanceTiles[groupIndex].Tiles;
+		instanceTiles.SetNum(FMath::Max(instanceTiles.Num(), instance + 1));
+		instanceTiles[instance] = _tileBounds.Num() - 1;
+	}
+
+	for (const FInstanceGroup& group : groups)
+	{
+		group.Component->RegisterComponent();
+	}
+
+	MergeBoxesAlongAxis(mergedBoxes, 0);
+	MergeBoxesAlongAxis(mergedBoxes, 1);
+	MergeBoxesAlongAxis(mergedBoxes, 2);
+	for (const FBox& box : mergedBoxes)
+	{
+		CreateCollisionBox(box);
+	}
+
+	UE_LOG(LogArenaBuilder, Log, TEXT("%s built %d tiles into %d instanced meshes and %d collision boxes in %.2f ms"),
+		*GetName(), _tiles.Num(), _instanceComponents.Num(), _collisionBoxes.Num(), (FPlatformTime::Seconds() - buildStartTime) * 1000.0);
+}
+
+void AArenaBuilder::CreateCollisionBox(const FBox& localBox)
+{
+	UBoxComponent* box = NewObject<UBoxComponent>(this, NAME_None, RF_Transactional);
+	box->CreationMethod = EComponentCreationMethod::UserConstructionScript;
+	box->SetupAttachment(RootComponent);
+	box->SetMobility(EComponentMobility::Static);
+	box->SetRelativeLocation(localBox.GetCenter());
+	box->SetBoxExtent(localBox.GetExtent(), false);
+	box->SetCollisionProfileName(_collisionProfile);
+	box->bGenerateOverlapEvents = true;
+	box->SetHiddenInGame(true);
+	box->RegisterComponent();
+
+	_collisionBoxes.Add(box);
+}
+
+void AArenaBuilder::MergeBoxesAlongAxis(TArray<FBox>& boxes, int32 axis)
+{
+	if (boxes.Num() < 2)
+	{
+		return;
+	}
+
+	const int32 acrossA = (axis + 1) % 3;
+	const int32 acrossB = (axis + 2) % 3;
+
+	// Compared on a 0.1 unit grid so float noise in the tile transforms doesn't stop neighbours merging
+	auto quantize = [](float value) { return FMath::RoundToInt(value * 10.f); };
+	auto sameAcross = [&](const FBox& left, const FBox& right)
+	{
+		return quantize(left.Min[acrossA]) == quantize(right.Min[acrossA]) && quantize(left.Max[acrossA]) == quantize(right.Max[acrossA]) &&
+			quantize(left.Min[acrossB]) == quantize(right.Min[acrossB]) && quantize(left.Max[acrossB]) == quantize(right.Max[acrossB]);
+	};
+
+	boxes.Sort([&](const FBox& left, const FBox& right)
+	{
+		const int32 leftKeys[] = { quantize(left.Min[acrossA]), quantize(left.Min[acrossB]), quantize(left.Max[acrossA]), quantize(left.Max[acrossB]), quantize(left.Min[axis]) };
+		const int32 rightKeys[] = { quantize(right.Min[acrossA]), quantize(right.Min[acrossB]), quantize(right.Max[acrossA]), quantize(right.Max[acrossB]), quantize(right.Min[axis]) };
+		for (int32 key = 0; key < ARRAY_COUNT(leftKeys); key++)
+		{
+			if (leftKeys[key] != rightKeys[key])
+			{
+				return leftKeys[key] < rightKeys[key];
+			}
+		}
+		return false;
+	});
+
+	int32 merged = 0;
+	for (int32 i = 1; i < boxes.Num(); i++)
+	{
+		FBox& current = boxes[merged];
+		const FBox& next = boxes[i];
+		if (sameAcross(current, next) && quantize(next.Min[axis]) <= quantize(current.Max[axis]))
+		{
+			current.Max[axis] = FMath::Max(current.Max[axis], next.Max[axis]);
+		}
+		else
+		{
+			boxes[++merged] = next;
+		}
+	}
+	boxes.SetNum(merged + 1);
+}
+
+bool AArenaBuilder::GetTileIsWall(int32 tileIndex) const
+{
+	return _tiles.IsValidIndex(tileIndex) && _tileTypes.IsValidIndex(_tiles[tileIndex].Type) && _tileTypes[_tiles[tileIndex].Type].IsWall;
+}
+
+FTransform AArenaBuilder::GetTileWorldTransform(int32 tileIndex) const
+{
+	return _tiles.IsValidIndex(tileIndex) ? _tiles[tileIndex].Transform * GetActorTransform() : FTransform::Identity;
+}
+
+bool AArenaBuilder::GetTileInstance(int32 tileIndex, UHierarchicalInstancedStaticMeshComponent*& outComponent, int32& outInstance) const
+{
+	outComponent = nullptr;
+	outInstance = INDEX_NONE;
+	if (!_tileComponents.IsValidIndex(tileIndex) || _tileComponents[tileIndex] == INDEX_NONE)
+	{
+		return false;
+	}
+
+	outComponent = _instanceComponents[_tileComponents[tileIndex]];
+	outInstance = _tileInstances[tileIndex];
+	return outComponent != nullptr;
+}
+
+int32 AArenaBuilder::GetTileFromInstance(const UPrimitiveComponent* component, int32 instance) const
+{
+	const int32 componentIndex = _instanceComponents.IndexOfByKey(component);
+	if (componentIndex == INDEX_NONE || !_instanceTiles[componentIndex].Tiles.IsValidIndex(instance))
+	{
+		return INDEX_NONE;
+	}
+	return _instanceTiles[componentIndex].Tiles[instance];
+}
+
+int32 AArenaBuilder::GetTileFromHit(const FHitResult& hit) const
+{
+	if (hit.GetActor() != this)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 tileIndex = GetTileFromInstance(hit.GetComponent(), hit.Item);
+	if (tileIndex != INDEX_NONE)
+	{
+		return tileIndex;
+	}
+
+	// A merged box covers many tiles, the one hit is just behind the impact point
+	return GetTileAt(hit.ImpactPoint - hit.ImpactNormal);
+}
+
+int32 AArenaBuilder::GetTileAt(const FVector& location) const
+{
+	// Hits on the merged boxes come through here every wall run check, the index only looks at the tiles in one cell
+	const AArenaSpatialIndex* arenaIndex = GetWorldManager<AArenaSpatialIndex>(this, false);
+	if (arenaIndex && arenaIndex->GetIsBuilt())
+	{
+		return arenaIndex->GetArenaTileAt(location, this);
+	}
+
+	// In the editor, or before the index has been built
+	for (int32 tileIndex = 0; tileIndex < _tileBounds.Num(); tileIndex++)
+	{
+		if (_tileBounds[tileIndex].IsValid && _tileBounds[tileIndex].IsInsideOrOn(location))
+		{
+			return tileIndex;
+		}
+	}
+	return INDEX_NONE;
+}
+
+int32 AArenaBuilder::FindOrAddTileType(UStaticMesh* mesh, UMaterialInterface* material, bool isWall)
+{
+	// A material that's the mesh's own isn't an override
+	if (material && mesh && mesh->GetMaterial(0) == material)
+	{
+		material = nullptr;
+	}
+
+	int32 typeIndex = _tileTypes.IndexOfByPredicate([mesh, material, isWall](const FArenaTileType& type)
+	{
+		return type.Mesh == mesh && type.Material == material && type.IsWall == isWall;
+	});
+	if (typeIndex == INDEX_NONE)
+	{
+		FArenaTileType type;
+		type.Mesh = mesh;
+		type.Material = material;
+		type.IsWall = isWall;
+		typeIndex = _tileTypes.Add(type);
+	}
+	return typeIndex;
+}
+
+void AArenaBuilder::GenerateRectangularArena()
+{
+	if (!_tileTypes.IsValidIndex(_generateFloorType) || (_generateWallHeight > 0 && !_tileTypes.IsValidIndex(_generateWallType)))
+	{
+		UE_LOG(LogArenaBuilder, Warning, TEXT("%s needs tile types for the floor and walls before it can generate an arena"), *GetName());
+		return;
+	}
+
+	Modify();
+	_tiles.Reset();
+
+	auto addTile = [this](int32 type, int32 x, int32 y, int32 level)
+	{
+		FArenaTile tile;
+		tile.Type = type;
+		tile.Transform.SetLocation(FVector(x, y, level) * _generateTileSize);
+		_tiles.Add(tile);
+	};
+
+	// Floor one tile down so its top is level with the builder
+	for (int32 y = 0; y < _generateSize.Y; y++)
+	{
+		for (int32 x = 0; x < _generateSize.X; x++)
+		{
+			addTile(_generateFloorType, x, y, -1);
+		}
+	}
+
+	for (int32 level = 0; level < _generateWallHeight; level++)
+	{
+		for (int32 x = -1; x <= _generateSize.X; x++)
+		{
+			addTile(_generateWallType, x, -1, level);
+			addTile(_generateWallType, x, _generateSize.Y, level);
+		}
+		for (int32 y = 0; y < _generateSize.Y; y++)
+		{
+			addTile(_generateWallType, -1, y, level);
+			addTile(_generateWallType, _generateSize.X, y, level);
+		}
+	}
+
+#if WITH_EDITOR
+	RerunConstructionScripts();
+#else
+	BuildArena();
+#endif
+}
+
+void AArenaBuilder::CollapsePlacedTiles()
+{
+	UWorld* world = GetWorld();
+	if (!world)
+	{
+		return;
+	}
+
+	TArray<UClass*> floorClasses;
+	for (const FSoftClassPath& classPath : _collapseFloorClasses)
+	{
+		if (UClass* floorClass = classPath.TryLoadClass<AActor>())
+		{
+			floorClasses.Add(floorClass);
+		}
+	}
+
+	TArray<UClass*> wallClasses;
+	for (const FSoftClassPath& classPath : _collapseWallClasses)
+	{
+		if (UClass* wallClass = classPath.TryLoadClass<AActor>())
+		{
+			wallClasses.Add(wallClass);
+		}
+	}
+
+#if WITH_EDITOR
+	// One undo step puts the placed actors back and the layout as it was
+	const FScopedTransaction transaction(LOCTEXT("CollapsePlacedTiles", "Collapse Placed Tiles"));
+#endif
+	Modify();
+
+	const int32 actorsBefore = world->GetActorCount();
+	const FTransform& actorTransform = GetActorTransform();
+	int32 collapsedActors = 0;
+	int32 skippedActors = 0;
+	for (TActorIterator<AActor> it(world); it; ++it)
+	{
+		AActor* actor = *it;
+		const bool isFloor = floorClasses.ContainsByPredicate([actor](UClass* floorClass) { return actor->IsA(floorClass); });
+		const bool isWall = !isFloor && wallClasses.ContainsByPredicate([actor](UClass* wallClass) { return actor->IsA(wallClass); });
+		if (!isFloor && !isWall)
+		{
+			continue;
+		}
+
+		// Left placed, the arena index still picks them up as tiles next to the builder's
+		if (GetHasBlueprintBehaviour(actor))
+		{
+			skippedActors++;
+			continue;
+		}
+
+		TInlineComponentArray<UStaticMeshComponent*> meshComponents(actor);
+		for (UStaticMeshComponent* meshComponent : meshComponents)
+		{
+			if (!meshComponent->GetStaticMesh())
+			{
+				continue;
+			}
+
+			FArenaTile tile;
+			tile.Type = FindOrAddTileType(meshComponent->GetStaticMesh(), meshComponent->GetMaterial(0), isWall);
+			tile.Transform = meshComponent->GetComponentTransform().GetRelativeTransform(actorTransform);
+			_tiles.Add(tile);
+		}
+
+		actor->Modify();
+#if WITH_EDITOR
+		world->EditorDestroyActor(actor, true);
+#else
+		actor->Destroy();
+#endif
+		collapsedActors++;
+	}
+
+	UE_LOG(LogArenaBuilder, Log, TEXT("%s collapsed %d placed tile actors, the layout now has %d tiles and the world %d actors (was %d)"),
+		*GetName(), collapsedActors, _tiles.Num(), world->GetActorCount(), actorsBefore);
+	if (skippedActors > 0)
+	{
+		UE_LOG(LogArenaBuilder, Warning, TEXT("%s left %d placed tile actors alone, their blueprints have gameplay (begin play, tick, overlap, hit or damage events) instances can't run"),
+			*GetName(), skippedActors);
+	}
+
+#if WITH_EDITOR
+	RerunConstructionScripts();
+#else
+	BuildArena();
+#endif
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,190 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "ArenaBuilder.generated.h"
+
+class UBoxComponent;
+class UHierarchicalInstancedStaticMeshComponent;
+class UMaterialInterface;
+class UStaticMesh;
+
+USTRUCT(BlueprintType)
+struct FArenaTileType
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "Arena Builder Data")
+	UStaticMesh* Mesh;
+
+	// Replaces the mesh's first material, leave empty to keep the mesh's own
+	UPROPERTY(EditAnywhere, Category = "Arena Builder Data")
+	UMaterialInterface* Material;
+
+	// Indexed as a wall rather than as floor by the arena index
+	UPROPERTY(EditAnywhere, Category = "Arena Builder Data")
+	bool IsWall;
+
+	// The mesh fills its bounds (a cube), so axis aligned tiles of this type can share merged collision boxes
+	UPROPERTY(EditAnywhere, Category = "Arena Builder Data")
+	bool MergeCollision;
+
+	FArenaTileType() : Mesh(nullptr), Material(nullptr), IsWall(false), MergeCollision(true) {}
+};
+
+USTRUCT(BlueprintType)
+struct FArenaTile
+{
+	GENERATED_BODY()
+
+	// Index into the builder's tile types
+	UPROPERTY(EditAnywhere, Category = "Arena Builder Data")
+	int32 Type;
+
+	// Relative to the builder
+	UPROPERTY(EditAnywhere, Category = "Arena Builder Data")
+	FTransform Transform;
+
+	FArenaTile() : Type(0) {}
+};
+
+// Which tile each instance of one of the builder's instanced meshes is
+USTRUCT()
+struct FArenaInstanceTiles
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<int32> Tiles;
+};
+
+/**
+ * The whole arena as one actor: every tile in the layout becomes an instance in one hierarchical instanced mesh per
+ * mesh and material, and the collision of axis aligned box tiles is merged into as few boxes as cover them. Built by the
+ * construction script and saved with the level, nothing is built at runtime. Tiles keep their identity through their index
+ * in the layout, which hits and instances map back to. The arena index picks the tiles up like it does placed tile actors.
+ * GenerateRectangularArena lays out a floor with walls around it, CollapsePlacedTiles replaces hand placed tile actors that
+ * have no blueprint behaviour of their own.
+ */
+UCLASS()
+class RSTEST_API AArenaBuilder : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AArenaBuilder();
+
+	//Variables
+protected:
+	UPROPERTY(EditAnywhere, Category = "Arena Builder Data")
+	TArray<FArenaTileType> _tileTypes;
+
+	UPROPERTY(EditAnywhere, Category = "Arena Builder Data")
+	TArray<FArenaTile> _tiles;
+
+	// For the merged boxes and for instanced meshes whose tiles can't be merged
+	UPROPERTY(EditAnywhere, Category = "Arena Builder Data")
+	FName _collisionProfile;
+
+	// Off gives every instance its own collision body, like separate tile actors had
+	UPROPERTY(EditAnywhere, Category = "Arena Builder Data")
+	bool _mergeCollision;
+
+	UPROPERTY(EditAnywhere, Category = "Arena Builder Generator", meta = (ClampMin = 1))
+	FIntPoint _generateSize;
+
+	// In tiles
+	UPROPERTY(EditAnywhere, Category = "Arena Builder Generator", meta = (ClampMin = 0))
+	int32 _generateWallHeight;
+
+	UPROPERTY(EditAnywhere, Category = "Arena Builder Generator", meta = (ClampMin = 1))
+	float _generateTileSize;
+
+	UPROPERTY(EditAnywhere, Category = "Arena Builder Generator", meta = (ClampMin = 0))
+	int32 _generateFloorType;
+
+	UPROPERTY(EditAnywhere, Category = "Arena Builder Generator", meta = (ClampMin = 0))
+	int32 _generateWallType;
+
+	UPROPERTY(EditAnywhere, Category = "Arena Builder Collapse")
+	TArray<FSoftClassPath> _collapseFloorClasses;
+
+	UPROPERTY(EditAnywhere, Category = "Arena Builder Collapse")
+	TArray<FSoftClassPath> _collapseWallClasses;
+
+private:
+	UPROPERTY()
+	TArray<UHierarchicalInstancedStaticMeshComponent*> _instanceComponents;
+
+	UPROPERTY()
+	TArray<FArenaInstanceTiles> _instanceTiles;
+
+	UPROPERTY()
+	TArray<UBoxComponent*> _collisionBoxes;
+
+	// Per tile, world space
+	UPROPERTY()
+	TArray<FBox> _tileBounds;
+
+	// Per tile, which instanced mesh and which instance in it
+	UPROPERTY()
+	TArray<int32> _tileComponents;
+
+	UPROPERTY()
+	TArray<int32> _tileInstances;
+
+	//GettersAndSetters
+public:
+	UFUNCTION(BlueprintCallable, Category = "Arena Builder GetSet")
+	int32 GetTileCount() const { return _tileBounds.Num(); }
+
+	UFUNCTION(BlueprintCallable, Category = "Arena Builder GetSet")
+	bool GetTileIsWall(int32 tileIndex) const;
+
+	const FBox& GetTileBounds(int32 tileIndex) const { return _tileBounds[tileIndex]; }
+
+	UFUNCTION(BlueprintCallable, Category = "Arena Builder GetSet")
+	FTransform GetTileWorldTransform(int32 tileIndex) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Arena Builder GetSet")
+	bool GetTileInstance(int32 tileIndex, UHierarchicalInstancedStaticMeshComponent*& outComponent, int32& outInstance) const;
+
+	//Functions
+public:
+	virtual void OnConstruction(const FTransform& Transform) override;
+
+	// INDEX_NONE if the component isn't one of ours
+	UFUNCTION(BlueprintCallable, Category = "Arena Builder")
+	int32 GetTileFromInstance(const UPrimitiveComponent* component, int32 instance) const;
+
+	// Works for hits on the instanced meshes and on the merged collision boxes
+	UFUNCTION(BlueprintCallable, Category = "Arena Builder")
+	int32 GetTileFromHit(const FHitResult& hit) const;
+
+	// Looked up in the arena index's grid once it's built, every tile is checked before that
+	UFUNCTION(BlueprintCallable, Category = "Arena Builder")
+	int32 GetTileAt(const FVector& location) const;
+
+	// Replaces the layout with a _generateSize floor and walls _generateWallHeight tiles high around it
+	UFUNCTION(CallInEditor, Category = "Arena Builder Generator")
+	void GenerateRectangularArena();
+
+	// Adds every placed actor of the collapse classes to the layout and deletes it, as one undoable transaction in the editor.
+	// Actors whose blueprint implements gameplay events (like the FloorTile lifting on overlap) are left placed
+	UFUNCTION(CallInEditor, Category = "Arena Builder Collapse")
+	void CollapsePlacedTiles();
+
+protected:
+	void BuildArena();
+
+	void ClearBuiltComponents();
+
+	int32 FindOrAddTileType(UStaticMesh* mesh, UMaterialInterface* material, bool isWall);
+
+	void CreateCollisionBox(const FBox& localBox);
+
+	// Joins boxes that touch along the axis and have the same extent across it, in a single sorted pass
+	static void MergeBoxesAlongAxis(TArray<FBox>& boxes, int32 axis);
+};
@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "Damageable.generated.h"
+
+class ULifeSystem;
+
+UENUM(BlueprintType)
+enum class EDamageTeam : uint8
+{
+	DT_Player 	UMETA(DisplayName = "Player"),
+	DT_Enemy 	UMETA(DisplayName = "Enemy"),
+};
+
+UINTERFACE(MinimalAPI)
+class UDamageable : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Anything that can be hurt by a projectile or a power. Damage isn't applied directly,
+ * it goes through ADamageQueue which applies a frame's worth of hits in one pass.
+ */
+class RSTEST_API IDamageable
+{
+	GENERATED_BODY()
+
+public:
+	virtual EDamageTeam GetDamageTeam() const = 0;
+
+	virtual ULifeSystem* GetLifeSystem() const = 0;
+
+	// Reaction to a hit, called by the damage queue after the damage has been applied to the life system
+	virtual void OnAttacked(AActor* attackedBy, float attemptedDamage) {};
+
+	// Called once every hit of the frame has been applied, if they left this dead
+	virtual void OnKilled() {};
+};
@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "WallRunTracker.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "RSTestStats.h"
+
+FWallRunTracker::FWallRunTracker()
+	: RetraceDistance(200.f)
+	, _wallPlane(ForceInit)
+	, _wallBounds(ForceInit)
+	, _traceDirection(FVector::ZeroVector)
+	, _traceLength(0.f)
+	, _lastTraceLocation(FVector::ZeroVector)
+	, _isTracking(false)
+	, _traceCount(0)
+{
+}
+
+void FWallRunTracker::Begin(const FHitResult& wallHit, const FVector& traceDirection, float traceLength, const FVector& characterLocation)
+{
+	_traceDirection = traceDirection.GetSafeNormal();
+	_traceLength = traceLength;
+	_traceCount = 0;
+	_isTracking = CacheWall(wallHit, characterLocation);
+}
+
+void FWallRunTracker::End()
+{
+	_isTracking = false;
+	_wallActor.Reset();
+	_wallComponent.Reset();
+}
+
+bool FWallRunTracker::Update(UWorld* world, const FVector& characterLocation, const FCollisionQueryParams& traceParams)
+{
+	if (!_isTracking || !world)
+	{
+		return false;
+	}
+
+	const bool needsRetrace = GetWallHasMoved() ||
+		FVector::DistSquared(characterLocation, _lastTraceLocation) > FMath::Square(RetraceDistance) ||
+		!CheckContactAnalytically(characterLocation);
+
+	if (!needsRetrace)
+	{
+		return true;
+	}
+
+	FHitResult hitData(ForceInit);
+	world->LineTraceSingleByChannel(hitData, characterLocation, characterLocation + (_traceDirection * _traceLength), ECC_Visibility, traceParams);
+	_traceCount++;
+	INC_DWORD_STAT(STAT_WallRunTraces);
+	FRSTestQueryCounters::WallRunTraces++;
+
+	_isTracking = hitData.GetActor() && CacheWall(hitData, characterLocation);
+	return _isTracking;
+}
+
+bool FWallRunTracker::CacheWall(const FHitResult& wallHit, const FVector& characterLocation)
+{
+	UPrimitiveComponent* wallComponent = wallHit.GetComponent();
+	if (!wallComponent)
+	{
+		return false;
+	}
+
+	_wallActor = wallHit.GetActor();
+	_wallComponent = wallComponent;
+	_wallComponentTransform = wallComponent->GetComponentTransform();
+	_wallPlane = FPlane(wallHit.ImpactPoint, wallHit.ImpactNormal);
+	_wallBounds = wallComponent->Bounds.GetBox().ExpandBy(1.f);
+	_lastTraceLocation = characterLocation;
+	return true;
+}
+
+// Same question the trace asks - would a ray from the character along the trace direction meet the wall within trace length -
+// but against the cached plane, limited to the cached wall's bounds
+bool FWallRunTracker::CheckContactAnalytically(const FVector& characterLocation) const
+{
+	const FVector wallNormal(_wallPlane.X, _wallPlane.Y, _wallPlane.Z);
+	const float facing = FVector::DotProduct(_traceDirection, wallNormal);
+	if (facing > -KINDA_SMALL_NUMBER)
+	{
+		return false; // Running away from or parallel to the plane
+	}
+
+	const float distanceAlongTrace = -_wallPlane.PlaneDot(characterLocation) / facing;
+	if (distanceAlongTrace < 0.f || distanceAlongTrace > _traceLength)
+	{
+		return false;
+	}
+
+	return _wallBounds.IsInside(characterLocation + (_traceDirection * distanceAlongTrace));
+}
+
+bool FWallRunTracker::GetWallHasMoved() const
+{
+	const UPrimitiveComponent* wallComponent = _wallComponent.Get();
+	return !wallComponent || wallComponent->IsPendingKill() || !wallComponent->GetComponentTransform().Equals(_wallComponentTransform);
+}
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "CollisionQueryParams.h"
+
+class UWorld;
+class UPrimitiveComponent;
+
+/**
+ * Keeps track of the wall a character is running along without tracing every frame.
+ * The wall's plane and bounds are cached from the entry hit and contact is checked against them analytically.
+ * Physics is only asked again when the character has moved far enough, leaves the cached wall's bounds (next wall piece along)
+ * or the wall itself moves or goes away.
+ */
+class RSTEST_API FWallRunTracker
+{
+public:
+	FWallRunTracker();
+
+	//Variables
+public:
+	// How far the character can move along a wall before the cached plane is refreshed with a trace
+	float RetraceDistance;
+
+private:
+	TWeakObjectPtr<AActor> _wallActor;
+	TWeakObjectPtr<UPrimitiveComponent> _wallComponent;
+	FTransform _wallComponentTransform;
+	FPlane _wallPlane;
+	FBox _wallBounds;
+
+	FVector _traceDirection;
+	float _traceLength;
+	FVector _lastTraceLocation;
+
+	bool _isTracking;
+	int32 _traceCount;
+
+	//GettersAndSetters
+public:
+	bool GetIsTracking() const { return _isTracking; }
+
+	AActor* GetWallActor() const { return _wallActor.Get(); }
+
+	// Traces made since Begin, entry hit not included
+	int32 GetTraceCount() const { return _traceCount; }
+
+	//Functions
+public:
+	// traceDirection is the fixed world direction the wall is looked for in, as far as traceLength from the character
+	void Begin(const FHitResult& wallHit, const FVector& traceDirection, float traceLength, const FVector& characterLocation);
+
+	void End();
+
+	// Returns false once there's no wall left to run on
+	bool Update(UWorld* world, const FVector& characterLocation, const FCollisionQueryParams& traceParams);
+
+private:
+	bool CacheWall(const FHitResult& wallHit, const FVector& characterLocation);
+
+	bool CheckContactAnalytically(const FVector& characterLocation) const;
+
+	bool GetWallHasMoved() const;
+};
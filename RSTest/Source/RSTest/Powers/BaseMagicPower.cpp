@@ -2,13 +2,20 @@
 
 #include "BaseMagicPower.h"
 #include "TimerManager.h"
+#include "Components/PrimitiveComponent.h"
+#include "RSTest.h"
+#include "Systems/TickPolicy.h"
 
 ABaseMagicPower::ABaseMagicPower()
 {
 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 	_damage = 1.f;
 	_attackActivationDelay = 0.0f;
+	_wallRunnableWhenActive = false;
+	_tickInterval = 0.f;
+	_activatedSecondsAgo = 0.f;
 }
 
 void ABaseMagicPower::BeginPlay()
@@ -16,6 +23,9 @@ void ABaseMagicPower::BeginPlay()
 	Super::BeginPlay();
 	
 	_powerHasBeenActivated = false;
+
+	SetActorTickInterval(_tickInterval);
+	UpdatePowerTick();
 }
 
 void ABaseMagicPower::Tick(float DeltaTime)
@@ -33,11 +43,14 @@ void ABaseMagicPower::ActivatePower()
 	PowerBecomeActive();
 }
 
-void ABaseMagicPower::ActivatePowerAfterDelay()
+void ABaseMagicPower::ActivatePowerAfterDelay(float secondsSinceSpawn)
 {
-	if (_attackActivationDelay > 0.f)
+	const float remainingDelay = _attackActivationDelay - secondsSinceSpawn;
+	_activatedSecondsAgo = FMath::Max(-remainingDelay, 0.f);
+
+	if (remainingDelay > 0.f)
 	{
-		GetWorldTimerManager().SetTimer(_powerActivationDelayHandle, this, &ABaseMagicPower::ActivatePower, _attackActivationDelay);
+		GetWorldTimerManager().SetTimer(_powerActivationDelayHandle, this, &ABaseMagicPower::ActivatePower, remainingDelay);
 	}
 	else
 	{
@@ -48,9 +61,33 @@ void ABaseMagicPower::ActivatePowerAfterDelay()
 void ABaseMagicPower::PowerBecomeActive()
 {
 	_powerHasBeenActivated = _powerIsActive = true;
+
+	// Until now it isn't on the channel the wall run triggers overlap, so a spike spawning next to you doesn't count as a new wall
+	UPrimitiveComponent* wallRunSurface = _wallRunnableWhenActive ? GetWallRunSurface() : nullptr;
+	if (wallRunSurface)
+	{
+		wallRunSurface->SetCollisionObjectType(ECC_WallRunnable);
+	}
+
+	UpdatePowerTick();
 }
 
 void ABaseMagicPower::DeactivatePower()
 {
 	_powerIsActive = false;
+
+	UpdatePowerTick();
+}
+
+void ABaseMagicPower::SetPowerIsActive(bool value)
+{
+	_powerIsActive = value;
+
+	UpdatePowerTick();
+}
+
+void ABaseMagicPower::UpdatePowerTick()
+{
+	const bool needsPowerTick = _powerIsActive && GetNeedsPowerTick();
+	SetActorTickActive(this, needsPowerTick || GetHasBlueprintTick(this), needsPowerTick ? TEXT("PowerActive") : TEXT("BlueprintTick"));
 }
\ No newline at end of file
@@ -22,8 +22,19 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "Magic Power Data")
 	float _attackActivationDelay;
 
+	// Once active, the surface from GetWallRunSurface moves to the WallRunnable object channel so players can wall run on it
+	UPROPERTY(EditDefaultsOnly, Category = "Magic Power Data")
+	bool _wallRunnableWhenActive;
+
+	// Seconds between ticks while the power is active, 0 ticks every frame. The power doesn't tick at all while it isn't active
+	UPROPERTY(EditDefaultsOnly, Category = "Magic Power Data", meta = (ClampMin = 0))
+	float _tickInterval;
+
 	FTimerHandle _powerActivationDelayHandle;
 
+	// How long ago the power should have activated, non-zero for powers that were started late (on clients)
+	float _activatedSecondsAgo;
+
 	bool _powerHasBeenActivated;
 	bool _powerIsActive;
 
@@ -36,8 +47,9 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = "Magic Power GetSet")
 	bool GetPowerIsActive() const { return _powerIsActive; }
+	// Goes through UpdatePowerTick so the power's tick follows its activity
 	UFUNCTION(BlueprintCallable, Category = "Magic Power GetSet")
-	void SetPowerIsActive(bool value) { _powerIsActive = value; }
+	void SetPowerIsActive(bool value);
 
 	//Functions
 protected:
@@ -47,12 +59,21 @@ protected:
 
 	virtual void PowerTick(float DeltaTime) {};
 
+	// Whether PowerTick has anything to do while the power is active
+	virtual bool GetNeedsPowerTick() const { return true; }
+
+	// Ticks only while the power is active and needs it (or a blueprint Tick event does)
+	void UpdatePowerTick();
+
+	virtual UPrimitiveComponent* GetWallRunSurface() const { return nullptr; }
+
 	void PowerBecomeActive();
 
 public:
 	virtual void ActivatePower();
 
-	virtual void ActivatePowerAfterDelay();
+	// A power spawned elsewhere (on the server) some time ago skips the part of the delay, and of its activity, it has missed
+	virtual void ActivatePowerAfterDelay(float secondsSinceSpawn = 0.f);
 
 	virtual void DeactivatePower();
 };
@@ -2,8 +2,14 @@
 
 #include "EarthSpike.h"
 #include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
 #include "Runtime/Engine/Classes/Components/BoxComponent.h"
-#include "RSTestCharacter.h"
+#include "GameFramework/Character.h"
+#include "Interfaces/Damageable.h"
+#include "Kismet/KismetMathLibrary.h"
+#include "RSTestStats.h"
+#include "Systems/DamageQueue.h"
+#include "Systems/SpikeManager.h"
 #include "Runtime/Engine/Classes/GameFramework/CharacterMovementComponent.h"
 
 AEarthSpike::AEarthSpike()
@@ -17,6 +23,12 @@ AEarthSpike::AEarthSpike()
 	_attackTrigger->SetCanEverAffectNavigation(false);
 	_attackTrigger->bGenerateOverlapEvents = true;
 
+	_growthCollision = CreateDefaultSubobject<UBoxComponent>(TEXT("GrowthCollision"));
+	_growthCollision->SetupAttachment(RootComponent);
+	_growthCollision->SetCanEverAffectNavigation(false);
+	_growthCollision->SetCollisionProfileName("NoCollision");
+	_growthCollision->bGenerateOverlapEvents = false;
+
 	//This would be better as VFX
 	_visualWarning = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("VisualWarning"));
 	_visualWarning->SetupAttachment(_powerMesh);
@@ -24,10 +36,14 @@ AEarthSpike::AEarthSpike()
 	_visualWarning->bGenerateOverlapEvents = false;
 
 	_attackActivationDelay = 0.5f;
+	_wallRunnableWhenActive = true;
 
 	_interpAttackSpeed = 25.f;
 	_attackPushPower = 2000.f;
 	_attackPushUp = 150.f;
+
+	_retireToInstanceWhenFinished = true;
+	_useAnalyticGrowth = true;
 }
 
 void AEarthSpike::BeginPlay()
@@ -37,6 +53,15 @@ void AEarthSpike::BeginPlay()
 	_attackTrigger->OnComponentBeginOverlap.AddDynamic(this, &AEarthSpike::OnAttackOverlapBegin);
 
 	_baseScale = GetActorScale();
+
+	_liveToken.SetLive(true);
+}
+
+void AEarthSpike::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	_liveToken.SetLive(false);
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AEarthSpike::ActivatePower()
@@ -52,17 +77,64 @@ void AEarthSpike::ActivatePower()
 	}
 
 	Super::ActivatePower();
+
+	if (_useAnalyticGrowth)
+	{
+		ASpikeManager* spikeManager = ASpikeManager::Get(this);
+		if (spikeManager)
+		{
+			// The manager does the hit testing, so the attack trigger's overlaps go. The mesh's collision goes too and the growth
+			// collision blocks the player, projectiles and traces in its place, so growing only ever rescales the mesh's visuals
+			_attackTriggerCollision = _attackTrigger->GetCollisionEnabled();
+			_attackTrigger->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+			_meshCollision = _powerMesh->GetCollisionEnabled();
+			_powerMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+			_growthStartTime = GetWorld()->GetTimeSeconds() - _activatedSecondsAgo;
+			_growthStartScaleZ = GetActorScale().Z;
+			_meshRelativeTransform = _powerMesh->GetRelativeTransform();
+
+			// The actor goes to its full size once, from here on the mesh's relative scale does the growing
+			SetActorScale3D(FVector(_baseScale.X, _baseScale.Y, _scaleToReachTargetRoundedUp));
+			SetupGrowthCollision();
+			UpdateAnalyticGrowth(GetWorld()->GetTimeSeconds());
+
+			spikeManager->RegisterGrowingSpike(this);
+		}
+		else
+		{
+			_useAnalyticGrowth = false;
+			UpdatePowerTick();
+		}
+	}
+}
+
+UPrimitiveComponent* AEarthSpike::GetWallRunSurface() const
+{
+	return _powerMesh;
 }
 
-void AEarthSpike::ActivatePowerAfterDelay()
+void AEarthSpike::ActivatePowerAfterDelay(float secondsSinceSpawn)
 {
 	SetActorScale3D(FVector(_baseScale.X, _baseScale.Y, 0.04f));
 
-	Super::ActivatePowerAfterDelay();
+	Super::ActivatePowerAfterDelay(secondsSinceSpawn);
+}
+
+FRotator AEarthSpike::GetSpawnRotation(const FVector& spawnLocation, const FVector& attackLocation)
+{
+	return UKismetMathLibrary::FindLookAtRotation(spawnLocation, attackLocation) + FRotator(-90.f, 0, 0);
 }
 
 void AEarthSpike::PowerTick(float DeltaTime)
 {
+	RSTEST_SCOPE_COUNTER(SpikePowerTick);
+
+	if (_useAnalyticGrowth)
+	{
+		return; // Driven by the spike manager
+	}
+
 	SetActorScale3D(FVector(_baseScale.X, _baseScale.Y, FMath::FInterpConstantTo(GetActorScale().Z, _scaleToReachTargetRoundedUp, DeltaTime, _interpAttackSpeed)));
 
 	if (FMath::IsNearlyEqual(GetActorScale().Z, _scaleToReachTargetRoundedUp, FLT_EPSILON))
@@ -71,18 +143,192 @@ void AEarthSpike::PowerTick(float DeltaTime)
 	}
 }
 
+bool AEarthSpike::UpdateAnalyticGrowth(float worldTime)
+{
+	// Same curve FInterpConstantTo gives when stepped every tick: constant speed until the target is reached
+	const float scaleZ = FMath::Min(_growthStartScaleZ + (worldTime - _growthStartTime) * _interpAttackSpeed, _scaleToReachTargetRoundedUp);
+	const float growth = scaleZ / _scaleToReachTargetRoundedUp;
+
+	// Neither the mesh nor the attack trigger under it have collision on, so this is only their transforms
+	const FVector meshScale = _meshRelativeTransform.GetScale3D();
+	_powerMesh->SetRelativeScale3D(FVector(meshScale.X, meshScale.Y, meshScale.Z * growth));
+	_growthCollision->SetRelativeLocation(GetGrowthCollisionLocation(growth));
+
+	return scaleZ < _scaleToReachTargetRoundedUp;
+}
+
+void AEarthSpike::FinishAnalyticGrowth()
+{
+	// Back to the mesh's own collision, created once at its full size
+	_powerMesh->SetRelativeScale3D(_meshRelativeTransform.GetScale3D());
+	_growthCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	_powerMesh->SetCollisionEnabled(_meshCollision);
+	_attackTrigger->SetCollisionEnabled(_attackTriggerCollision);
+
+	DeactivatePower();
+}
+
+void AEarthSpike::SetupGrowthCollision()
+{
+	const UStaticMesh* staticMesh = _powerMesh->GetStaticMesh();
+	if (!staticMesh)
+	{
+		return;
+	}
+
+	// In the mesh's space, the growth collision shares its rotation and scale
+	const FBox meshBox = staticMesh->GetBoundingBox();
+	_growthCollision->SetRelativeRotation(_meshRelativeTransform.GetRotation());
+	_growthCollision->SetRelativeScale3D(_meshRelativeTransform.GetScale3D());
+	_growthCollision->SetBoxExtent(meshBox.GetExtent(), false);
+
+	_growthCollision->SetCollisionObjectType(_powerMesh->GetCollisionObjectType());
+	_growthCollision->SetCollisionResponseToChannels(_powerMesh->GetCollisionResponseToChannels());
+	_growthCollision->bGenerateOverlapEvents = _powerMesh->bGenerateOverlapEvents;
+	_growthCollision->SetCollisionEnabled(_meshCollision);
+}
+
+FVector AEarthSpike::GetGrowthCollisionLocation(float growth) const
+{
+	const UStaticMesh* staticMesh = _powerMesh->GetStaticMesh();
+	if (!staticMesh)
+	{
+		return _meshRelativeTransform.GetLocation();
+	}
+
+	// The grown mesh ends at growth * Max.Z, the rest of the box is still inside whatever the spike is growing out of
+	const FBox meshBox = staticMesh->GetBoundingBox();
+	const FVector center = meshBox.GetCenter();
+	const FVector meshSpaceLocation(center.X, center.Y, growth * meshBox.Max.Z - meshBox.GetExtent().Z);
+	return _meshRelativeTransform.TransformPosition(meshSpaceLocation);
+}
+
+/**
+ * Exact squared distance from a segment to an axis aligned box centred on the origin. Along the segment the distance to the box
+ * is a quadratic between the points where the segment crosses one of the box's face planes, each piece is minimised in closed form
+ */
+static float SegmentDistSquaredToBox(const FVector& start, const FVector& end, const FVector& boxExtent)
+{
+	const FVector segment = end - start;
+
+	// At most 2 crossings per axis plus both ends
+	float breaks[8];
+	int32 breakCount = 0;
+	breaks[breakCount++] = 0.f;
+	breaks[breakCount++] = 1.f;
+	for (int32 axis = 0; axis < 3; axis++)
+	{
+		if (FMath::IsNearlyZero(segment[axis]))
+		{
+			continue;
+		}
+		for (const float face : { -boxExtent[axis], boxExtent[axis] })
+		{
+			const float alpha = (face - start[axis]) / segment[axis];
+			if (alpha > 0.f && alpha < 1.f)
+			{
+				breaks[breakCount++] = alpha;
+			}
+		}
+	}
+	Sort(breaks, breakCount);
+
+	float closestDistSquared = MAX_FLT;
+	for (int32 i = 0; i + 1 < breakCount; i++)
+	{
+		const float alphaMin = breaks[i];
+		const float alphaMax = breaks[i + 1];
+
+		// Which side of the box each axis is on holds for the whole piece, the distance is sum((start + segment * alpha - face)^2)
+		// over the axes outside it
+		const FVector midPoint = start + segment * ((alphaMin + alphaMax) * 0.5f);
+		float a = 0.f, b = 0.f, c = 0.f;
+		for (int32 axis = 0; axis < 3; axis++)
+		{
+			float face;
+			if (midPoint[axis] > boxExtent[axis])
+			{
+				face = boxExtent[axis];
+			}
+			else if (midPoint[axis] < -boxExtent[axis])
+			{
+				face = -boxExtent[axis];
+			}
+			else
+			{
+				continue;
+			}
+
+			const float offset = start[axis] - face;
+			a += segment[axis] * segment[axis];
+			b += 2.f * segment[axis] * offset;
+			c += offset * offset;
+		}
+
+		const float alpha = a > 0.f ? FMath::Clamp(-b / (2.f * a), alphaMin, alphaMax) : alphaMin;
+		closestDistSquared = FMath::Min(closestDistSquared, FMath::Max((a * alpha + b) * alpha + c, 0.f));
+	}
+
+	return closestDistSquared;
+}
+
+bool AEarthSpike::TestAnalyticHit(AActor* OtherActor, const FVector& capsuleStart, const FVector& capsuleEnd, float capsuleRadius)
+{
+	if (!_powerIsActive || _hitActors.Contains(OtherActor))
+	{
+		return false;
+	}
+
+	// Work in the attack box's space, where it's an axis aligned box around the origin
+	const FTransform& boxTransform = _attackTrigger->GetComponentTransform();
+	const FVector boxExtent = _attackTrigger->GetScaledBoxExtent();
+	const FVector localStart = boxTransform.GetRotation().UnrotateVector(capsuleStart - boxTransform.GetLocation());
+	const FVector localEnd = boxTransform.GetRotation().UnrotateVector(capsuleEnd - boxTransform.GetLocation());
+
+	// The box only ever grows out from the spike's base, so testing where it's got to covers everywhere it swept through
+	if (SegmentDistSquaredToBox(localStart, localEnd, boxExtent) > FMath::Square(capsuleRadius))
+	{
+		return false;
+	}
+
+	HitActor(OtherActor);
+	return true;
+}
+
+void AEarthSpike::DeactivatePower()
+{
+	Super::DeactivatePower();
+
+	if (_retireToInstanceWhenFinished)
+	{
+		if (ASpikeManager* spikeManager = ASpikeManager::Get(this))
+		{
+			spikeManager->RetireSpike(this);
+		}
+	}
+}
+
 void AEarthSpike::OnAttackOverlapBegin(class UPrimitiveComponent* OverlappedComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
+	RSTEST_SCOPE_COUNTER(SpikeAttackOverlap);
+
 	if (!_powerIsActive)
 	{
 		return;
 	}
 
-	if (OtherActor && OtherActor->IsA(ARSTestCharacter::StaticClass()))
+	HitActor(OtherActor);
+}
+
+void AEarthSpike::HitActor(AActor* OtherActor)
+{
+	IDamageable* damageable = Cast<IDamageable>(OtherActor);
+	if (damageable && damageable->GetDamageTeam() == EDamageTeam::DT_Player)
 	{
-		ARSTestCharacter* player = Cast<ARSTestCharacter>(OtherActor);
+		_hitActors.Add(OtherActor);
+		ADamageQueue::QueueDamage(OtherActor, this, _damage);
 
-		player->OnAttacked(this, _damage);
+		ACharacter* player = Cast<ACharacter>(OtherActor);
 		if (player && _attackTrigger)
 		{
 			FVector pushDirection = OtherActor->GetActorLocation() - GetActorLocation();
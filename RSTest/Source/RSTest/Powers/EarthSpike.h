@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Powers/BaseMagicPower.h"
+#include "RSTestStats.h"
 #include "EarthSpike.generated.h"
 
 /**
@@ -27,6 +28,14 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "Earth Spike Data")
 	float _attackPushUp;
 
+	// Finished spikes are handed to the spike manager and drawn as instances instead of staying around as actors
+	UPROPERTY(EditDefaultsOnly, Category = "Earth Spike Data")
+	bool _retireToInstanceWhenFinished;
+
+	// Grow from a closed-form reach over time with the attack trigger off, the spike manager hit tests every growing spike in one pass
+	UPROPERTY(EditDefaultsOnly, Category = "Earth Spike Data")
+	bool _useAnalyticGrowth;
+
 	const float kPowerSize = 100.f;
 
 	FVector _attackLocation;
@@ -34,6 +43,19 @@ protected:
 
 	float _scaleToReachTargetRoundedUp;
 
+	float _growthStartTime;
+	float _growthStartScaleZ;
+
+	// The mesh's relative transform before it started growing, growth only ever scales it along Z
+	FTransform _meshRelativeTransform;
+
+	ECollisionEnabled::Type _attackTriggerCollision;
+	ECollisionEnabled::Type _meshCollision;
+
+	TArray<TWeakObjectPtr<AActor>> _hitActors;
+
+	TRSTestLiveToken<ERSTestGauge::LiveSpikes> _liveToken;
+
 	//GettersAndSetter
 public:
 	UFUNCTION(BlueprintCallable, Category = "Earth Spike GetSet")
@@ -41,19 +63,49 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Earth Spike GetSet")
 	void SetAttackLocation(FVector location) { _attackLocation = location; }
 
+	class UStaticMeshComponent* GetPowerMesh() const { return _powerMesh; }
+
 	//Functions
 protected:
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	UFUNCTION()
 	void OnAttackOverlapBegin(UPrimitiveComponent* OverlappedComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 
 	virtual void PowerTick(float DeltaTime) override;
 
+	// Growth driven by the spike manager doesn't need the spike's own tick
+	virtual bool GetNeedsPowerTick() const override { return !_useAnalyticGrowth; }
+
+	virtual UPrimitiveComponent* GetWallRunSurface() const override;
+
+	void HitActor(AActor* OtherActor);
+
+	// Sizes the growth collision to the grown mesh and gives it the mesh's collision settings
+	void SetupGrowthCollision();
+
+	// Where the growth collision goes so its end lines up with the tip of a mesh grown to growth (0 to 1) of its full length
+	FVector GetGrowthCollisionLocation(float growth) const;
+
 public:
+	// Analytic growth, driven by the spike manager. Returns false once the spike has reached its full size
+	bool UpdateAnalyticGrowth(float worldTime);
+
+	void FinishAnalyticGrowth();
+
+	// Capsule given as the segment between its hemisphere centres
+	bool TestAnalyticHit(AActor* OtherActor, const FVector& capsuleStart, const FVector& capsuleEnd, float capsuleRadius);
+
 	virtual void ActivatePower() override;
 
-	virtual void ActivatePowerAfterDelay() override;
+	virtual void ActivatePowerAfterDelay(float secondsSinceSpawn = 0.f) override;
+
+	// Spikes point from where they spawn towards what they're attacking
+	static FRotator GetSpawnRotation(const FVector& spawnLocation, const FVector& attackLocation);
+
+	virtual void DeactivatePower() override;
 
 	//Visuals and Colliders
 protected:
@@ -63,6 +115,11 @@ protected:
 	UPROPERTY(VisibleDefaultsOnly, BlueprintReadWrite)
 	class UBoxComponent* _attackTrigger;
 
+	// Stands in for the mesh's collision during analytic growth. It's already full length and slides out of the spike's base,
+	// so only its position changes while the mesh grows instead of a physics body being rescaled every frame
+	UPROPERTY(VisibleDefaultsOnly, BlueprintReadWrite)
+	class UBoxComponent* _growthCollision;
+
 	UPROPERTY(VisibleDefaultsOnly, BlueprintReadWrite)
 	class UStaticMeshComponent* _visualWarning;
 };
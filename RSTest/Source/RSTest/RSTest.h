@@ -3,3 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+
+// Object channels set up in DefaultEngine.ini
+#define ECC_Projectile		ECC_GameTraceChannel1
+#define ECC_WallRunnable	ECC_GameTraceChannel2
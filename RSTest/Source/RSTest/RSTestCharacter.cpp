@@ -14,8 +14,13 @@
 #include "TimerManager.h"
 #include "Runtime/Engine/Classes/GameFramework/CharacterMovementComponent.h"
 #include "Runtime/Engine/Classes/Components/BoxComponent.h"
-#include "Powers/BaseMagicPower.h"
 #include "Components/LifeSystem.h"
+#include "Environment/ArenaBuilder.h"
+#include "Net/UnrealNetwork.h"
+#include "RSTestStats.h"
+#include "Systems/HitboxHistory.h"
+#include "Systems/InputRecorder.h"
+#include "Systems/ProjectilePool.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogFPChar, Warning, All);
 
@@ -85,6 +90,9 @@ ARSTestCharacter::ARSTestCharacter()
 	VR_MuzzleLocation->SetRelativeLocation(FVector(0.000004, 53.999992, 10.000000));
 	VR_MuzzleLocation->SetRelativeRotation(FRotator(0.0f, 90.0f, 0.0f));		// Counteract the rotation of the VR gun model.
 
+	// Projectiles are individual actors unless the batched simulation is turned on
+	bUseBatchedProjectiles = false;
+
 	// Uncomment the following line to turn motion controllers on by default:
 	//bUsingMotionControllers = true;
 
@@ -92,12 +100,12 @@ ARSTestCharacter::ARSTestCharacter()
 
 	_wallRunTriggerLeft = CreateDefaultSubobject<UBoxComponent>(TEXT("WallRunOverlapTriggerLeft"));
 	_wallRunTriggerLeft->SetupAttachment(RootComponent);
-	_wallRunTriggerLeft->SetCollisionProfileName("OverlapAll");
+	_wallRunTriggerLeft->SetCollisionProfileName("WallRunTrigger"); // Only overlaps the WallRunnable channel
 	_wallRunTriggerLeft->bGenerateOverlapEvents = true;
 
 	_wallRunTriggerRight = CreateDefaultSubobject<UBoxComponent>(TEXT("WallRunOverlapTriggerRight"));
 	_wallRunTriggerRight->SetupAttachment(RootComponent);
-	_wallRunTriggerRight->SetCollisionProfileName("OverlapAll");
+	_wallRunTriggerRight->SetCollisionProfileName("WallRunTrigger");
 	_wallRunTriggerRight->bGenerateOverlapEvents = true;
 
 	LifeSystem = CreateDefaultSubobject<ULifeSystem>(TEXT("LifeSystem"));
@@ -115,6 +123,9 @@ ARSTestCharacter::ARSTestCharacter()
 	_wallRunPlayerRollAngleChange = 20.f;
 	_wallRunVelocityAcceptance = 0.f; // 0 allows any velocity to start a wall run
 	_wallRunDistanceAcceptance = 100.f;
+	_wallRunRetraceDistance = 200.f;
+
+	_hitboxSlot = INDEX_NONE;
 }
 
 void ARSTestCharacter::BeginPlay()
@@ -143,16 +154,44 @@ void ARSTestCharacter::BeginPlay()
 	_wallRunTriggerRight->OnComponentBeginOverlap.AddDynamic(this, &ARSTestCharacter::OnOverlapBegin);
 
 	// Wall run variables
-	_previousWallRunActor = nullptr;
-	_wallRunMaintainTrace = FVector();
+	_previousWallRunComponent = nullptr;
+	_previousWallRunTile = INDEX_NONE;
+	_wallRunTracker.RetraceDistance = _wallRunRetraceDistance;
+	_wallRunTracker.End();
+	_pendingWallRunEntries.Reset();
 
 	_isWallRunning = false;
+	_simulatedIsWallRunning = false;
 	_currentWallRunIsOver = false;
 	_jumpCancelsWallRun = false;
 
 	_wallRunLastJumpHeightZ = MAX_FLT; 
 	_characterRotationAlpha = 1.f; // Start at 1 because we don't want this to start straight away (as it plays on Tick is < 1)
 	_gravityOnWallRunStart = GetCharacterMovement()->GravityScale;
+
+	// Spawn the projectiles we'll need up front so firing never has to
+	if (ProjectileClass != NULL && !bUseBatchedProjectiles)
+	{
+		if (AProjectilePool* projectilePool = AProjectilePool::Get(this))
+		{
+			projectilePool->Prewarm(ProjectileClass);
+		}
+	}
+
+	if (AHitboxHistory* hitboxHistory = AHitboxHistory::Get(this))
+	{
+		_hitboxSlot = hitboxHistory->Register(this);
+	}
+}
+
+void ARSTestCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (AHitboxHistory* hitboxHistory = AHitboxHistory::Get(this))
+	{
+		hitboxHistory->Unregister(_hitboxSlot);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -164,11 +203,11 @@ void ARSTestCharacter::SetupPlayerInputComponent(class UInputComponent* PlayerIn
 	check(PlayerInputComponent);
 
 	// Bind jump events
-	PlayerInputComponent->BindAction("Jump", IE_Pressed, this, &ARSTestCharacter::Jump);
-	PlayerInputComponent->BindAction("Jump", IE_Released, this, &ACharacter::StopJumping);
+	PlayerInputComponent->BindAction("Jump", IE_Pressed, this, &ARSTestCharacter::InputJumpPressed);
+	PlayerInputComponent->BindAction("Jump", IE_Released, this, &ARSTestCharacter::InputJumpReleased);
 
 	// Bind fire event
-	PlayerInputComponent->BindAction("Fire", IE_Pressed, this, &ARSTestCharacter::OnFire);
+	PlayerInputComponent->BindAction("Fire", IE_Pressed, this, &ARSTestCharacter::InputFire);
 
 	// Enable touchscreen input
 	EnableTouchscreenMovement(PlayerInputComponent);
@@ -176,20 +215,163 @@ void ARSTestCharacter::SetupPlayerInputComponent(class UInputComponent* PlayerIn
 	PlayerInputComponent->BindAction("ResetVR", IE_Pressed, this, &ARSTestCharacter::OnResetVR);
 
 	// Bind movement events
-	PlayerInputComponent->BindAxis("MoveForward", this, &ARSTestCharacter::MoveForward);
-	PlayerInputComponent->BindAxis("MoveRight", this, &ARSTestCharacter::MoveRight);
+	PlayerInputComponent->BindAxis("MoveForward", this, &ARSTestCharacter::InputMoveForward);
+	PlayerInputComponent->BindAxis("MoveRight", this, &ARSTestCharacter::InputMoveRight);
 
 	// We have 2 versions of the rotation bindings to handle different kinds of devices differently
 	// "turn" handles devices that provide an absolute delta, such as a mouse.
 	// "turnrate" is for devices that we choose to treat as a rate of change, such as an analog joystick
-	PlayerInputComponent->BindAxis("Turn", this, &APawn::AddControllerYawInput);
-	PlayerInputComponent->BindAxis("TurnRate", this, &ARSTestCharacter::TurnAtRate);
-	PlayerInputComponent->BindAxis("LookUp", this, &APawn::AddControllerPitchInput);
-	PlayerInputComponent->BindAxis("LookUpRate", this, &ARSTestCharacter::LookUpAtRate);
+	PlayerInputComponent->BindAxis("Turn", this, &ARSTestCharacter::InputTurn);
+	PlayerInputComponent->BindAxis("TurnRate", this, &ARSTestCharacter::InputTurnRate);
+	PlayerInputComponent->BindAxis("LookUp", this, &ARSTestCharacter::InputLookUp);
+	PlayerInputComponent->BindAxis("LookUpRate", this, &ARSTestCharacter::InputLookUpRate);
+}
+
+void ARSTestCharacter::InputJumpPressed()
+{
+	if (!_inputRecorder.IsValid() || _inputRecorder->FilterAction(this, ERecordedInputAction::JumpPressed))
+	{
+		Jump();
+	}
+}
+
+void ARSTestCharacter::InputJumpReleased()
+{
+	if (!_inputRecorder.IsValid() || _inputRecorder->FilterAction(this, ERecordedInputAction::JumpReleased))
+	{
+		StopJumping();
+	}
+}
+
+void ARSTestCharacter::InputFire()
+{
+	if (!_inputRecorder.IsValid() || _inputRecorder->FilterAction(this, ERecordedInputAction::Fire))
+	{
+		OnFire();
+	}
+}
+
+void ARSTestCharacter::InputMoveForward(float Value)
+{
+	MoveForward(_inputRecorder.IsValid() ? _inputRecorder->FilterAxis(this, ERecordedInputAxis::MoveForward, Value) : Value);
+}
+
+void ARSTestCharacter::InputMoveRight(float Value)
+{
+	MoveRight(_inputRecorder.IsValid() ? _inputRecorder->FilterAxis(this, ERecordedInputAxis::MoveRight, Value) : Value);
+}
+
+void ARSTestCharacter::InputTurn(float Value)
+{
+	AddControllerYawInput(_inputRecorder.IsValid() ? _inputRecorder->FilterAxis(this, ERecordedInputAxis::Turn, Value) : Value);
+}
+
+void ARSTestCharacter::InputTurnRate(float Rate)
+{
+	TurnAtRate(_inputRecorder.IsValid() ? _inputRecorder->FilterAxis(this, ERecordedInputAxis::TurnRate, Rate) : Rate);
+}
+
+void ARSTestCharacter::InputLookUp(float Value)
+{
+	AddControllerPitchInput(_inputRecorder.IsValid() ? _inputRecorder->FilterAxis(this, ERecordedInputAxis::LookUp, Value) : Value);
+}
+
+void ARSTestCharacter::InputLookUpRate(float Rate)
+{
+	LookUpAtRate(_inputRecorder.IsValid() ? _inputRecorder->FilterAxis(this, ERecordedInputAxis::LookUpRate, Rate) : Rate);
+}
+
+void ARSTestCharacter::ApplyRecordedInputAction(ERecordedInputAction action)
+{
+	switch (action)
+	{
+	case ERecordedInputAction::JumpPressed:
+		Jump();
+		break;
+	case ERecordedInputAction::JumpReleased:
+		StopJumping();
+		break;
+	case ERecordedInputAction::Fire:
+		OnFire();
+		break;
+	default:
+		break;
+	}
+}
+
+void ARSTestCharacter::CaptureSnapshot(FRSTestCharacterSnapshot& outSnapshot) const
+{
+	const UCharacterMovementComponent* movement = GetCharacterMovement();
+
+	outSnapshot.Transform = GetActorTransform();
+	outSnapshot.ControlRotation = GetControlRotation();
+	outSnapshot.Velocity = movement->Velocity;
+	outSnapshot.MovementMode = movement->MovementMode;
+	outSnapshot.GravityScale = movement->GravityScale;
+	outSnapshot.JumpCurrentCount = JumpCurrentCount;
+	outSnapshot.Health = LifeSystem->GetHealth();
+
+	outSnapshot.PreviousWallRunComponent = _previousWallRunComponent;
+	outSnapshot.PreviousWallRunTile = _previousWallRunTile;
+	outSnapshot.WallRunTracker = _wallRunTracker;
+	outSnapshot.WallRunRotationAngle = _wallRunRotationAngle;
+	outSnapshot.StartLerpCharacterRotation = _startLerpCharacterRotation;
+	outSnapshot.CanEverWallRun = _canEverWallRun;
+	outSnapshot.IsWallRunning = _isWallRunning;
+	outSnapshot.CurrentWallRunIsOver = _currentWallRunIsOver;
+	outSnapshot.JumpCancelsWallRun = _jumpCancelsWallRun;
+	outSnapshot.WallRunLastJumpHeightZ = _wallRunLastJumpHeightZ;
+	outSnapshot.CharacterRotationAlpha = _characterRotationAlpha;
+	outSnapshot.GravityOnWallRunStart = _gravityOnWallRunStart;
+}
+
+void ARSTestCharacter::RestoreSnapshot(const FRSTestCharacterSnapshot& snapshot)
+{
+	UCharacterMovementComponent* movement = GetCharacterMovement();
+
+	// Nothing from before the restore should carry over into the first frame after it
+	StopJumping();
+	ResetJumpState();
+	_holdingForward = 0.f;
+	_holdingRight = 0.f;
+	_pendingWallRunEntries.Reset();
+
+	SetActorLocationAndRotation(snapshot.Transform.GetLocation(), snapshot.Transform.GetRotation(), false, nullptr, ETeleportType::TeleportPhysics);
+	if (AController* controller = GetController())
+	{
+		controller->SetControlRotation(snapshot.ControlRotation);
+	}
+
+	movement->SetMovementMode(snapshot.MovementMode);
+	movement->Velocity = snapshot.Velocity;
+	movement->GravityScale = snapshot.GravityScale;
+	JumpCurrentCount = snapshot.JumpCurrentCount;
+
+	_previousWallRunComponent = snapshot.PreviousWallRunComponent;
+	_previousWallRunTile = snapshot.PreviousWallRunTile;
+	_wallRunTracker = snapshot.WallRunTracker;
+	_wallRunRotationAngle = snapshot.WallRunRotationAngle;
+	_startLerpCharacterRotation = snapshot.StartLerpCharacterRotation;
+	_canEverWallRun = snapshot.CanEverWallRun;
+	_isWallRunning = _simulatedIsWallRunning = snapshot.IsWallRunning;
+	_currentWallRunIsOver = snapshot.CurrentWallRunIsOver;
+	_jumpCancelsWallRun = snapshot.JumpCancelsWallRun;
+	_wallRunLastJumpHeightZ = snapshot.WallRunLastJumpHeightZ;
+	_characterRotationAlpha = snapshot.CharacterRotationAlpha;
+	_gravityOnWallRunStart = snapshot.GravityOnWallRunStart;
+
+	// Alive again first, setting health alone doesn't bring the dead back
+	LifeSystem->ResetHealth();
+	if (snapshot.Health != LifeSystem->GetHealth())
+	{
+		LifeSystem->SetHealth(snapshot.Health);
+	}
 }
 
 void ARSTestCharacter::OnFire()
 {
+	RSTEST_SCOPE_COUNTER(OnFire);
+
 	// try and fire a projectile
 	if (ProjectileClass != NULL)
 	{
@@ -200,7 +382,7 @@ void ARSTestCharacter::OnFire()
 			{
 				const FRotator SpawnRotation = VR_MuzzleLocation->GetComponentRotation();
 				const FVector SpawnLocation = VR_MuzzleLocation->GetComponentLocation();
-				World->SpawnActor<ARSTestProjectile>(ProjectileClass, SpawnLocation, SpawnRotation);
+				SpawnProjectile(SpawnLocation, SpawnRotation, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
 			}
 			else
 			{
@@ -208,12 +390,8 @@ void ARSTestCharacter::OnFire()
 				// MuzzleOffset is in camera space, so transform it to world space before offsetting from the character location to find the final muzzle position
 				const FVector SpawnLocation = ((FP_MuzzleLocation != nullptr) ? FP_MuzzleLocation->GetComponentLocation() : GetActorLocation()) + SpawnRotation.RotateVector(GunOffset);
 
-				//Set Spawn Collision Handling Override
-				FActorSpawnParameters ActorSpawnParams;
-				ActorSpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding;
-
 				// spawn the projectile at the muzzle
-				World->SpawnActor<ARSTestProjectile>(ProjectileClass, SpawnLocation, SpawnRotation, ActorSpawnParams);
+				SpawnProjectile(SpawnLocation, SpawnRotation, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding);
 			}
 		}
 	}
@@ -236,6 +414,49 @@ void ARSTestCharacter::OnFire()
 	}
 }
 
+void ARSTestCharacter::SpawnProjectile(const FVector& spawnLocation, const FRotator& spawnRotation, ESpawnActorCollisionHandlingMethod collisionHandling)
+{
+	// Fired here straight away so there's no wait on the shot, but only the server's copy can do damage
+	if (Role < ROLE_Authority)
+	{
+		ServerFire(FProjectileSpawnEvent(ProjectileClass, spawnLocation, spawnRotation, bUseBatchedProjectiles, this));
+	}
+
+	const bool batched = ARSTestProjectile::LaunchProjectile(this, ProjectileClass, spawnLocation, spawnRotation, this, bUseBatchedProjectiles, collisionHandling);
+
+	if (Role == ROLE_Authority && GetNetMode() != NM_Standalone)
+	{
+		if (ACombatReplicator* combatReplicator = ACombatReplicator::Get(this))
+		{
+			combatReplicator->SendProjectileSpawn(FProjectileSpawnEvent(ProjectileClass, spawnLocation, spawnRotation, batched, this));
+		}
+	}
+}
+
+bool ARSTestCharacter::ServerFire_Validate(const FProjectileSpawnEvent& spawnEvent)
+{
+	// Shots come from the muzzle, allow for the client being a bit ahead of where the server has it
+	return spawnEvent.ProjectileClass == ProjectileClass && FVector::DistSquared(spawnEvent.Location, GetActorLocation()) <= FMath::Square(1000.f);
+}
+
+void ARSTestCharacter::ServerFire_Implementation(const FProjectileSpawnEvent& spawnEvent)
+{
+	const bool batched = ARSTestProjectile::LaunchProjectile(this, ProjectileClass, spawnEvent.Location, spawnEvent.GetRotation(), this, bUseBatchedProjectiles,
+		ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+
+	if (ACombatReplicator* combatReplicator = ACombatReplicator::Get(this))
+	{
+		combatReplicator->SendProjectileSpawn(FProjectileSpawnEvent(ProjectileClass, spawnEvent.Location, spawnEvent.GetRotation(), batched, this));
+	}
+}
+
+void ARSTestCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_CONDITION(ARSTestCharacter, _simulatedIsWallRunning, COND_SimulatedOnly);
+}
+
 void ARSTestCharacter::OnResetVR()
 {
 	UHeadMountedDisplayFunctionLibrary::ResetOrientationAndPosition();
@@ -361,6 +582,8 @@ void ARSTestCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	ProcessPendingWallRunEntries();
+
 	if (_characterRotationAlpha < 1.f)
 	{
 		RotateCharacterForWallRun(DeltaTime);
@@ -375,6 +598,8 @@ void ARSTestCharacter::Tick(float DeltaTime)
 // Override jumping to allow for redirecting mid-air on second jump to help avoid obstacles
 void ARSTestCharacter::Jump()
 {
+	RSTEST_SCOPE_COUNTER(Jump);
+
 	UCharacterMovementComponent* characterMovement = GetCharacterMovement();
 
 	if (!characterMovement)
@@ -429,42 +654,49 @@ void ARSTestCharacter::Jump()
 	}
 }
 
-void ARSTestCharacter::OnAttacked(AActor* attackedBy, float attemptedDamage)
+void ARSTestCharacter::OnOverlapBegin(class UPrimitiveComponent* OverlappedComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
-	// CAUTION: Projeciles are likely to be destroyed after hitting player (attackedBy)
-	LifeSystem->OnTakeDamage(attemptedDamage);
+	// Other players' characters are moved by replication, whether they're wall running comes from the server
+	if (Role == ROLE_SimulatedProxy)
+	{
+		return;
+	}
+
+	if (OverlappedComp && (OverlappedComp == _wallRunTriggerLeft || OverlappedComp == _wallRunTriggerRight))
+	{
+		FPendingWallRunEntry pendingEntry;
+		pendingEntry.Side = OverlappedComp == _wallRunTriggerLeft ? EWallRunEntrySide::WR_Left : EWallRunEntrySide::WR_Right;
+		pendingEntry.Actor = OtherActor;
+		_pendingWallRunEntries.Add(pendingEntry);
+	}
 }
 
-void ARSTestCharacter::OnOverlapBegin(class UPrimitiveComponent* OverlappedComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void ARSTestCharacter::ProcessPendingWallRunEntries()
 {
-	if (OverlappedComp && (OverlappedComp == _wallRunTriggerLeft || OverlappedComp == _wallRunTriggerRight))
+	for (const FPendingWallRunEntry& pendingEntry : _pendingWallRunEntries)
 	{
-		EWallRunEntrySide wallRunSide = OverlappedComp == _wallRunTriggerLeft ? EWallRunEntrySide::WR_Left : EWallRunEntrySide::WR_Right;
-		CheckWillWallRun(wallRunSide, OverlappedComp->GetComponentTransform().GetLocation(), OtherActor);
+		UBoxComponent* wallRunTrigger = pendingEntry.Side == EWallRunEntrySide::WR_Left ? _wallRunTriggerLeft : _wallRunTriggerRight;
+		if (CheckWillWallRun(pendingEntry.Side, wallRunTrigger->GetComponentLocation(), pendingEntry.Actor.Get()))
+		{
+			break;
+		}
 	}
+	_pendingWallRunEntries.Reset();
 }
 
 bool ARSTestCharacter::CheckWillWallRun(EWallRunEntrySide sideOfActivation, FVector wallRunTriggerLocation, AActor* wallRunOnActor)
 {
+	RSTEST_SCOPE_COUNTER(CheckWillWallRun);
+
+	// The triggers only overlap the WallRunnable channel, so pawns and powers that haven't activated yet never get here
 	if (_isWallRunning ||
 		!GetCharacterMovement()->IsFalling() ||
 		!wallRunOnActor ||
-		wallRunOnActor->IsA(APawn::StaticClass()) ||
 		!CheckVelocityIsAcceptableForWallRunning())
 	{
 		return false;
 	}
 
-	if (wallRunOnActor->IsA(ABaseMagicPower::StaticClass()))
-	{
-		ABaseMagicPower* power = Cast<ABaseMagicPower>(wallRunOnActor);
-		if (!power->GetPowerHasBeenActivated())
-		{
-			// Stops earth spikes from spawning next to you on the wall and counting as a new wall run which provides a new jump
-			return false;
-		}
-	}
-
 	bool result = false;
 
 	FVector directionOfWallRun = FirstPersonCameraComponent->GetRightVector();
@@ -484,15 +716,20 @@ bool ARSTestCharacter::CheckWillWallRun(EWallRunEntrySide sideOfActivation, FVec
 
 		_wallRunRotationAngle = FRotator(0.f, 0.f, -_wallRunPlayerRollAngleChange);
 
-		_wallRunMaintainTrace = directionOfWallRun * _wallRunDistanceAcceptance; // How far can you get from the wall until you're no longer wall running
 		if (sideOfActivation == EWallRunEntrySide::WR_Left)
 		{
 			vectorPerpendicularToWall *= -1;
 			_wallRunRotationAngle *= -1;
 		}
 
+		// An arena builder's walls are all the one actor, which one this is comes from the tile that was hit
+		UPrimitiveComponent* wallRunComponent = hitData.GetComponent();
+		const AArenaBuilder* arenaBuilder = Cast<AArenaBuilder>(hitData.GetActor());
+		const int32 wallRunTile = arenaBuilder ? arenaBuilder->GetTileFromHit(hitData) : INDEX_NONE;
+		const bool isPreviousWall = _previousWallRunComponent.IsValid() && _previousWallRunComponent.Get() == wallRunComponent && _previousWallRunTile == wallRunTile;
+
 		// Make sure that you cannot jump off a wall and then re-enter the same wall at a higher height - stops exploit
-		if (!_currentWallRunIsOver || !_previousWallRunActor || (_previousWallRunActor != wallRunOnActor) || _wallRunLastJumpHeightZ > GetActorLocation().Z)
+		if (!_currentWallRunIsOver || !isPreviousWall || _wallRunLastJumpHeightZ > GetActorLocation().Z)
 		{
 			FVector2D normVelNoZ = FVector2D(GetCharacterMovement()->Velocity.X, GetCharacterMovement()->Velocity.Y).GetSafeNormal();
 			// Get the angle you're travelling compared to the line perpendicular to the wall
@@ -500,7 +737,9 @@ bool ARSTestCharacter::CheckWillWallRun(EWallRunEntrySide sideOfActivation, FVec
 
 			if (wallRunAttemptAngle > _wallRunEnterAngleLowerExclusive && wallRunAttemptAngle < _wallRunEnterAngleHigherExclusive) // A check to make sure you're entering at an accepted angle
 			{
-				_previousWallRunActor = wallRunOnActor;
+				_previousWallRunComponent = wallRunComponent;
+				_previousWallRunTile = wallRunTile;
+				_wallRunTracker.Begin(hitData, directionOfWallRun, _wallRunDistanceAcceptance, GetActorLocation()); // How far can you get from the wall until you're no longer wall running
 				WallRunBegin();
 				result = true;
 			}
@@ -544,7 +783,7 @@ void ARSTestCharacter::WallRunBegin()
 		return;
 	}
 
-	_isWallRunning = true;
+	_isWallRunning = _simulatedIsWallRunning = true;
 	if (JumpCurrentCount >= JumpMaxCount)
 	{
 		JumpCurrentCount--; // You get an extra jump when you enter a wall run so that you can jump off the wall
@@ -555,15 +794,15 @@ void ARSTestCharacter::WallRunBegin()
 	StartRotateCharacterForWallRun(GetController()->GetControlRotation());
 }
 
-// Constantly fire traces in the direction the wall run started until there's nothing to wall run on anymore (allows for spinning around as much as you want!)
+// Keep checking in the direction the wall run started until there's nothing to wall run on anymore (allows for spinning around as much as you want!)
+// The tracker only traces now and then, the rest of the time it checks against the wall it found last
 void ARSTestCharacter::WhileWallRunning()
 {
-	FHitResult hitData(ForceInit);
-	FCollisionQueryParams traceParams(FName(TEXT("WallRunningMaintainTracer")), false, this);
+	RSTEST_SCOPE_COUNTER(WhileWallRunning);
 
-	GetWorld()->LineTraceSingleByChannel(hitData, GetActorLocation(), GetActorLocation() + _wallRunMaintainTrace, ECC_Visibility, traceParams);
+	FCollisionQueryParams traceParams(FName(TEXT("WallRunningMaintainTracer")), false, this);
 
-	if (!hitData.GetActor())
+	if (!_wallRunTracker.Update(GetWorld(), GetActorLocation(), traceParams))
 	{
 		WallRunEnd();
 	}
@@ -571,7 +810,8 @@ void ARSTestCharacter::WhileWallRunning()
 
 void ARSTestCharacter::WallRunEnd()
 {
-	_isWallRunning = _jumpCancelsWallRun = false;
+	_isWallRunning = _simulatedIsWallRunning = _jumpCancelsWallRun = false;
+	_wallRunTracker.End();
 
 	_currentWallRunIsOver = true;
 
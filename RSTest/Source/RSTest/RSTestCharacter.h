@@ -4,6 +4,9 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "Interfaces/Damageable.h"
+#include "Movement/WallRunTracker.h"
+#include "Systems/CombatReplicator.h"
 #include "RSTestCharacter.generated.h"
 
 UENUM(BlueprintType)
@@ -15,9 +18,37 @@ enum class EWallRunEntrySide : uint8
 
 class UInputComponent;
 class ULifeSystem;
+class AInputRecorder;
+enum class ERecordedInputAction : uint8;
+
+/** The player character's gameplay state, captured and put back by the arena snapshot (see AArenaSnapshot) */
+struct FRSTestCharacterSnapshot
+{
+	FTransform Transform;
+	FRotator ControlRotation;
+	FVector Velocity;
+	TEnumAsByte<EMovementMode> MovementMode;
+	float GravityScale;
+	int32 JumpCurrentCount;
+	float Health;
+
+	// Wall running
+	TWeakObjectPtr<UPrimitiveComponent> PreviousWallRunComponent;
+	int32 PreviousWallRunTile;
+	FWallRunTracker WallRunTracker;
+	FRotator WallRunRotationAngle;
+	FRotator StartLerpCharacterRotation;
+	bool CanEverWallRun;
+	bool IsWallRunning;
+	bool CurrentWallRunIsOver;
+	bool JumpCancelsWallRun;
+	float WallRunLastJumpHeightZ;
+	float CharacterRotationAlpha;
+	float GravityOnWallRunStart;
+};
 
 UCLASS(config=Game)
-class ARSTestCharacter : public ACharacter
+class ARSTestCharacter : public ACharacter, public IDamageable
 {
 	GENERATED_BODY()
 
@@ -59,6 +90,8 @@ public:
 protected:
 	virtual void BeginPlay();
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual void Tick(float DeltaTime) override;
 
 public:
@@ -78,6 +111,10 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category=Projectile)
 	TSubclassOf<class ARSTestProjectile> ProjectileClass;
 
+	/** Simulate fired projectiles in the batched projectile manager instead of as individual actors */
+	UPROPERTY(EditDefaultsOnly, Category=Projectile)
+	bool bUseBatchedProjectiles;
+
 	/** Sound to play each time we fire */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Gameplay)
 	class USoundBase* FireSound;
@@ -95,6 +132,13 @@ protected:
 	/** Fires a projectile. */
 	void OnFire();
 
+	/** Takes a projectile from the pool (or spawns one if there's no pool) and launches it. On a client the server is asked to fire the real one. */
+	void SpawnProjectile(const FVector& spawnLocation, const FRotator& spawnRotation, ESpawnActorCollisionHandlingMethod collisionHandling);
+
+	/** Fires the shot a client has already fired for itself, and passes it on to the other clients */
+	UFUNCTION(Server, Unreliable, WithValidation)
+	void ServerFire(const FProjectileSpawnEvent& spawnEvent);
+
 	/** Resets HMD orientation and position in VR. */
 	void OnResetVR();
 
@@ -116,6 +160,22 @@ protected:
 	 */
 	void LookUpAtRate(float Rate);
 
+	/** Bound input goes through these, so the input recorder can record or replace it before it reaches the handlers above */
+	void InputJumpPressed();
+	void InputJumpReleased();
+	void InputFire();
+	void InputMoveForward(float Value);
+	void InputMoveRight(float Value);
+	void InputTurn(float Value);
+	void InputTurnRate(float Rate);
+	void InputLookUp(float Value);
+	void InputLookUpRate(float Rate);
+
+	TWeakObjectPtr<AInputRecorder> _inputRecorder;
+
+	// Column in the hitbox history, for lag compensated hits
+	int32 _hitboxSlot;
+
 	struct TouchData
 	{
 		TouchData() { bIsPressed = false;Location=FVector::ZeroVector;}
@@ -196,14 +256,33 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Wall Run Data")
 	float _wallRunDistanceAcceptance;
 
+	// How far you can run along a wall before it's traced for again, in between contact is checked against the wall found last time
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Wall Run Data", meta = (ClampMin = 0))
+	float _wallRunRetraceDistance;
+
 private:
-	AActor* _previousWallRunActor;
-	FVector _wallRunMaintainTrace;
+	// Overlaps only queue up a wall run check, the trace for it happens in Tick
+	struct FPendingWallRunEntry
+	{
+		EWallRunEntrySide Side;
+		TWeakObjectPtr<AActor> Actor;
+	};
+
+	// The wall last run on, by component and by tile for an arena builder's walls which all share one actor
+	TWeakObjectPtr<UPrimitiveComponent> _previousWallRunComponent;
+	int32 _previousWallRunTile;
+	FWallRunTracker _wallRunTracker;
+	TArray<FPendingWallRunEntry> _pendingWallRunEntries;
 	FRotator _wallRunRotationAngle;
 	FRotator _startLerpCharacterRotation;
 
 	bool _isWallRunning;
 	bool _currentWallRunIsOver;
+
+	// _isWallRunning for other players' copies of this character, which don't run the wall run logic themselves
+	UPROPERTY(Replicated)
+	bool _simulatedIsWallRunning;
+
 	bool _jumpCancelsWallRun;
 
 	float _wallRunLastJumpHeightZ;
@@ -217,11 +296,34 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Player Feature Active GetSet")
 	void SetCanWallRun(bool bSet = true) { _canEverWallRun = bSet; }
 
+	UFUNCTION(BlueprintCallable, Category = "Player Feature Active GetSet")
+	bool GetIsWallRunning() const { return Role == ROLE_SimulatedProxy ? _simulatedIsWallRunning : _isWallRunning; }
+
 	//Functions
 public:
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 	virtual void Jump() override;
 
-	virtual void OnAttacked(AActor* attackedBy, float attemptedDamage);
+	// Same as the bound fire and movement input, for scripted players (benchmarks, bots)
+	void ScriptedFire() { OnFire(); }
+	void ScriptedMove(float forward, float right) { MoveForward(forward); MoveRight(right); }
+
+	// Set by the input recorder while it's recording or replaying this character's input
+	void SetInputRecorder(AInputRecorder* inputRecorder) { _inputRecorder = inputRecorder; }
+
+	// Runs the handler bound to a recorded action, used by the input recorder to replay it
+	void ApplyRecordedInputAction(ERecordedInputAction action);
+
+	void CaptureSnapshot(FRSTestCharacterSnapshot& outSnapshot) const;
+
+	// Puts the character back in place as it was captured, wall run included. Input held and queued wall run checks are dropped
+	void RestoreSnapshot(const FRSTestCharacterSnapshot& snapshot);
+
+	//IDamageable
+	virtual EDamageTeam GetDamageTeam() const override { return EDamageTeam::DT_Player; }
+
+	virtual ULifeSystem* GetLifeSystem() const override { return LifeSystem; }
 
 	UFUNCTION()
 	void OnOverlapBegin(UPrimitiveComponent* OverlappedComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
@@ -233,6 +335,8 @@ protected:
 	virtual void WhileWallRunning();
 	virtual void WallRunEnd();
 
+	void ProcessPendingWallRunEntries();
+
 	bool CheckWillWallRun(EWallRunEntrySide sideOfActivation, FVector wallRunTriggerLocation, AActor* wallRunOnActor);
 
 	bool CheckVelocityIsAcceptableForWallRunning();
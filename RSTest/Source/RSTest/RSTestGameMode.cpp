@@ -3,15 +3,116 @@
 #include "RSTestGameMode.h"
 #include "RSTestHUD.h"
 #include "RSTestCharacter.h"
-#include "UObject/ConstructorHelpers.h"
+#include "RSTestPlayerController.h"
+#include "Systems/ArenaSnapshot.h"
+#include "Systems/ArenaSpatialIndex.h"
+#include "Systems/AssetPreloader.h"
+#include "Systems/BenchmarkRunner.h"
+#include "Systems/InputRecorder.h"
+#include "Systems/NetReporter.h"
+#include "Systems/StatsCsvExport.h"
+#include "Misc/CommandLine.h"
 
 ARSTestGameMode::ARSTestGameMode()
 	: Super()
 {
 	// set default pawn class to our Blueprinted character
-	static ConstructorHelpers::FClassFinder<APawn> PlayerPawnClassFinder(TEXT("/Game/FirstPersonCPP/Blueprints/FirstPersonCharacter"));
-	DefaultPawnClass = PlayerPawnClassFinder.Class;
+	DefaultPawnSoftClass = TSoftClassPtr<APawn>(FSoftClassPath(TEXT("/Game/FirstPersonCPP/Blueprints/FirstPersonCharacter.FirstPersonCharacter_C")));
 
 	// use our custom HUD class
 	HUDClass = ARSTestHUD::StaticClass();
+
+	// carries the combat spawn events to each client
+	PlayerControllerClass = ARSTestPlayerController::StaticClass();
+}
+
+void ARSTestGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	if (AAssetPreloader* preloader = AAssetPreloader::Get(this))
+	{
+		preloader->PreloadGroup(TEXT("PlayerPawn"), { DefaultPawnSoftClass.ToSoftObjectPath() });
+		preloader->PreloadWorldManifest();
+	}
+}
+
+void ARSTestGameMode::StartPlay()
+{
+	// Bake the arena index while the map is loading rather than on the first enemy query
+	AArenaSpatialIndex::Get(this);
+
+	Super::StartPlay();
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("RSStatsCsv")))
+	{
+		StartStatsCsvExport();
+	}
+
+	// Input recording and replay both start with the map so they begin from the same state
+	FString inputReplay;
+	if (FParse::Value(FCommandLine::Get(), TEXT("RSReplayInput="), inputReplay))
+	{
+		if (AInputRecorder* inputRecorder = AInputRecorder::Get(this))
+		{
+			inputRecorder->StartReplay(inputReplay, true);
+		}
+	}
+	else if (FParse::Param(FCommandLine::Get(), TEXT("RSRecordInput")))
+	{
+		FString inputRecording;
+		FParse::Value(FCommandLine::Get(), TEXT("RSRecordInput="), inputRecording);
+		if (AInputRecorder* inputRecorder = AInputRecorder::Get(this))
+		{
+			inputRecorder->StartRecording(inputRecording);
+		}
+	}
+
+	// Network load tests, see Scripts/NetLoopbackTest.sh
+	float netReportSeconds = 0.f;
+	if (FParse::Value(FCommandLine::Get(), TEXT("RSNetReport="), netReportSeconds))
+	{
+		int32 netReportClients = 0;
+		FParse::Value(FCommandLine::Get(), TEXT("RSNetReportClients="), netReportClients);
+		if (ANetReporter* netReporter = ANetReporter::Get(this))
+		{
+			netReporter->StartReport(netReportSeconds, netReportClients, true);
+		}
+	}
+
+	// Restarts restore this instead of reloading the map, it captures once the enemy pools are filled
+	if (AArenaSnapshot* arenaSnapshot = AArenaSnapshot::Get(this))
+	{
+		// Headless restart loops, e.g. -RSSnapshotEpisodes=1000 -RSSnapshotEpisodeSeconds=5
+		int32 snapshotEpisodes = 0;
+		if (FParse::Value(FCommandLine::Get(), TEXT("RSSnapshotEpisodes="), snapshotEpisodes) && snapshotEpisodes > 0)
+		{
+			float snapshotEpisodeSeconds = 5.f;
+			FParse::Value(FCommandLine::Get(), TEXT("RSSnapshotEpisodeSeconds="), snapshotEpisodeSeconds);
+			arenaSnapshot->StartEpisodes(snapshotEpisodes, snapshotEpisodeSeconds, true);
+		}
+	}
+
+	// Headless benchmark runs, the player has been spawned by now
+	FString benchmarkScenario;
+	const bool runBenchmark = FParse::Param(FCommandLine::Get(), TEXT("RSBenchmark"));
+	FParse::Value(FCommandLine::Get(), TEXT("RSBenchmarkScenario="), benchmarkScenario);
+	if (runBenchmark || !benchmarkScenario.IsEmpty())
+	{
+		if (ABenchmarkRunner* benchmarkRunner = ABenchmarkRunner::Get(this))
+		{
+			benchmarkRunner->StartBenchmarks(benchmarkScenario, true);
+		}
+	}
+}
+
+UClass* ARSTestGameMode::GetDefaultPawnClassForController_Implementation(AController* InController)
+{
+	if (DefaultPawnSoftClass.IsNull())
+	{
+		return Super::GetDefaultPawnClassForController_Implementation(InController);
+	}
+
+	// The first player can log in before the pawn has finished streaming, LoadSynchronous just waits on that request
+	return DefaultPawnSoftClass.LoadSynchronous();
 }
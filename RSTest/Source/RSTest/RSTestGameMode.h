@@ -13,6 +13,17 @@ class ARSTestGameMode : public AGameModeBase
 
 public:
 	ARSTestGameMode();
+
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
+	virtual void StartPlay() override;
+
+	virtual UClass* GetDefaultPawnClassForController_Implementation(AController* InController) override;
+
+protected:
+	/** Soft so the pawn blueprint is only loaded by maps that use this game mode, streamed in from InitGame */
+	UPROPERTY(EditDefaultsOnly, Category = Classes)
+	TSoftClassPtr<APawn> DefaultPawnSoftClass;
 };
 
 
@@ -4,32 +4,96 @@
 #include "Engine/Canvas.h"
 #include "Engine/Texture2D.h"
 #include "TextureResource.h"
-#include "CanvasItem.h"
-#include "UObject/ConstructorHelpers.h"
+#include "GameFramework/Pawn.h"
+#include "Components/LifeSystem.h"
+#include "Interfaces/Damageable.h"
+#include "Systems/AssetPreloader.h"
+#include "UI/PlayerHealthWidget.h"
 
 ARSTestHUD::ARSTestHUD()
 {
 	// Set the crosshair texture
-	static ConstructorHelpers::FObjectFinder<UTexture2D> CrosshairTexObj(TEXT("/Game/FirstPerson/Textures/FirstPersonCrosshair"));
-	CrosshairTex = CrosshairTexObj.Object;
+	CrosshairTex = TSoftObjectPtr<UTexture2D>(FSoftObjectPath(TEXT("/Game/FirstPerson/Textures/FirstPersonCrosshair.FirstPersonCrosshair")));
+
+	PlayerWidgetClass = TSoftClassPtr<UPlayerHealthWidget>(FSoftClassPath(TEXT("/Game/UserInterface/PlayerWidget.PlayerWidget_C")));
+
+	CrosshairCanvasSize = FVector2D::ZeroVector;
+	PlayerWidget = nullptr;
 }
 
+void ARSTestHUD::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (AAssetPreloader* preloader = AAssetPreloader::Get(this))
+	{
+		preloader->PreloadGroup(TEXT("HUD"), { CrosshairTex.ToSoftObjectPath(), PlayerWidgetClass.ToSoftObjectPath() },
+			FStreamableDelegate::CreateUObject(this, &ARSTestHUD::OnHUDAssetsLoaded));
+	}
+}
+
+void ARSTestHUD::OnHUDAssetsLoaded()
+{
+	UClass* widgetClass = PlayerWidgetClass.Get();
+	if (!widgetClass || PlayerWidget)
+	{
+		return;
+	}
+
+	PlayerWidget = CreateWidget<UPlayerHealthWidget>(GetOwningPlayerController(), widgetClass);
+	if (PlayerWidget)
+	{
+		PlayerWidget->AddToViewport();
+		UpdatePlayerWidgetPawn();
+	}
+}
+
+void ARSTestHUD::UpdatePlayerWidgetPawn()
+{
+	APawn* pawn = GetOwningPawn();
+	if (!PlayerWidget || pawn == PlayerWidgetPawn.Get())
+	{
+		return;
+	}
+
+	PlayerWidgetPawn = pawn;
+
+	const IDamageable* damageable = Cast<IDamageable>(pawn);
+	PlayerWidget->SetLifeSystem(damageable ? damageable->GetLifeSystem() : nullptr);
+}
 
 void ARSTestHUD::DrawHUD()
 {
 	Super::DrawHUD();
 
-	// Draw very simple crosshair
+	// Only does anything on the frame the player gets a new pawn, the widget updates itself from health events
+	UpdatePlayerWidgetPawn();
+
+	if (!CrosshairItem.IsValid())
+	{
+		// Nothing to draw until the crosshair has streamed in
+		UTexture2D* Crosshair = CrosshairTex.Get();
+		if (!Crosshair)
+		{
+			return;
+		}
+
+		CrosshairItem = MakeUnique<FCanvasTileItem>(FVector2D::ZeroVector, Crosshair->Resource, FLinearColor::White);
+		CrosshairItem->BlendMode = SE_BLEND_Translucent;
+	}
+
+	const FVector2D CanvasSize(Canvas->ClipX, Canvas->ClipY);
+	if (CanvasSize != CrosshairCanvasSize)
+	{
+		CrosshairCanvasSize = CanvasSize;
 
-	// find center of the Canvas
-	const FVector2D Center(Canvas->ClipX * 0.5f, Canvas->ClipY * 0.5f);
+		// find center of the Canvas
+		const FVector2D Center(Canvas->ClipX * 0.5f, Canvas->ClipY * 0.5f);
 
-	// offset by half the texture's dimensions so that the center of the texture aligns with the center of the Canvas
-	const FVector2D CrosshairDrawPosition( (Center.X),
-										   (Center.Y + 20.0f));
+		// offset by half the texture's dimensions so that the center of the texture aligns with the center of the Canvas
+		CrosshairItem->Position = FVector2D(Center.X, Center.Y + 20.0f);
+	}
 
 	// draw the crosshair
-	FCanvasTileItem TileItem( CrosshairDrawPosition, CrosshairTex->Resource, FLinearColor::White);
-	TileItem.BlendMode = SE_BLEND_Translucent;
-	Canvas->DrawItem( TileItem );
+	Canvas->DrawItem(*CrosshairItem);
 }
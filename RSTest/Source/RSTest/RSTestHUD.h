@@ -4,8 +4,11 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/HUD.h"
+#include "CanvasItem.h"
 #include "RSTestHUD.generated.h"
 
+class UPlayerHealthWidget;
+
 UCLASS()
 class ARSTestHUD : public AHUD
 {
@@ -17,9 +20,31 @@ public:
 	/** Primary draw call for the HUD */
 	virtual void DrawHUD() override;
 
+protected:
+	/** Starts streaming the crosshair and player widget in */
+	virtual void BeginPlay() override;
+
+	/** Widget showing the player's health, it updates itself from the life system's events */
+	UPROPERTY(EditDefaultsOnly, Category = HUD)
+	TSoftClassPtr<UPlayerHealthWidget> PlayerWidgetClass;
+
 private:
-	/** Crosshair asset pointer */
-	class UTexture2D* CrosshairTex;
+	/** Crosshair asset, soft so the HUD's default object doesn't load it */
+	TSoftObjectPtr<class UTexture2D> CrosshairTex;
+
+	/** Built once the crosshair has streamed in and only moved when the canvas size changes */
+	TUniquePtr<FCanvasTileItem> CrosshairItem;
+	FVector2D CrosshairCanvasSize;
+
+	UPROPERTY(Transient)
+	UPlayerHealthWidget* PlayerWidget;
+
+	/** Pawn whose life system the player widget is listening to */
+	TWeakObjectPtr<APawn> PlayerWidgetPawn;
+
+	void OnHUDAssetsLoaded();
 
+	/** Points the player widget at the owning pawn's life system, when the pawn has changed */
+	void UpdatePlayerWidgetPawn();
 };
 
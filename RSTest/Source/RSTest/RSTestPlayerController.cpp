@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "RSTestPlayerController.h"
+#include "RSTestCharacter.h"
+#include "Misc/CommandLine.h"
+
+ARSTestPlayerController::ARSTestPlayerController()
+{
+	_botFireInterval = 0.25f;
+	_botJumpInterval = 1.5f;
+	_botTurnRate = 45.f;
+
+	_isNetBot = false;
+	_botFireTimer = 0.f;
+	_botJumpTimer = 0.f;
+}
+
+void ARSTestPlayerController::BeginPlay()
+{
+	Super::BeginPlay();
+
+	_isNetBot = IsLocalController() && GetNetMode() == NM_Client && FParse::Param(FCommandLine::Get(), TEXT("RSNetBot"));
+
+	// Spread the bots out so they don't all fire on the same frame
+	_botFireTimer = FMath::FRand() * _botFireInterval;
+	_botJumpTimer = FMath::FRand() * _botJumpInterval;
+}
+
+void ARSTestPlayerController::PlayerTick(float DeltaTime)
+{
+	Super::PlayerTick(DeltaTime);
+
+	if (_isNetBot)
+	{
+		DriveNetBot(DeltaTime);
+	}
+}
+
+void ARSTestPlayerController::DriveNetBot(float deltaTime)
+{
+	ARSTestCharacter* character = Cast<ARSTestCharacter>(GetPawn());
+	if (!character)
+	{
+		return;
+	}
+
+	// Runs in a wide circle, so it keeps moving through other players' relevancy
+	AddYawInput(_botTurnRate * deltaTime / FMath::Max(InputYawScale, KINDA_SMALL_NUMBER));
+	character->ScriptedMove(1.f, 0.f);
+
+	_botFireTimer -= deltaTime;
+	if (_botFireTimer <= 0.f)
+	{
+		_botFireTimer += _botFireInterval;
+		character->ScriptedFire();
+	}
+
+	_botJumpTimer -= deltaTime;
+	if (_botJumpTimer <= 0.f)
+	{
+		_botJumpTimer += _botJumpInterval;
+		character->Jump();
+	}
+}
+
+void ARSTestPlayerController::ClientProjectileSpawned_Implementation(const FProjectileSpawnEvent& spawnEvent)
+{
+	if (ACombatReplicator* combatReplicator = ACombatReplicator::Get(this))
+	{
+		combatReplicator->ReceiveProjectileSpawn(spawnEvent);
+	}
+}
+
+void ARSTestPlayerController::ClientSpikeSpawned_Implementation(const FSpikeSpawnEvent& spawnEvent)
+{
+	if (ACombatReplicator* combatReplicator = ACombatReplicator::Get(this))
+	{
+		combatReplicator->ReceiveSpikeSpawn(spawnEvent);
+	}
+}
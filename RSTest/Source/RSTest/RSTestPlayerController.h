@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PlayerController.h"
+#include "Systems/CombatReplicator.h"
+#include "RSTestPlayerController.generated.h"
+
+/**
+ * Carries the combat replicator's spawn events to its own client, the connection each event goes down is picked by the
+ * server per player. Launched with -RSNetBot a client's controller also plays by itself (runs, turns, fires and jumps),
+ * for headless clients in network load tests.
+ */
+UCLASS()
+class RSTEST_API ARSTestPlayerController : public APlayerController
+{
+	GENERATED_BODY()
+
+public:
+	ARSTestPlayerController();
+
+	//Variables
+protected:
+	UPROPERTY(EditDefaultsOnly, Category = "Net Bot Data", meta = (ClampMin = 0.05))
+	float _botFireInterval;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Net Bot Data", meta = (ClampMin = 0.1))
+	float _botJumpInterval;
+
+	// Degrees per second
+	UPROPERTY(EditDefaultsOnly, Category = "Net Bot Data")
+	float _botTurnRate;
+
+private:
+	bool _isNetBot;
+	float _botFireTimer;
+	float _botJumpTimer;
+
+	//Functions
+public:
+	// Shots are frequent and replaced by the next one, a lost one isn't worth resending
+	UFUNCTION(Client, Unreliable)
+	void ClientProjectileSpawned(const FProjectileSpawnEvent& spawnEvent);
+
+	UFUNCTION(Client, Reliable)
+	void ClientSpikeSpawned(const FSpikeSpawnEvent& spawnEvent);
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void PlayerTick(float DeltaTime) override;
+
+	void DriveNetBot(float deltaTime);
+};
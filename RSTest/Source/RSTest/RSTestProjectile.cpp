@@ -3,10 +3,21 @@
 #include "RSTestProjectile.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Components/SphereComponent.h"
-#include "Enemies/BaseEnemy.h"
+#include "Interfaces/Damageable.h"
+#include "RSTestStats.h"
+#include "Systems/DamageQueue.h"
+#include "Systems/HitboxHistory.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Systems/ProjectilePool.h"
+#include "Systems/ProjectileSimulationManager.h"
+#include "Systems/TickPolicy.h"
 
 ARSTestProjectile::ARSTestProjectile() 
 {
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
 	// Use a sphere as a simple collision representation
 	CollisionComp = CreateDefaultSubobject<USphereComponent>(TEXT("SphereComp"));
 	CollisionComp->InitSphereRadius(5.0f);
@@ -32,18 +43,240 @@ ARSTestProjectile::ARSTestProjectile()
 	InitialLifeSpan = 3.f;
 
 	_damage = 1.f;
+
+	_rewindSeconds = 0.f;
+	_lastRewoundLocation = FVector::ZeroVector;
+
+	_isActiveInPool = false;
+	_pooledLifeSpan = InitialLifeSpan;
+}
+
+void ARSTestProjectile::BeginPlay()
+{
+	Super::BeginPlay();
+
+	_liveToken.SetLive(true);
+
+	if (_ownerPool.IsValid())
+	{
+		// Pooled projectiles are spawned asleep and only get their life span when they're fired
+		_pooledLifeSpan = InitialLifeSpan;
+		_isActiveInPool = true;
+		DeactivateToPool();
+	}
+}
+
+void ARSTestProjectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	_liveToken.SetLive(false);
+
+	if (_ownerPool.IsValid())
+	{
+		_ownerPool->ForgetProjectile(this);
+		_ownerPool = nullptr;
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ARSTestProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
+	RSTEST_SCOPE_COUNTER(ProjectileHit);
+
 	if ((OtherActor != NULL) && (OtherActor != this))
 	{
-		if (OtherActor->IsA(ABaseEnemy::StaticClass()))
+		if (ApplyHitDamage(this, OtherActor, _damage))
+		{
+			ReturnToPoolOrDestroy();
+		}
+	}
+}
+
+bool ARSTestProjectile::ApplyHitDamage(AActor* attackedBy, AActor* OtherActor, float damage)
+{
+	IDamageable* damageable = Cast<IDamageable>(OtherActor);
+	if (damageable && damageable->GetDamageTeam() == EDamageTeam::DT_Enemy)
+	{
+		ADamageQueue::QueueDamage(OtherActor, attackedBy, damage);
+		return true;
+	}
+	return false;
+}
+
+bool ARSTestProjectile::LaunchProjectile(const UObject* worldContextObject, TSubclassOf<ARSTestProjectile> projectileClass, const FVector& location, const FRotator& rotation,
+	AActor* instigator, bool batched, ESpawnActorCollisionHandlingMethod collisionHandling)
+{
+	if (!projectileClass)
+	{
+		return false;
+	}
+
+	if (batched)
+	{
+		AProjectileSimulationManager* simulationManager = AProjectileSimulationManager::Get(worldContextObject);
+		if (simulationManager && simulationManager->FireProjectile(projectileClass, location, rotation, instigator))
+		{
+			return true;
+		}
+	}
+
+	ARSTestProjectile* projectile = nullptr;
+	AProjectilePool* projectilePool = AProjectilePool::Get(worldContextObject);
+	if (projectilePool)
+	{
+		projectile = projectilePool->AcquireProjectile(projectileClass, location, rotation, instigator, collisionHandling);
+	}
+	else if (UWorld* world = GEngine->GetWorldFromContextObject(worldContextObject, EGetWorldErrorMode::ReturnNull))
+	{
+		//Set Spawn Collision Handling Override
+		FActorSpawnParameters ActorSpawnParams;
+		ActorSpawnParams.SpawnCollisionHandlingOverride = collisionHandling;
+		ActorSpawnParams.Owner = instigator;
+
+		projectile = world->SpawnActor<ARSTestProjectile>(projectileClass, location, rotation, ActorSpawnParams);
+	}
+
+	AHitboxHistory* hitboxHistory = AHitboxHistory::Get(worldContextObject);
+	if (projectile && hitboxHistory)
+	{
+		projectile->SetRewindSeconds(hitboxHistory->GetRewindSeconds(instigator));
+	}
+	return false;
+}
+
+void ARSTestProjectile::SetRewindSeconds(float rewindSeconds)
+{
+	_rewindSeconds = rewindSeconds;
+	_lastRewoundLocation = GetActorLocation();
+
+	// The history stands in for characters' current capsules, hitting both would count some shots twice. It grows to give
+	// every character a column, so none of them are left out by ignoring the whole channel
+	const ARSTestProjectile* projectileDefaults = GetClass()->GetDefaultObject<ARSTestProjectile>();
+	CollisionComp->SetCollisionResponseToChannel(ECC_Pawn, _rewindSeconds > 0.f ? ECR_Ignore : projectileDefaults->CollisionComp->GetCollisionResponseToChannel(ECC_Pawn));
+
+	SetActorTickActive(this, _rewindSeconds > 0.f, TEXT("LagCompensation"));
+}
+
+void ARSTestProjectile::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (_rewindSeconds <= 0.f)
+	{
+		return;
+	}
+
+	// Covers wherever the movement component has taken us since last tick, whichever of the two ticked first
+	const FVector location = GetActorLocation();
+	FHitboxRewindHit rewoundHit;
+	AHitboxHistory* hitboxHistory = AHitboxHistory::Get(this);
+	if (hitboxHistory && hitboxHistory->SweepRewound(_lastRewoundLocation, location, CollisionComp->GetScaledSphereRadius(),
+		GetWorld()->GetTimeSeconds() - _rewindSeconds, GetOwner(), rewoundHit))
+	{
+		RSTEST_SCOPE_COUNTER(ProjectileHit);
+
+		if (ApplyHitDamage(this, rewoundHit.Actor, _damage))
 		{
-			ABaseEnemy* enemy = Cast<ABaseEnemy>(OtherActor);
+			ReturnToPoolOrDestroy();
+			return;
+		}
+	}
+	_lastRewoundLocation = location;
+}
 
-			enemy->OnAttacked(this, _damage);
-			Destroy();
+bool ARSTestProjectile::ActivateFromPool(const FVector& location, const FRotator& rotation, ESpawnActorCollisionHandlingMethod collisionHandling)
+{
+	SetActorEnableCollision(true);
+
+	bool placed = true;
+	switch (collisionHandling)
+	{
+	case ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding:
+		placed = TeleportTo(location, rotation);
+		break;
+	case ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn:
+		if (!TeleportTo(location, rotation))
+		{
+			SetActorLocationAndRotation(location, rotation, false, nullptr, ETeleportType::TeleportPhysics);
 		}
+		break;
+	case ESpawnActorCollisionHandlingMethod::DontSpawnIfColliding:
+		placed = !GetWorld()->EncroachingBlockingGeometry(this, location, rotation);
+		if (placed)
+		{
+			SetActorLocationAndRotation(location, rotation, false, nullptr, ETeleportType::TeleportPhysics);
+		}
+		break;
+	default:
+		SetActorLocationAndRotation(location, rotation, false, nullptr, ETeleportType::TeleportPhysics);
+		break;
+	}
+
+	if (!placed)
+	{
+		SetActorEnableCollision(false);
+		return false;
+	}
+
+	CollisionComp->ClearMoveIgnoreActors();
+
+	// Same state InitializeComponent gives a freshly spawned projectile
+	ProjectileMovement->SetUpdatedComponent(CollisionComp);
+	ProjectileMovement->Velocity = rotation.Vector() * ProjectileMovement->InitialSpeed;
+	ProjectileMovement->UpdateComponentVelocity();
+	ProjectileMovement->Activate(true);
+
+	SetActorHiddenInGame(false);
+	SetLifeSpan(_pooledLifeSpan);
+
+	_isActiveInPool = true;
+	_liveToken.SetLive(true);
+	return true;
+}
+
+void ARSTestProjectile::DeactivateToPool()
+{
+	if (!_isActiveInPool)
+	{
+		return;
 	}
+	_isActiveInPool = false;
+	_liveToken.SetLive(false);
+
+	SetLifeSpan(0.f);
+
+	ProjectileMovement->StopMovementImmediately();
+	ProjectileMovement->Deactivate();
+
+	SetRewindSeconds(0.f);
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+}
+
+void ARSTestProjectile::ReturnToPoolOrDestroy()
+{
+	if (_ownerPool.IsValid())
+	{
+		_ownerPool->ReleaseProjectile(this);
+	}
+	else
+	{
+		Destroy();
+	}
+}
+
+void ARSTestProjectile::LifeSpanExpired()
+{
+	ReturnToPoolOrDestroy();
+}
+
+void ARSTestProjectile::FellOutOfWorld(const UDamageType& dmgType)
+{
+	ReturnToPoolOrDestroy();
+}
+
+void ARSTestProjectile::OutsideWorldBounds()
+{
+	ReturnToPoolOrDestroy();
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "RSTestStats.h"
 #include "RSTestProjectile.generated.h"
 
 UCLASS(config=Game)
@@ -31,8 +32,69 @@ public:
 	/** Returns ProjectileMovement subobject **/
 	FORCEINLINE class UProjectileMovementComponent* GetProjectileMovement() const { return ProjectileMovement; }
 
+	float GetDamage() const { return _damage; }
+
+	/** Damages OtherActor if a player projectile is allowed to hurt it, returns true if the projectile is used up */
+	static bool ApplyHitDamage(AActor* attackedBy, AActor* OtherActor, float damage);
+
+	/**
+	 * Fires a projectile through the batched simulation if asked to and it has room, otherwise takes one from the pool
+	 * (or spawns one if there's no pool). Returns true if it went through the batched simulation
+	 */
+	static bool LaunchProjectile(const UObject* worldContextObject, TSubclassOf<ARSTestProjectile> projectileClass, const FVector& location, const FRotator& rotation,
+		AActor* instigator, bool batched, ESpawnActorCollisionHandlingMethod collisionHandling);
+
+	/**
+	 * Checks characters against where they were this many seconds ago instead of where they are now (see AHitboxHistory),
+	 * the projectile passes through their current capsules while it's set. 0 goes back to normal collision
+	 */
+	void SetRewindSeconds(float rewindSeconds);
+
 protected:
 	UPROPERTY(EditDefaultsOnly, Category = "Projectile Data", meta = (ClampMin = 0))
 	float _damage;
+
+	// Lag compensation
+private:
+	float _rewindSeconds;
+
+	FVector _lastRewoundLocation;
+
+	//Pooling
+private:
+	TWeakObjectPtr<class AProjectilePool> _ownerPool;
+
+	bool _isActiveInPool;
+
+	float _pooledLifeSpan;
+
+	TRSTestLiveToken<ERSTestGauge::LiveProjectiles> _liveToken;
+
+public:
+	void SetOwnerPool(class AProjectilePool* pool) { _ownerPool = pool; }
+
+	bool GetIsActiveInPool() const { return _isActiveInPool; }
+
+	// Places and launches a pooled projectile as if it was just spawned, returns false if it couldn't be placed
+	bool ActivateFromPool(const FVector& location, const FRotator& rotation, ESpawnActorCollisionHandlingMethod collisionHandling);
+
+	void DeactivateToPool();
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Only ticks while lag compensated
+	virtual void Tick(float DeltaTime) override;
+
+	virtual void LifeSpanExpired() override;
+
+	virtual void FellOutOfWorld(const class UDamageType& dmgType) override;
+
+	virtual void OutsideWorldBounds() override;
+
+	// Hands the projectile back to its pool, or destroys it if it was spawned outside of one
+	void ReturnToPoolOrDestroy();
 };
 
@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "RSTestStats.h"
+
+DEFINE_STAT(STAT_ChannelerAnchorTraces);
+DEFINE_STAT(STAT_ChannelerAnchorTracesPerSecond);
+DEFINE_STAT(STAT_WallRunTraces);
+DEFINE_STAT(STAT_VisibilityTraces);
+
+DEFINE_STAT(STAT_ChannelerAttack);
+DEFINE_STAT(STAT_CreateEarthSpike);
+DEFINE_STAT(STAT_SpikePowerTick);
+DEFINE_STAT(STAT_SpikeAttackOverlap);
+DEFINE_STAT(STAT_WhileWallRunning);
+DEFINE_STAT(STAT_CheckWillWallRun);
+DEFINE_STAT(STAT_Jump);
+DEFINE_STAT(STAT_OnFire);
+DEFINE_STAT(STAT_ProjectileHit);
+DEFINE_STAT(STAT_TakeDamage);
+DEFINE_STAT(STAT_HitboxRecord);
+DEFINE_STAT(STAT_HitboxRewind);
+
+DEFINE_STAT(STAT_ChannelerAttackCalls);
+DEFINE_STAT(STAT_CreateEarthSpikeCalls);
+DEFINE_STAT(STAT_SpikePowerTickCalls);
+DEFINE_STAT(STAT_SpikeAttackOverlapCalls);
+DEFINE_STAT(STAT_WhileWallRunningCalls);
+DEFINE_STAT(STAT_CheckWillWallRunCalls);
+DEFINE_STAT(STAT_JumpCalls);
+DEFINE_STAT(STAT_OnFireCalls);
+DEFINE_STAT(STAT_ProjectileHitCalls);
+DEFINE_STAT(STAT_TakeDamageCalls);
+DEFINE_STAT(STAT_HitboxRecordCalls);
+DEFINE_STAT(STAT_HitboxRewindCalls);
+
+DEFINE_STAT(STAT_LiveSpikes);
+DEFINE_STAT(STAT_LiveProjectiles);
+DEFINE_STAT(STAT_LiveEnemies);
+
+uint64 FRSTestQueryCounters::ChannelerAnchorTraces = 0;
+uint64 FRSTestQueryCounters::WallRunTraces = 0;
+uint64 FRSTestQueryCounters::VisibilityTraces = 0;
+uint64 FRSTestQueryCounters::ProjectileSweeps = 0;
+uint64 FRSTestQueryCounters::HitboxRewinds = 0;
+
+uint64 FRSTestScopeCounters::Cycles[(int32)ERSTestScope::Count] = {};
+uint64 FRSTestScopeCounters::Calls[(int32)ERSTestScope::Count] = {};
+
+const TCHAR* FRSTestScopeCounters::GetName(ERSTestScope scope)
+{
+	switch (scope)
+	{
+	case ERSTestScope::ChannelerAttack:		return TEXT("ChannelerAttack");
+	case ERSTestScope::CreateEarthSpike:	return TEXT("CreateEarthSpike");
+	case ERSTestScope::SpikePowerTick:		return TEXT("SpikePowerTick");
+	case ERSTestScope::SpikeAttackOverlap:	return TEXT("SpikeAttackOverlap");
+	case ERSTestScope::WhileWallRunning:	return TEXT("WhileWallRunning");
+	case ERSTestScope::CheckWillWallRun:	return TEXT("CheckWillWallRun");
+	case ERSTestScope::Jump:				return TEXT("Jump");
+	case ERSTestScope::OnFire:				return TEXT("OnFire");
+	case ERSTestScope::ProjectileHit:		return TEXT("ProjectileHit");
+	case ERSTestScope::TakeDamage:			return TEXT("TakeDamage");
+	case ERSTestScope::HitboxRecord:		return TEXT("HitboxRecord");
+	case ERSTestScope::HitboxRewind:		return TEXT("HitboxRewind");
+	default:								return TEXT("Unknown");
+	}
+}
+
+void FRSTestScopeCounters::Reset()
+{
+	FMemory::Memzero(Cycles);
+	FMemory::Memzero(Calls);
+}
+
+int32 FRSTestGauges::Values[(int32)ERSTestGauge::Count] = {};
+
+void FRSTestGauges::Add(ERSTestGauge gauge, int32 delta)
+{
+	int32& value = Values[(int32)gauge];
+	value += delta;
+
+	switch (gauge)
+	{
+	case ERSTestGauge::LiveSpikes:		SET_DWORD_STAT(STAT_LiveSpikes, value); break;
+	case ERSTestGauge::LiveProjectiles:	SET_DWORD_STAT(STAT_LiveProjectiles, value); break;
+	case ERSTestGauge::LiveEnemies:		SET_DWORD_STAT(STAT_LiveEnemies, value); break;
+	default: break;
+	}
+}
+
+const TCHAR* FRSTestGauges::GetName(ERSTestGauge gauge)
+{
+	switch (gauge)
+	{
+	case ERSTestGauge::LiveSpikes:		return TEXT("LiveSpikes");
+	case ERSTestGauge::LiveProjectiles:	return TEXT("LiveProjectiles");
+	case ERSTestGauge::LiveEnemies:		return TEXT("LiveEnemies");
+	default:							return TEXT("Unknown");
+	}
+}
@@ -0,0 +1,159 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("RSTest"), STATGROUP_RSTest, STATCAT_Advanced);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Channeler Anchor Traces"), STAT_ChannelerAnchorTraces, STATGROUP_RSTest, RSTEST_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Channeler Anchor Traces/s"), STAT_ChannelerAnchorTracesPerSecond, STATGROUP_RSTest, RSTEST_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Wall Run Traces"), STAT_WallRunTraces, STATGROUP_RSTest, RSTEST_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Visibility Traces"), STAT_VisibilityTraces, STATGROUP_RSTest, RSTEST_API);
+
+// Gameplay hot paths, each with a cycle counter and a call counter. Add a scope here, to ERSTestScope and to RSTestStats.cpp
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Channeler Attack"), STAT_ChannelerAttack, STATGROUP_RSTest, RSTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Channeler Create Earth Spike"), STAT_CreateEarthSpike, STATGROUP_RSTest, RSTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Earth Spike Power Tick"), STAT_SpikePowerTick, STATGROUP_RSTest, RSTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Earth Spike Attack Overlap"), STAT_SpikeAttackOverlap, STATGROUP_RSTest, RSTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Character While Wall Running"), STAT_WhileWallRunning, STATGROUP_RSTest, RSTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Character Check Will Wall Run"), STAT_CheckWillWallRun, STATGROUP_RSTest, RSTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Character Jump"), STAT_Jump, STATGROUP_RSTest, RSTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Character On Fire"), STAT_OnFire, STATGROUP_RSTest, RSTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Projectile On Hit"), STAT_ProjectileHit, STATGROUP_RSTest, RSTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Life System Take Damage"), STAT_TakeDamage, STATGROUP_RSTest, RSTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Hitbox History Record"), STAT_HitboxRecord, STATGROUP_RSTest, RSTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Hitbox History Rewind"), STAT_HitboxRewind, STATGROUP_RSTest, RSTEST_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Channeler Attack Calls"), STAT_ChannelerAttackCalls, STATGROUP_RSTest, RSTEST_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Channeler Create Earth Spike Calls"), STAT_CreateEarthSpikeCalls, STATGROUP_RSTest, RSTEST_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Earth Spike Power Tick Calls"), STAT_SpikePowerTickCalls, STATGROUP_RSTest, RSTEST_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Earth Spike Attack Overlap Calls"), STAT_SpikeAttackOverlapCalls, STATGROUP_RSTest, RSTEST_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Character While Wall Running Calls"), STAT_WhileWallRunningCalls, STATGROUP_RSTest, RSTEST_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Character Check Will Wall Run Calls"), STAT_CheckWillWallRunCalls, STATGROUP_RSTest, RSTEST_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Character Jump Calls"), STAT_JumpCalls, STATGROUP_RSTest, RSTEST_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Character On Fire Calls"), STAT_OnFireCalls, STATGROUP_RSTest, RSTEST_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Projectile On Hit Calls"), STAT_ProjectileHitCalls, STATGROUP_RSTest, RSTEST_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Life System Take Damage Calls"), STAT_TakeDamageCalls, STATGROUP_RSTest, RSTEST_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Hitbox History Record Calls"), STAT_HitboxRecordCalls, STATGROUP_RSTest, RSTEST_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Hitbox History Rewind Calls"), STAT_HitboxRewindCalls, STATGROUP_RSTest, RSTEST_API);
+
+// Live gameplay entities, kept up to date by the entities themselves (see FRSTestGauges)
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live Spikes"), STAT_LiveSpikes, STATGROUP_RSTest, RSTEST_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live Projectiles"), STAT_LiveProjectiles, STATGROUP_RSTest, RSTEST_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live Enemies"), STAT_LiveEnemies, STATGROUP_RSTest, RSTEST_API);
+
+/** Scene queries issued by game code (not the engine's own, like movement component sweeps), counted outside the stats system so any build can report them (the benchmark runner does) */
+struct RSTEST_API FRSTestQueryCounters
+{
+	static uint64 ChannelerAnchorTraces;
+	static uint64 WallRunTraces;
+	static uint64 VisibilityTraces;
+	static uint64 ProjectileSweeps;
+
+	// Tests against the hitbox history rather than the physics scene, not part of the total
+	static uint64 HitboxRewinds;
+
+	static uint64 GetTotal() { return ChannelerAnchorTraces + WallRunTraces + VisibilityTraces + ProjectileSweeps; }
+};
+
+enum class ERSTestScope : uint8
+{
+	ChannelerAttack,
+	CreateEarthSpike,
+	SpikePowerTick,
+	SpikeAttackOverlap,
+	WhileWallRunning,
+	CheckWillWallRun,
+	Jump,
+	OnFire,
+	ProjectileHit,
+	TakeDamage,
+	HitboxRecord,
+	HitboxRewind,
+
+	Count
+};
+
+/**
+ * Time and calls per gameplay scope since the last Reset, the same numbers as the cycle stats but available without a stats
+ * build, for the CSV export. Inclusive, a scope called from inside another is counted in both. Game thread only.
+ */
+struct RSTEST_API FRSTestScopeCounters
+{
+	static uint64 Cycles[(int32)ERSTestScope::Count];
+	static uint64 Calls[(int32)ERSTestScope::Count];
+
+	static const TCHAR* GetName(ERSTestScope scope);
+
+	static void Reset();
+};
+
+struct FRSTestScopeTimer
+{
+	explicit FRSTestScopeTimer(ERSTestScope scope) : Scope(scope), StartCycles(FPlatformTime::Cycles64()) {}
+
+	~FRSTestScopeTimer()
+	{
+		FRSTestScopeCounters::Cycles[(int32)Scope] += FPlatformTime::Cycles64() - StartCycles;
+		FRSTestScopeCounters::Calls[(int32)Scope]++;
+	}
+
+	ERSTestScope Scope;
+	uint64 StartCycles;
+};
+
+// Times the rest of the enclosing block as one of the ERSTestScope hot paths, for "stat RSTest" and the CSV export
+#if !UE_BUILD_SHIPPING
+	#define RSTEST_SCOPE_COUNTER(Scope) \
+		SCOPE_CYCLE_COUNTER(STAT_##Scope); \
+		INC_DWORD_STAT(STAT_##Scope##Calls); \
+		FRSTestScopeTimer RSTestScopeTimer_##Scope(ERSTestScope::Scope)
+#else
+	#define RSTEST_SCOPE_COUNTER(Scope)
+#endif
+
+enum class ERSTestGauge : uint8
+{
+	LiveSpikes,
+	LiveProjectiles,
+	LiveEnemies,
+
+	Count
+};
+
+/** Current value of each gauge, mirrored into its accumulator stat */
+struct RSTEST_API FRSTestGauges
+{
+	static int32 Values[(int32)ERSTestGauge::Count];
+
+	static void Add(ERSTestGauge gauge, int32 delta);
+
+	static int32 Get(ERSTestGauge gauge) { return Values[(int32)gauge]; }
+
+	static const TCHAR* GetName(ERSTestGauge gauge);
+};
+
+/**
+ * Counts its owner towards a gauge while the owner is live. Pooled owners flip it as they wake up and go to sleep, and every
+ * owner clears it in EndPlay - clearing twice is fine.
+ */
+template<ERSTestGauge Gauge>
+struct TRSTestLiveToken
+{
+	TRSTestLiveToken() : IsLive(false) {}
+
+	~TRSTestLiveToken() { SetLive(false); }
+
+	void SetLive(bool live)
+	{
+		if (live != IsLive)
+		{
+			IsLive = live;
+			FRSTestGauges::Add(Gauge, live ? 1 : -1);
+		}
+	}
+
+	bool IsLive;
+};
@@ -0,0 +1,539 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ArenaSnapshot.h"
+#include "AIController.h"
+#include "BrainComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Components/LifeSystem.h"
+#include "Enemies/BaseEnemy.h"
+#include "RSTestStats.h"
+#include "Systems/AttackTokenDirector.h"
+#include "Systems/DamageQueue.h"
+#include "Systems/HitboxHistory.h"
+#include "Systems/ProjectilePool.h"
+#include "Systems/ProjectileSimulationManager.h"
+#include "Systems/SpikeManager.h"
+#include "Systems/WorldManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogArenaSnapshot, Log, All);
+
+static FAutoConsoleCommandWithWorld GSnapshotCaptureCommand(
+	TEXT("RSTest.Snapshot.Capture"),
+	TEXT("Captures the arena's gameplay state for RSTest.Snapshot.Restore, replacing the one taken when the map loaded"),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* world)
+	{
+		if (AArenaSnapshot* snapshot = GetWorldManager<AArenaSnapshot>(world))
+		{
+			snapshot->Capture();
+		}
+	})
+);
+
+static FAutoConsoleCommandWithWorldAndArgs GSnapshotRestoreCommand(
+	TEXT("RSTest.Snapshot.Restore"),
+	TEXT("Restarts the arena from the captured snapshot, the given number of times back to back (default 1), and logs how long it took"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& args, UWorld* world)
+	{
+		if (AArenaSnapshot* snapshot = GetWorldManager<AArenaSnapshot>(world, false))
+		{
+			const int32 count = args.Num() > 0 ? FMath::Max(FCString::Atoi(*args[0]), 1) : 1;
+			for (int32 i = 0; i < count; i++)
+			{
+				if (!snapshot->Restore())
+				{
+					break;
+				}
+			}
+			snapshot->LogStats();
+		}
+	})
+);
+
+static FAutoConsoleCommandWithWorld GSnapshotStatsCommand(
+	TEXT("RSTest.Snapshot.Stats"),
+	TEXT("Logs what the arena snapshot holds and how long restoring it has taken"),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* world)
+	{
+		if (AArenaSnapshot* snapshot = GetWorldManager<AArenaSnapshot>(world, false))
+		{
+			snapshot->LogStats();
+		}
+	})
+);
+
+static UBlackboardComponent* GetEnemyBlackboard(const ABaseEnemy* enemy)
+{
+	AAIController* aiController = Cast<AAIController>(enemy->GetController());
+	return aiController ? aiController->GetBlackboardComponent() : nullptr;
+}
+
+// Keys with a key instance (strings) keep their value outside the blackboard's memory, every other key is plain data in it
+static bool GetIsRawBlackboardKey(const UBlackboardData* blackboardAsset, int32 keyID, uint16& outValueSize)
+{
+	const FBlackboardEntry* key = blackboardAsset->GetKey((FBlackboard::FKey)keyID);
+	if (!key || !key->KeyType || key->KeyType->HasInstance())
+	{
+		return false;
+	}
+
+	outValueSize = key->KeyType->GetValueSize();
+	return true;
+}
+
+static void SaveBlackboardValues(UBlackboardComponent* blackboard, TArray<uint8>& outValues)
+{
+	outValues.Reset();
+
+	const UBlackboardData* blackboardAsset = blackboard ? blackboard->GetBlackboardAsset() : nullptr;
+	if (!blackboardAsset)
+	{
+		return;
+	}
+
+	for (int32 keyID = 0; keyID < blackboardAsset->GetNumKeys(); keyID++)
+	{
+		uint16 valueSize = 0;
+		if (!GetIsRawBlackboardKey(blackboardAsset, keyID, valueSize))
+		{
+			continue;
+		}
+
+		const uint8* rawData = blackboard->GetKeyRawData((FBlackboard::FKey)keyID);
+		if (rawData)
+		{
+			outValues.Append(rawData, valueSize);
+		}
+		else
+		{
+			outValues.AddZeroed(valueSize);
+		}
+	}
+}
+
+// Written straight into the blackboard's memory, observers aren't told - the behaviour tree is restarted on the new values instead
+static void LoadBlackboardValues(UBlackboardComponent* blackboard, const TArray<uint8>& values)
+{
+	const UBlackboardData* blackboardAsset = blackboard ? blackboard->GetBlackboardAsset() : nullptr;
+	if (!blackboardAsset)
+	{
+		return;
+	}
+
+	int32 valueOffset = 0;
+	for (int32 keyID = 0; keyID < blackboardAsset->GetNumKeys(); keyID++)
+	{
+		uint16 valueSize = 0;
+		if (!GetIsRawBlackboardKey(blackboardAsset, keyID, valueSize))
+		{
+			continue;
+		}
+
+		uint8* rawData = blackboard->GetKeyRawData((FBlackboard::FKey)keyID);
+		if (rawData && valueOffset + valueSize <= values.Num())
+		{
+			FMemory::Memcpy(rawData, values.GetData() + valueOffset, valueSize);
+		}
+		valueOffset += valueSize;
+	}
+}
+
+AArenaSnapshot::AArenaSnapshot()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false; // Only while waiting to capture, restore or run episodes
+	bReplicates = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+
+	_captureOnStart = true;
+	_restoreOnPlayerDeath = false;
+
+	_hasSnapshot = false;
+	_waitingToCapture = false;
+	_restorePending = false;
+
+	_episodesLeft = 0;
+	_episodeSeconds = 0.f;
+	_nextEpisodeTime = 0.f;
+	_quitWhenDone = false;
+
+	_restoreCount = 0;
+}
+
+AArenaSnapshot* AArenaSnapshot::Get(const UObject* worldContextObject)
+{
+	return GetWorldManager<AArenaSnapshot>(worldContextObject);
+}
+
+void AArenaSnapshot::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (_captureOnStart)
+	{
+		CaptureWhenReady();
+	}
+}
+
+void AArenaSnapshot::CaptureWhenReady()
+{
+	if (GetIsWorldReady())
+	{
+		Capture();
+		return;
+	}
+
+	_waitingToCapture = true;
+	UpdateTickEnabled();
+}
+
+void AArenaSnapshot::StartEpisodes(int32 count, float episodeSeconds, bool quitWhenDone)
+{
+	_episodesLeft = FMath::Max(count, 0);
+	_episodeSeconds = FMath::Max(episodeSeconds, 0.f);
+	_quitWhenDone = quitWhenDone;
+	_restoreMs.Reset();
+
+	UE_LOG(LogArenaSnapshot, Log, TEXT("Arena snapshot: running %d episodes of %.1f s"), _episodesLeft, _episodeSeconds);
+
+	if (_hasSnapshot)
+	{
+		_nextEpisodeTime = GetWorld()->GetTimeSeconds() + _episodeSeconds;
+		UpdateTickEnabled();
+	}
+	else
+	{
+		// The first episode starts from the capture
+		CaptureWhenReady();
+	}
+}
+
+bool AArenaSnapshot::GetIsWorldReady() const
+{
+	if (!UGameplayStatics::GetPlayerCharacter(this, 0))
+	{
+		return false;
+	}
+
+	const AEnemyDirector* enemyDirector = GetWorldManager<AEnemyDirector>(this, false);
+	return !enemyDirector || !enemyDirector->GetHasWaveData() || enemyDirector->GetIsReady();
+}
+
+void AArenaSnapshot::Capture()
+{
+	// Clients only see replicated copies, restoring is up to the server
+	if (GetNetMode() == NM_Client)
+	{
+		UE_LOG(LogArenaSnapshot, Warning, TEXT("Arena snapshot: only the server can capture the arena"));
+		return;
+	}
+
+	_waitingToCapture = false;
+
+	const double captureStartTime = FPlatformTime::Seconds();
+
+	ARSTestCharacter* player = Cast<ARSTestCharacter>(UGameplayStatics::GetPlayerCharacter(this, 0));
+	if (_player.IsValid() && _player != player)
+	{
+		_player->LifeSystem->OnDeathNative.Remove(_playerDeathHandle);
+		_playerDeathHandle.Reset();
+	}
+
+	_player = player;
+	if (player)
+	{
+		player->CaptureSnapshot(_playerSnapshot);
+
+		if (_restoreOnPlayerDeath && !_playerDeathHandle.IsValid())
+		{
+			_playerDeathHandle = player->LifeSystem->OnDeathNative.AddUObject(this, &AArenaSnapshot::OnPlayerDeath);
+		}
+	}
+
+	_enemies.Reset();
+	for (TActorIterator<ABaseEnemy> it(GetWorld()); it; ++it)
+	{
+		ABaseEnemy* enemy = *it;
+		if (enemy->IsPendingKill())
+		{
+			continue;
+		}
+
+		FEnemySnapshot& enemySnapshot = _enemies[_enemies.AddDefaulted()];
+		enemySnapshot.Enemy = enemy;
+		enemySnapshot.Transform = enemy->GetActorTransform();
+		enemySnapshot.Velocity = enemy->GetCharacterMovement()->Velocity;
+		enemySnapshot.Health = enemy->LifeSystem->GetHealth();
+		enemySnapshot.IsActive = enemy->GetIsPooled() ? enemy->GetIsActiveInPool() : !enemy->GetIsAsleep();
+		SaveBlackboardValues(GetEnemyBlackboard(enemy), enemySnapshot.BlackboardValues);
+
+		// Level placed enemies would be destroyed when killed and missing from every restore after
+		if (!enemy->GetIsPooled())
+		{
+			enemy->SetSleepWhenKilled(true);
+		}
+	}
+
+	_enemyDirector = GetWorldManager<AEnemyDirector>(this, false);
+	if (_enemyDirector.IsValid())
+	{
+		_enemyDirector->CaptureWaveState(_waveState);
+	}
+
+	// Bullets and spikes are never part of the snapshot, restoring clears them
+	const int32 liveProjectiles = FRSTestGauges::Get(ERSTestGauge::LiveProjectiles);
+	const int32 liveSpikes = FRSTestGauges::Get(ERSTestGauge::LiveSpikes);
+	if (liveProjectiles > 0 || liveSpikes > 0)
+	{
+		UE_LOG(LogArenaSnapshot, Warning, TEXT("Arena snapshot: %d projectiles and %d spikes in play won't come back on restore"), liveProjectiles, liveSpikes);
+	}
+
+	_hasSnapshot = true;
+	_nextEpisodeTime = GetWorld()->GetTimeSeconds() + _episodeSeconds;
+
+	UE_LOG(LogArenaSnapshot, Log, TEXT("Arena snapshot: captured the player and %d enemies in %.2f ms"),
+		_enemies.Num(), (FPlatformTime::Seconds() - captureStartTime) * 1000.0);
+
+	UpdateTickEnabled();
+}
+
+bool AArenaSnapshot::Restore()
+{
+	if (!_hasSnapshot)
+	{
+		UE_LOG(LogArenaSnapshot, Warning, TEXT("Arena snapshot: nothing captured to restore"));
+		return false;
+	}
+
+	const double restoreStartTime = FPlatformTime::Seconds();
+
+	ClearTransientCombat();
+	RestoreEnemies();
+
+	if (ARSTestCharacter* player = _player.Get())
+	{
+		player->RestoreSnapshot(_playerSnapshot);
+	}
+
+	// Everyone has been moved, their old positions shouldn't be hit by rewound shots
+	if (AHitboxHistory* hitboxHistory = GetWorldManager<AHitboxHistory>(this, false))
+	{
+		hitboxHistory->ClearHistory();
+	}
+
+	const float restoreMs = (float)((FPlatformTime::Seconds() - restoreStartTime) * 1000.0);
+	_restoreMs.Add(restoreMs);
+	_restoreCount++;
+
+	UE_LOG(LogArenaSnapshot, Verbose, TEXT("Arena snapshot: restored in %.3f ms"), restoreMs);
+	return true;
+}
+
+void AArenaSnapshot::ClearTransientCombat()
+{
+	if (ADamageQueue* damageQueue = GetWorldManager<ADamageQueue>(this, false))
+	{
+		damageQueue->ClearQueue();
+	}
+
+	if (AAttackTokenDirector* attackDirector = GetWorldManager<AAttackTokenDirector>(this, false))
+	{
+		attackDirector->ClearQueue();
+	}
+
+	if (AProjectilePool* projectilePool = GetWorldManager<AProjectilePool>(this, false))
+	{
+		projectilePool->ReleaseAll();
+	}
+
+	if (AProjectileSimulationManager* projectileSimulation = GetWorldManager<AProjectileSimulationManager>(this, false))
+	{
+		projectileSimulation->ClearProjectiles();
+	}
+
+	// Spawned if need be, a spike can still be growing before the first one has been handed over to the manager
+	if (ASpikeManager* spikeManager = ASpikeManager::Get(this))
+	{
+		spikeManager->ClearSpikes();
+	}
+}
+
+void AArenaSnapshot::RestoreEnemies()
+{
+	AEnemyDirector* enemyDirector = GetWorldManager<AEnemyDirector>(this, false);
+
+	TSet<const ABaseEnemy*> capturedEnemies;
+	int32 missingCount = 0;
+	int32 blockedCount = 0;
+
+	for (const FEnemySnapshot& enemySnapshot : _enemies)
+	{
+		ABaseEnemy* enemy = enemySnapshot.Enemy.Get();
+		if (!enemy || enemy->IsPendingKill())
+		{
+			missingCount++;
+			continue;
+		}
+		capturedEnemies.Add(enemy);
+
+		const FVector location = enemySnapshot.Transform.GetLocation();
+		const FRotator rotation = enemySnapshot.Transform.Rotator();
+
+		// The director keeps its free lists, so pooled enemies are woken and put to sleep through it
+		if (enemy->GetIsPooled() && enemyDirector)
+		{
+			if (!enemySnapshot.IsActive)
+			{
+				enemyDirector->ReleaseEnemy(enemy);
+				continue;
+			}
+
+			if (!enemy->GetIsActiveInPool() && !enemyDirector->WakeEnemy(enemy, location, rotation))
+			{
+				blockedCount++;
+				continue;
+			}
+		}
+		else if (!enemySnapshot.IsActive)
+		{
+			if (!enemy->GetIsAsleep())
+			{
+				enemy->DeactivateToPool();
+			}
+			continue;
+		}
+		else if (enemy->GetIsAsleep() && !enemy->ActivateFromPool(location, rotation))
+		{
+			// Killed since the capture and put to sleep rather than destroyed
+			blockedCount++;
+			continue;
+		}
+
+		enemy->SetActorLocationAndRotation(location, rotation, false, nullptr, ETeleportType::TeleportPhysics);
+		enemy->GetCharacterMovement()->Velocity = enemySnapshot.Velocity;
+
+		enemy->LifeSystem->ResetHealth();
+		if (enemySnapshot.Health != enemy->LifeSystem->GetHealth())
+		{
+			enemy->LifeSystem->SetHealth(enemySnapshot.Health);
+		}
+
+		if (AAIController* aiController = Cast<AAIController>(enemy->GetController()))
+		{
+			aiController->StopMovement();
+			aiController->SetControlRotation(rotation);
+			LoadBlackboardValues(aiController->GetBlackboardComponent(), enemySnapshot.BlackboardValues);
+
+			// Whatever the tree was running is dropped, it starts over on the restored values
+			if (aiController->BrainComponent)
+			{
+				aiController->BrainComponent->RestartLogic();
+			}
+		}
+	}
+
+	// Enemies that came along after the capture: pooled ones go back to sleep, anything else is destroyed
+	for (TActorIterator<ABaseEnemy> it(GetWorld()); it; ++it)
+	{
+		ABaseEnemy* enemy = *it;
+		if (enemy->IsPendingKill() || capturedEnemies.Contains(enemy))
+		{
+			continue;
+		}
+
+		if (enemy->GetIsPooled())
+		{
+			if (enemyDirector)
+			{
+				enemyDirector->ReleaseEnemy(enemy);
+			}
+		}
+		else
+		{
+			if (AController* controller = enemy->GetController())
+			{
+				controller->Destroy();
+			}
+			enemy->Destroy();
+		}
+	}
+
+	// After the enemies, releasing the last awake one schedules a wave of its own
+	if (enemyDirector && enemyDirector == _enemyDirector.Get())
+	{
+		enemyDirector->RestoreWaveState(_waveState);
+	}
+
+	if (missingCount > 0 || blockedCount > 0)
+	{
+		UE_LOG(LogArenaSnapshot, Warning, TEXT("Arena snapshot: %d captured enemies have been destroyed since and %d couldn't be placed"), missingCount, blockedCount);
+	}
+}
+
+void AArenaSnapshot::OnPlayerDeath(ULifeSystem* lifeSystem)
+{
+	// Deaths are reported from inside the damage queue's flush, restoring has to wait until it's done
+	_restorePending = true;
+	UpdateTickEnabled();
+}
+
+void AArenaSnapshot::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (_waitingToCapture && GetIsWorldReady())
+	{
+		Capture();
+	}
+
+	if (_restorePending)
+	{
+		_restorePending = false;
+		Restore();
+	}
+
+	if (_episodesLeft > 0 && _hasSnapshot && GetWorld()->GetTimeSeconds() >= _nextEpisodeTime)
+	{
+		Restore();
+		_episodesLeft--;
+		_nextEpisodeTime = GetWorld()->GetTimeSeconds() + _episodeSeconds;
+
+		if (_episodesLeft == 0)
+		{
+			LogStats();
+
+			if (_quitWhenDone)
+			{
+				FPlatformMisc::RequestExit(false);
+			}
+		}
+	}
+
+	UpdateTickEnabled();
+}
+
+void AArenaSnapshot::UpdateTickEnabled()
+{
+	SetActorTickEnabled(_waitingToCapture || _restorePending || _episodesLeft > 0);
+}
+
+void AArenaSnapshot::LogStats() const
+{
+	float totalMs = 0.f;
+	float maxMs = 0.f;
+	for (float restoreMs : _restoreMs)
+	{
+		totalMs += restoreMs;
+		maxMs = FMath::Max(maxMs, restoreMs);
+	}
+
+	UE_LOG(LogArenaSnapshot, Log, TEXT("Arena snapshot: %s, %d enemies, %d restores, %.3f ms mean, %.3f ms max"),
+		_hasSnapshot ? TEXT("captured") : TEXT("nothing captured"), _enemies.Num(), _restoreCount,
+		_restoreMs.Num() > 0 ? totalMs / _restoreMs.Num() : 0.f, maxMs);
+}
@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "RSTestCharacter.h"
+#include "Systems/EnemyDirector.h"
+#include "ArenaSnapshot.generated.h"
+
+class ABaseEnemy;
+class ULifeSystem;
+
+/**
+ * Restarts the arena without reloading the map. Once the map has loaded (enemy pools filled, player spawned) the gameplay state
+ * is captured in memory: the player character, every enemy's transform, health, blackboard and whether it's awake, and the enemy
+ * director's wave progress. Restoring puts that back onto the same actors and clears everything transient - bullets, spikes,
+ * queued damage and attacks, the hitbox history - so a restart takes milliseconds. Captured enemies that aren't pooled are put to
+ * sleep when killed rather than destroyed, so they're there to wake. Server only, assumes there's only 1 player.
+ * RSTest.Snapshot.Capture and RSTest.Snapshot.Restore [Count] drive it from the console, -RSSnapshotEpisodes=<N> (with
+ * -RSSnapshotEpisodeSeconds=<Seconds>) restores it over and over from the command line and quits once done.
+ */
+UCLASS(config=Game, notplaceable)
+class RSTEST_API AArenaSnapshot : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AArenaSnapshot();
+
+	UFUNCTION(BlueprintPure, Category = "Arena Snapshot", meta = (WorldContext = "worldContextObject"))
+	static AArenaSnapshot* Get(const UObject* worldContextObject);
+
+	//Variables
+protected:
+	// Capture as soon as the map is ready, so there's always a snapshot to restart from
+	UPROPERTY(config, EditDefaultsOnly, Category = "Arena Snapshot Data")
+	bool _captureOnStart;
+
+	// Restore the frame after the player dies instead of leaving the restart to the death blueprint
+	UPROPERTY(config, EditDefaultsOnly, Category = "Arena Snapshot Data")
+	bool _restoreOnPlayerDeath;
+
+private:
+	struct FEnemySnapshot
+	{
+		TWeakObjectPtr<ABaseEnemy> Enemy;
+		FTransform Transform;
+		FVector Velocity;
+		float Health;
+		bool IsActive;
+
+		// Raw values of the keys that keep them in the blackboard's own memory, in key order
+		TArray<uint8> BlackboardValues;
+	};
+
+	TArray<FEnemySnapshot> _enemies;
+
+	TWeakObjectPtr<ARSTestCharacter> _player;
+	FRSTestCharacterSnapshot _playerSnapshot;
+	FDelegateHandle _playerDeathHandle;
+
+	TWeakObjectPtr<AEnemyDirector> _enemyDirector;
+	AEnemyDirector::FWaveState _waveState;
+
+	bool _hasSnapshot;
+	bool _waitingToCapture;
+	bool _restorePending;
+
+	// Episode loop
+	int32 _episodesLeft;
+	float _episodeSeconds;
+	float _nextEpisodeTime;
+	bool _quitWhenDone;
+
+	int32 _restoreCount;
+	TArray<float> _restoreMs;
+
+	//GettersAndSetters
+public:
+	UFUNCTION(BlueprintCallable, Category = "Arena Snapshot GetSet")
+	bool GetHasSnapshot() const { return _hasSnapshot; }
+
+	UFUNCTION(BlueprintCallable, Category = "Arena Snapshot GetSet")
+	int32 GetRestoreCount() const { return _restoreCount; }
+
+	//Functions
+public:
+	UFUNCTION(BlueprintCallable, Category = "Arena Snapshot")
+	void Capture();
+
+	// Returns false if nothing has been captured yet
+	UFUNCTION(BlueprintCallable, Category = "Arena Snapshot")
+	bool Restore();
+
+	// Captures once the enemy director has filled its pools and the player has spawned, right away if they already have
+	void CaptureWhenReady();
+
+	// Restores the snapshot every episodeSeconds, count times
+	void StartEpisodes(int32 count, float episodeSeconds, bool quitWhenDone);
+
+	void LogStats() const;
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	bool GetIsWorldReady() const;
+
+	void ClearTransientCombat();
+
+	void RestoreEnemies();
+
+	void OnPlayerDeath(ULifeSystem* lifeSystem);
+
+	void UpdateTickEnabled();
+};
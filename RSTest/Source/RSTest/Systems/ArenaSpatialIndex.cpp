@@ -0,0 +1,545 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ArenaSpatialIndex.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Components/PrimitiveComponent.h"
+#include "RSTest.h"
+#include "Environment/ArenaBuilder.h"
+#include "Systems/WorldManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogArenaIndex, Log, All);
+
+AArenaSpatialIndex::AArenaSpatialIndex()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+
+	_cellSize = 100.f;
+	_maxCellsPerAxis = 512;
+	_markLevelWallRunnable = true;
+
+	_gridWidth = 0;
+	_gridHeight = 0;
+	_isBuilt = false;
+}
+
+AArenaSpatialIndex* AArenaSpatialIndex::Get(const UObject* worldContextObject)
+{
+	return GetWorldManager<AArenaSpatialIndex>(worldContextObject);
+}
+
+void AArenaSpatialIndex::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Done whether or not anything is indexed, the wall run triggers only overlap the WallRunnable channel
+	if (_markLevelWallRunnable)
+	{
+		MarkLevelWallRunnable();
+	}
+
+	if (!_isBuilt)
+	{
+		Build();
+	}
+}
+
+void AArenaSpatialIndex::Build()
+{
+	const double buildStartTime = FPlatformTime::Seconds();
+
+	TArray<UClass*> floorTileClasses;
+	TArray<UClass*> wallClasses;
+	LoadArenaClasses(floorTileClasses, wallClasses);
+
+	_tileActors.Reset();
+	_wallActors.Reset();
+	_tileBounds.Reset();
+	_wallBounds.Reset();
+	_tileIndices.Reset();
+	_wallIndices.Reset();
+
+	FBox arenaBounds(ForceInit);
+	int32 dormantCount = 0;
+
+	for (TActorIterator<AActor> it(GetWorld()); it; ++it)
+	{
+		AActor* actor = *it;
+		const bool isFloorTile = floorTileClasses.ContainsByPredicate([actor](UClass* tileClass) { return actor->IsA(tileClass); });
+		const bool isWall = !isFloorTile && wallClasses.ContainsByPredicate([actor](UClass* wallClass) { return actor->IsA(wallClass); });
+		if (!isFloorTile && !isWall)
+		{
+			continue;
+		}
+
+		// The arena never changes once the map is loaded, replicated pieces are sent once and then left out of the server's
+		// per frame relevancy checks
+		if (actor->GetIsReplicated() && HasAuthority())
+		{
+			actor->SetNetDormancy(DORM_DormantAll);
+			dormantCount++;
+		}
+
+		FVector boundsOrigin;
+		FVector boundsExtent;
+		actor->GetActorBounds(true, boundsOrigin, boundsExtent);
+		const FBox actorBounds(boundsOrigin - boundsExtent, boundsOrigin + boundsExtent);
+		arenaBounds += actorBounds;
+
+		if (isFloorTile)
+		{
+			_tileActors.Add(actor);
+			_tileIndices.Add(INDEX_NONE);
+			_tileBounds.Add(actorBounds);
+		}
+		else
+		{
+			_wallActors.Add(actor);
+			_wallIndices.Add(INDEX_NONE);
+			_wallBounds.Add(actorBounds);
+		}
+	}
+
+	for (TActorIterator<AArenaBuilder> it(GetWorld()); it; ++it)
+	{
+		AArenaBuilder* arenaBuilder = *it;
+
+		for (int32 tileIndex = 0; tileIndex < arenaBuilder->GetTileCount(); tileIndex++)
+		{
+			const FBox& bounds = arenaBuilder->GetTileBounds(tileIndex);
+			if (!bounds.IsValid)
+			{
+				continue;
+			}
+			arenaBounds += bounds;
+
+			if (arenaBuilder->GetTileIsWall(tileIndex))
+			{
+				_wallActors.Add(arenaBuilder);
+				_wallIndices.Add(tileIndex);
+				_wallBounds.Add(bounds);
+			}
+			else
+			{
+				_tileActors.Add(arenaBuilder);
+				_tileIndices.Add(tileIndex);
+				_tileBounds.Add(bounds);
+			}
+		}
+	}
+
+	if (!arenaBounds.IsValid)
+	{
+		_gridWidth = _gridHeight = 0;
+		_isBuilt = true;
+		return;
+	}
+
+	_gridOrigin = FVector2D(arenaBounds.Min.X, arenaBounds.Min.Y);
+	_gridWidth = FMath::Clamp(FMath::CeilToInt((arenaBounds.Max.X - arenaBounds.Min.X) / _cellSize), 1, _maxCellsPerAxis);
+	_gridHeight = FMath::Clamp(FMath::CeilToInt((arenaBounds.Max.Y - arenaBounds.Min.Y) / _cellSize), 1, _maxCellsPerAxis);
+
+	const int32 cellCount = _gridWidth * _gridHeight;
+	_cellTile.Init(INDEX_NONE, cellCount);
+	_cellTileTopZ.Init(-MAX_FLT, cellCount);
+	_cellWall.Init(INDEX_NONE, cellCount);
+
+	// Shrink a little so a tile doesn't claim the neighbouring cells it only touches
+	const FVector cellInset(_cellSize * 0.05f, _cellSize * 0.05f, 0.f);
+
+	for (int32 tileIndex = 0; tileIndex < _tileBounds.Num(); tileIndex++)
+	{
+		int32 minX, minY, maxX, maxY;
+		GetCell(_tileBounds[tileIndex].Min + cellInset, minX, minY);
+		GetCell(_tileBounds[tileIndex].Max - cellInset, maxX, maxY);
+		for (int32 y = minY; y <= maxY; y++)
+		{
+			for (int32 x = minX; x <= maxX; x++)
+			{
+				const int32 cell = GetCellIndex(x, y);
+				if (_tileBounds[tileIndex].Max.Z > _cellTileTopZ[cell])
+				{
+					_cellTile[cell] = tileIndex;
+					_cellTileTopZ[cell] = _tileBounds[tileIndex].Max.Z;
+				}
+			}
+		}
+	}
+
+	for (int32 wallIndex = 0; wallIndex < _wallBounds.Num(); wallIndex++)
+	{
+		int32 minX, minY, maxX, maxY;
+		GetCell(_wallBounds[wallIndex].Min + cellInset, minX, minY);
+		GetCell(_wallBounds[wallIndex].Max - cellInset, maxX, maxY);
+		for (int32 y = minY; y <= maxY; y++)
+		{
+			for (int32 x = minX; x <= maxX; x++)
+			{
+				const int32 cell = GetCellIndex(x, y);
+				if (_cellWall[cell] == INDEX_NONE)
+				{
+					_cellWall[cell] = wallIndex;
+				}
+			}
+		}
+	}
+
+	BuildNearestWalls();
+	BuildCellLists(_tileBounds, _cellTileListStart, _cellTileList);
+	BuildCellLists(_wallBounds, _cellWallListStart, _cellWallList);
+	_isBuilt = true;
+
+	UE_LOG(LogArenaIndex, Log, TEXT("Arena index built: %dx%d cells, %d tiles, %d walls (%d replicated ones made dormant) in %.2f ms"),
+		_gridWidth, _gridHeight, _tileActors.Num(), _wallActors.Num(), dormantCount, (FPlatformTime::Seconds() - buildStartTime) * 1000.0);
+}
+
+void AArenaSpatialIndex::LoadArenaClasses(TArray<UClass*>& outFloorTileClasses, TArray<UClass*>& outWallClasses) const
+{
+	for (const FSoftClassPath& classPath : _floorTileClasses)
+	{
+		if (UClass* tileClass = classPath.TryLoadClass<AActor>())
+		{
+			outFloorTileClasses.Add(tileClass);
+		}
+	}
+
+	for (const FSoftClassPath& classPath : _wallClasses)
+	{
+		if (UClass* wallClass = classPath.TryLoadClass<AActor>())
+		{
+			outWallClasses.Add(wallClass);
+		}
+	}
+}
+
+void AArenaSpatialIndex::MarkLevelWallRunnable() const
+{
+	// The same actors the wall run triggers used to filter for, everything else in the level keeps its object type
+	TArray<UClass*> arenaClasses;
+	LoadArenaClasses(arenaClasses, arenaClasses);
+	arenaClasses.Add(AArenaBuilder::StaticClass());
+
+	int32 markedCount = 0;
+	for (TActorIterator<AActor> it(GetWorld()); it; ++it)
+	{
+		AActor* actor = *it;
+		if (!arenaClasses.ContainsByPredicate([actor](UClass* arenaClass) { return actor->IsA(arenaClass); }))
+		{
+			continue;
+		}
+
+		TInlineComponentArray<UPrimitiveComponent*> primitiveComponents(actor);
+		for (UPrimitiveComponent* primitiveComponent : primitiveComponents)
+		{
+			// Only what the old OverlapAll triggers could overlap
+			if (primitiveComponent->IsCollisionEnabled() && primitiveComponent->bGenerateOverlapEvents &&
+				primitiveComponent->GetCollisionObjectType() != ECC_WallRunnable)
+			{
+				primitiveComponent->SetCollisionObjectType(ECC_WallRunnable);
+				markedCount++;
+			}
+		}
+	}
+
+	UE_LOG(LogArenaIndex, Log, TEXT("Moved %d arena components onto the WallRunnable channel"), markedCount);
+}
+
+// Counted first and then filled, so the lists end up in two flat arrays rather than an array per cell
+void AArenaSpatialIndex::BuildCellLists(const TArray<FBox>& boxes, TArray<int32>& outListStart, TArray<int32>& outList) const
+{
+	const int32 cellCount = _gridWidth * _gridHeight;
+	outListStart.Init(0, cellCount + 1);
+
+	// Not inset like the top tile and first wall are, a point just inside a box's edge has to find it
+	auto getCellRange = [this](const FBox& box, int32& outMinX, int32& outMinY, int32& outMaxX, int32& outMaxY)
+	{
+		GetCell(box.Min, outMinX, outMinY);
+		GetCell(box.Max, outMaxX, outMaxY);
+	};
+
+	int32 minX, minY, maxX, maxY;
+	for (const FBox& box : boxes)
+	{
+		getCellRange(box, minX, minY, maxX, maxY);
+		for (int32 y = minY; y <= maxY; y++)
+		{
+			for (int32 x = minX; x <= maxX; x++)
+			{
+				outListStart[GetCellIndex(x, y) + 1]++;
+			}
+		}
+	}
+	for (int32 cell = 0; cell < cellCount; cell++)
+	{
+		outListStart[cell + 1] += outListStart[cell];
+	}
+
+	outList.SetNumUninitialized(outListStart[cellCount]);
+	TArray<int32> nextSlot(outListStart.GetData(), cellCount);
+	for (int32 boxIndex = 0; boxIndex < boxes.Num(); boxIndex++)
+	{
+		getCellRange(boxes[boxIndex], minX, minY, maxX, maxY);
+		for (int32 y = minY; y <= maxY; y++)
+		{
+			for (int32 x = minX; x <= maxX; x++)
+			{
+				outList[nextSlot[GetCellIndex(x, y)]++] = boxIndex;
+			}
+		}
+	}
+}
+
+bool AArenaSpatialIndex::GetHasTileAbove(int32 x, int32 y, EArenaDirection direction, float distance, float z) const
+{
+	int32 stepX = 0, stepY = 0;
+	switch (direction)
+	{
+	case EArenaDirection::AD_PositiveX: stepX = 1; break;
+	case EArenaDirection::AD_NegativeX: stepX = -1; break;
+	case EArenaDirection::AD_PositiveY: stepY = 1; break;
+	case EArenaDirection::AD_NegativeY: stepY = -1; break;
+	}
+
+	// The start cell too, and the one the distance ends in
+	const int32 cellSteps = FMath::CeilToInt(distance / _cellSize) + 1;
+	for (int32 step = 0; step <= cellSteps; step++)
+	{
+		if (x < 0 || y < 0 || x >= _gridWidth || y >= _gridHeight)
+		{
+			break;
+		}
+		if (_cellTileTopZ[GetCellIndex(x, y)] > z)
+		{
+			return true;
+		}
+		x += stepX;
+		y += stepY;
+	}
+	return false;
+}
+
+// One sweep per row/column and direction, carrying the last wall seen along
+void AArenaSpatialIndex::BuildNearestWalls()
+{
+	const int32 cellCount = _gridWidth * _gridHeight;
+	_nearestWall.Init(INDEX_NONE, cellCount * kDirectionCount);
+	_nearestWallDistance.Init(MAX_FLT, cellCount * kDirectionCount);
+
+	auto storeNearest = [this](int32 x, int32 y, EArenaDirection direction, int32& carriedWall)
+	{
+		const int32 cell = GetCellIndex(x, y);
+		if (_cellWall[cell] != INDEX_NONE)
+		{
+			carriedWall = _cellWall[cell];
+		}
+
+		const int32 slot = cell * kDirectionCount + (int32)direction;
+		_nearestWall[slot] = carriedWall;
+		if (carriedWall != INDEX_NONE)
+		{
+			const FBox& wallBounds = _wallBounds[carriedWall];
+			const FVector2D cellCentre = _gridOrigin + FVector2D((x + 0.5f) * _cellSize, (y + 0.5f) * _cellSize);
+			float distance = 0.f;
+			switch (direction)
+			{
+			case EArenaDirection::AD_PositiveX: distance = wallBounds.Min.X - cellCentre.X; break;
+			case EArenaDirection::AD_NegativeX: distance = cellCentre.X - wallBounds.Max.X; break;
+			case EArenaDirection::AD_PositiveY: distance = wallBounds.Min.Y - cellCentre.Y; break;
+			case EArenaDirection::AD_NegativeY: distance = cellCentre.Y - wallBounds.Max.Y; break;
+			}
+			_nearestWallDistance[slot] = FMath::Max(distance, 0.f);
+		}
+	};
+
+	for (int32 y = 0; y < _gridHeight; y++)
+	{
+		int32 carriedWall = INDEX_NONE;
+		for (int32 x = _gridWidth - 1; x >= 0; x--)
+		{
+			storeNearest(x, y, EArenaDirection::AD_PositiveX, carriedWall);
+		}
+
+		carriedWall = INDEX_NONE;
+		for (int32 x = 0; x < _gridWidth; x++)
+		{
+			storeNearest(x, y, EArenaDirection::AD_NegativeX, carriedWall);
+		}
+	}
+
+	for (int32 x = 0; x < _gridWidth; x++)
+	{
+		int32 carriedWall = INDEX_NONE;
+		for (int32 y = _gridHeight - 1; y >= 0; y--)
+		{
+			storeNearest(x, y, EArenaDirection::AD_PositiveY, carriedWall);
+		}
+
+		carriedWall = INDEX_NONE;
+		for (int32 y = 0; y < _gridHeight; y++)
+		{
+			storeNearest(x, y, EArenaDirection::AD_NegativeY, carriedWall);
+		}
+	}
+}
+
+bool AArenaSpatialIndex::GetCell(const FVector& location, int32& outX, int32& outY) const
+{
+	const int32 x = FMath::FloorToInt((location.X - _gridOrigin.X) / _cellSize);
+	const int32 y = FMath::FloorToInt((location.Y - _gridOrigin.Y) / _cellSize);
+
+	outX = FMath::Clamp(x, 0, FMath::Max(_gridWidth - 1, 0));
+	outY = FMath::Clamp(y, 0, FMath::Max(_gridHeight - 1, 0));
+
+	return x >= 0 && x < _gridWidth && y >= 0 && y < _gridHeight;
+}
+
+bool AArenaSpatialIndex::GetTileUnder(const FVector& location, AActor*& outTile, float& outTileTopZ) const
+{
+	int32 tileIndex;
+	return GetArenaTileUnder(location, outTile, tileIndex, outTileTopZ);
+}
+
+bool AArenaSpatialIndex::GetArenaTileUnder(const FVector& location, AActor*& outTile, int32& outTileIndex, float& outTileTopZ) const
+{
+	outTile = nullptr;
+	outTileIndex = INDEX_NONE;
+	outTileTopZ = 0.f;
+
+	int32 x, y;
+	if (!_isBuilt || !GetCell(location, x, y))
+	{
+		return false;
+	}
+
+	const int32 cell = GetCellIndex(x, y);
+	if (_cellTile[cell] == INDEX_NONE)
+	{
+		return false;
+	}
+
+	outTile = _tileActors[_cellTile[cell]].Get();
+	outTileIndex = _tileIndices[_cellTile[cell]];
+	outTileTopZ = _cellTileTopZ[cell];
+	return outTile != nullptr;
+}
+
+bool AArenaSpatialIndex::FindNearestWall(const FVector& location, EArenaDirection direction, float maxDistance, bool& outHasWall, FVector& outWallLocation, AActor*& outWall) const
+{
+	outHasWall = false;
+	outWallLocation = location;
+	outWall = nullptr;
+
+	int32 x, y;
+	if (!_isBuilt || !GetCell(location, x, y))
+	{
+		return false;
+	}
+
+	const int32 slot = GetCellIndex(x, y) * kDirectionCount + (int32)direction;
+	const int32 wallIndex = _nearestWall[slot];
+	if (wallIndex == INDEX_NONE || _nearestWallDistance[slot] > maxDistance + _cellSize)
+	{
+		// Nothing static within reach that way, unless a raised tile is
+		return !GetHasTileAbove(x, y, direction, maxDistance, location.Z);
+	}
+
+	const FBox& wallBounds = _wallBounds[wallIndex];
+	AActor* wall = _wallActors[wallIndex].Get();
+	if (!wall || location.Z < wallBounds.Min.Z || location.Z > wallBounds.Max.Z)
+	{
+		return false;
+	}
+
+	// A cell only keeps one wall, which may only cover part of it and not reach across to the ray
+	const bool alongX = direction == EArenaDirection::AD_PositiveX || direction == EArenaDirection::AD_NegativeX;
+	const float across = alongX ? location.Y : location.X;
+	if (across < (alongX ? wallBounds.Min.Y : wallBounds.Min.X) || across > (alongX ? wallBounds.Max.Y : wallBounds.Max.X))
+	{
+		return false;
+	}
+
+	// Distance from the actual query point rather than the cell centre
+	float distance = 0.f;
+	FVector wallDirection = FVector::ZeroVector;
+	switch (direction)
+	{
+	case EArenaDirection::AD_PositiveX: distance = wallBounds.Min.X - location.X; wallDirection = FVector::ForwardVector; break;
+	case EArenaDirection::AD_NegativeX: distance = location.X - wallBounds.Max.X; wallDirection = -FVector::ForwardVector; break;
+	case EArenaDirection::AD_PositiveY: distance = wallBounds.Min.Y - location.Y; wallDirection = FVector::RightVector; break;
+	case EArenaDirection::AD_NegativeY: distance = location.Y - wallBounds.Max.Y; wallDirection = -FVector::RightVector; break;
+	}
+
+	if (distance < 0.f)
+	{
+		return false; // Inside the wall's bounds, let a trace sort it out
+	}
+
+	if (GetHasTileAbove(x, y, direction, FMath::Min(distance, maxDistance), location.Z))
+	{
+		return false; // Something on the floor is in the way first
+	}
+
+	if (distance <= maxDistance)
+	{
+		outHasWall = true;
+		outWallLocation = location + wallDirection * distance;
+		outWall = wall;
+	}
+	return true;
+}
+
+int32 AArenaSpatialIndex::GetArenaTileAt(const FVector& location, const AActor* arenaBuilder) const
+{
+	int32 x, y;
+	if (!_isBuilt || !GetCell(location, x, y))
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 cell = GetCellIndex(x, y);
+	for (int32 slot = _cellWallListStart[cell]; slot < _cellWallListStart[cell + 1]; slot++)
+	{
+		const int32 wallIndex = _cellWallList[slot];
+		if (_wallActors[wallIndex].Get() == arenaBuilder && _wallBounds[wallIndex].IsInsideOrOn(location))
+		{
+			return _wallIndices[wallIndex];
+		}
+	}
+	for (int32 slot = _cellTileListStart[cell]; slot < _cellTileListStart[cell + 1]; slot++)
+	{
+		const int32 tileIndex = _cellTileList[slot];
+		if (_tileActors[tileIndex].Get() == arenaBuilder && _tileBounds[tileIndex].IsInsideOrOn(location))
+		{
+			return _tileIndices[tileIndex];
+		}
+	}
+	return INDEX_NONE;
+}
+
+bool AArenaSpatialIndex::GetArenaDirection(const FVector& direction, EArenaDirection& outDirection)
+{
+	if (direction.Equals(FVector::ForwardVector))
+	{
+		outDirection = EArenaDirection::AD_PositiveX;
+	}
+	else if (direction.Equals(-FVector::ForwardVector))
+	{
+		outDirection = EArenaDirection::AD_NegativeX;
+	}
+	else if (direction.Equals(FVector::RightVector))
+	{
+		outDirection = EArenaDirection::AD_PositiveY;
+	}
+	else if (direction.Equals(-FVector::RightVector))
+	{
+		outDirection = EArenaDirection::AD_NegativeY;
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
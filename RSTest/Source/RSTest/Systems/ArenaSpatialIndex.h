@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "ArenaSpatialIndex.generated.h"
+
+UENUM(BlueprintType)
+enum class EArenaDirection : uint8
+{
+	AD_PositiveX 	UMETA(DisplayName = "+X"),
+	AD_NegativeX 	UMETA(DisplayName = "-X"),
+	AD_PositiveY 	UMETA(DisplayName = "+Y"),
+	AD_NegativeY 	UMETA(DisplayName = "-Y"),
+};
+
+/**
+ * A 2D grid over the arena's floor tiles and walls, built once when the map starts. Tiles are either placed actors of the
+ * configured classes or tiles in an AArenaBuilder, which are told apart by their index in the builder.
+ * Every cell knows the tile under it, that tile's height and the nearest wall in each axis direction,
+ * so enemy surface queries become lookups. Anything that isn't a placed tile or wall (spikes, other actors) isn't in here.
+ */
+UCLASS(config=Game, notplaceable)
+class RSTEST_API AArenaSpatialIndex : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AArenaSpatialIndex();
+
+	UFUNCTION(BlueprintPure, Category = "Arena Index", meta = (WorldContext = "worldContextObject"))
+	static AArenaSpatialIndex* Get(const UObject* worldContextObject);
+
+	//Variables
+protected:
+	UPROPERTY(config, EditDefaultsOnly, Category = "Arena Index Data")
+	TArray<FSoftClassPath> _floorTileClasses;
+
+	UPROPERTY(config, EditDefaultsOnly, Category = "Arena Index Data")
+	TArray<FSoftClassPath> _wallClasses;
+
+	UPROPERTY(config, EditDefaultsOnly, Category = "Arena Index Data", meta = (ClampMin = 1))
+	float _cellSize;
+
+	// Safety limit on either grid dimension
+	UPROPERTY(config, EditDefaultsOnly, Category = "Arena Index Data", meta = (ClampMin = 1))
+	int32 _maxCellsPerAxis;
+
+	// Moves the colliding, overlap-generating components of the configured tile and wall classes and of arena builders onto
+	// the WallRunnable object channel when the map starts, those are the surfaces the wall run triggers used to count
+	UPROPERTY(config, EditDefaultsOnly, Category = "Arena Index Data")
+	bool _markLevelWallRunnable;
+
+private:
+	static const int32 kDirectionCount = 4;
+
+	FVector2D _gridOrigin;
+	int32 _gridWidth;
+	int32 _gridHeight;
+
+	bool _isBuilt;
+
+	// Per cell, flattened as y * _gridWidth + x
+	TArray<int32> _cellTile;
+	TArray<float> _cellTileTopZ;
+	TArray<int32> _cellWall;
+
+	// Per cell and direction, flattened as cell * kDirectionCount + direction
+	TArray<int32> _nearestWall;
+	TArray<float> _nearestWallDistance;
+
+	// Every tile and wall touching each cell, not just the top tile and first wall, so stacked wall tiles can be told apart.
+	// Cell c's entries are [start[c], start[c + 1])
+	TArray<int32> _cellTileListStart;
+	TArray<int32> _cellTileList;
+	TArray<int32> _cellWallListStart;
+	TArray<int32> _cellWallList;
+
+	TArray<TWeakObjectPtr<AActor>> _tileActors;
+	TArray<TWeakObjectPtr<AActor>> _wallActors;
+	TArray<FBox> _tileBounds;
+	TArray<FBox> _wallBounds;
+
+	// Tile index in the owning arena builder, INDEX_NONE for placed tile actors
+	TArray<int32> _tileIndices;
+	TArray<int32> _wallIndices;
+
+	//GettersAndSetters
+public:
+	UFUNCTION(BlueprintCallable, Category = "Arena Index GetSet")
+	bool GetIsBuilt() const { return _isBuilt; }
+
+	const TArray<TWeakObjectPtr<AActor>>& GetTileActors() const { return _tileActors; }
+
+	const TArray<TWeakObjectPtr<AActor>>& GetWallActors() const { return _wallActors; }
+
+	//Functions
+public:
+	// Scans the level for tiles and walls, safe to call again if the arena changes
+	UFUNCTION(BlueprintCallable, Category = "Arena Index")
+	void Build();
+
+	// The highest floor tile in the cell containing location
+	UFUNCTION(BlueprintCallable, Category = "Arena Index")
+	bool GetTileUnder(const FVector& location, AActor*& outTile, float& outTileTopZ) const;
+
+	// Same as GetTileUnder, outTileIndex is the tile's index in its arena builder (INDEX_NONE for a placed tile actor)
+	UFUNCTION(BlueprintCallable, Category = "Arena Index")
+	bool GetArenaTileUnder(const FVector& location, AActor*& outTile, int32& outTileIndex, float& outTileTopZ) const;
+
+	// Where a ray from location along the given axis would first meet a wall. Returns false if the index can't answer
+	// (outside the grid, the wall doesn't span location's height or width, or a tile on the way rises above location) and
+	// the caller should trace instead
+	UFUNCTION(BlueprintCallable, Category = "Arena Index")
+	bool FindNearestWall(const FVector& location, EArenaDirection direction, float maxDistance, bool& outHasWall, FVector& outWallLocation, AActor*& outWall) const;
+
+	// Index in arenaBuilder of its tile or wall whose bounds contain location, INDEX_NONE if none of them do
+	int32 GetArenaTileAt(const FVector& location, const AActor* arenaBuilder) const;
+
+	// Maps a direction vector onto one of the indexed axes, false for anything else
+	static bool GetArenaDirection(const FVector& direction, EArenaDirection& outDirection);
+
+protected:
+	virtual void BeginPlay() override;
+
+	bool GetCell(const FVector& location, int32& outX, int32& outY) const;
+
+	int32 GetCellIndex(int32 x, int32 y) const { return y * _gridWidth + x; }
+
+	void BuildNearestWalls();
+
+	// Fills outListStart and outList with which of the boxes touch each cell
+	void BuildCellLists(const TArray<FBox>& boxes, TArray<int32>& outListStart, TArray<int32>& outList) const;
+
+	// Whether any tile top in the cells from (x, y) along direction for distance is above z
+	bool GetHasTileAbove(int32 x, int32 y, EArenaDirection direction, float distance, float z) const;
+
+	// Loads the configured classes, both lists can be the same array
+	void LoadArenaClasses(TArray<UClass*>& outFloorTileClasses, TArray<UClass*>& outWallClasses) const;
+
+	void MarkLevelWallRunnable() const;
+};
@@ -0,0 +1,193 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetPreloader.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Enemies/BaseEnemy.h"
+#include "Systems/WorldManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAssetPreloader, Log, All);
+
+static FAutoConsoleCommandWithWorld GAssetPreloaderStatsCommand(
+	TEXT("RSTest.Preload.Stats"),
+	TEXT("Logs every preload group of the current world and how long it took to stream"),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* world)
+	{
+		if (AAssetPreloader* preloader = GetWorldManager<AAssetPreloader>(world, false))
+		{
+			preloader->LogStats();
+		}
+	})
+);
+
+AAssetPreloader::AAssetPreloader()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+}
+
+AAssetPreloader* AAssetPreloader::Get(const UObject* worldContextObject)
+{
+	return GetWorldManager<AAssetPreloader>(worldContextObject);
+}
+
+bool AAssetPreloader::GetIsGroupLoaded(FName groupName) const
+{
+	const FPreloadGroup* group = _groups.FindByPredicate([groupName](const FPreloadGroup& preloadGroup) { return preloadGroup.Name == groupName; });
+	return group && group->LoadTime >= 0.f;
+}
+
+AAssetPreloader::FPreloadGroup* AAssetPreloader::FindGroup(FName groupName)
+{
+	return _groups.FindByPredicate([groupName](const FPreloadGroup& preloadGroup) { return preloadGroup.Name == groupName; });
+}
+
+void AAssetPreloader::PreloadGroup(FName groupName, const TArray<FSoftObjectPath>& assets, FStreamableDelegate onLoaded)
+{
+	if (FPreloadGroup* existingGroup = FindGroup(groupName))
+	{
+		if (existingGroup->LoadTime >= 0.f)
+		{
+			onLoaded.ExecuteIfBound();
+		}
+		else if (onLoaded.IsBound())
+		{
+			existingGroup->Waiting.Add(onLoaded);
+		}
+		return;
+	}
+
+	FPreloadGroup newGroup;
+	newGroup.Name = groupName;
+	newGroup.AssetCount = 0;
+	newGroup.StartTime = FPlatformTime::Seconds();
+	newGroup.LoadTime = -1.f;
+	if (onLoaded.IsBound())
+	{
+		newGroup.Waiting.Add(onLoaded);
+	}
+
+	TArray<FSoftObjectPath> validAssets;
+	for (const FSoftObjectPath& asset : assets)
+	{
+		if (asset.IsValid())
+		{
+			validAssets.AddUnique(asset);
+		}
+	}
+	newGroup.AssetCount = validAssets.Num();
+
+	// Added before the request because the streamable manager may complete straight away if everything is already in memory
+	_groups.Add(newGroup);
+
+	if (validAssets.Num() == 0)
+	{
+		OnGroupLoaded(groupName);
+		return;
+	}
+
+	TSharedPtr<FStreamableHandle> handle = _streamableManager.RequestAsyncLoad(
+		validAssets,
+		FStreamableDelegate::CreateUObject(this, &AAssetPreloader::OnGroupLoaded, groupName),
+		FStreamableManager::DefaultAsyncLoadPriority,
+		false,
+		false,
+		groupName.ToString()
+	);
+
+	if (FPreloadGroup* group = FindGroup(groupName))
+	{
+		group->Handle = handle;
+	}
+}
+
+void AAssetPreloader::OnGroupLoaded(FName groupName)
+{
+	FPreloadGroup* group = FindGroup(groupName);
+	if (!group || group->LoadTime >= 0.f)
+	{
+		return;
+	}
+
+	group->LoadTime = (float)((FPlatformTime::Seconds() - group->StartTime) * 1000.0);
+	UE_LOG(LogAssetPreloader, Log, TEXT("Streamed group %s: %d assets in %.2f ms"), *groupName.ToString(), group->AssetCount, group->LoadTime);
+
+	// The delegates can start new groups, which may reallocate _groups
+	TArray<FStreamableDelegate> waiting = MoveTemp(group->Waiting);
+	for (FStreamableDelegate& delegate : waiting)
+	{
+		delegate.ExecuteIfBound();
+	}
+}
+
+void AAssetPreloader::PreloadEnemyClass(TSubclassOf<ABaseEnemy> enemyClass)
+{
+	if (!enemyClass || _preloadedEnemyClasses.Contains(enemyClass->GetFName()))
+	{
+		return;
+	}
+	_preloadedEnemyClasses.Add(enemyClass->GetFName());
+
+	TArray<FSoftObjectPath> assets;
+	enemyClass->GetDefaultObject<ABaseEnemy>()->GatherPreloadAssets(assets);
+	PreloadGroup(enemyClass->GetFName(), assets);
+}
+
+void AAssetPreloader::PreloadWorldManifest()
+{
+	for (TActorIterator<ABaseEnemy> it(GetWorld()); it; ++it)
+	{
+		PreloadEnemyClass(it->GetClass());
+	}
+
+	// Manifest classes have to be streamed in themselves before they can say what they need
+	TArray<FSoftObjectPath> manifestClasses;
+	for (const FSoftClassPath& classPath : _manifestEnemyClasses)
+	{
+		manifestClasses.Add(classPath);
+	}
+	PreloadGroup(TEXT("EnemyManifest"), manifestClasses, FStreamableDelegate::CreateUObject(this, &AAssetPreloader::OnManifestClassesLoaded));
+}
+
+void AAssetPreloader::OnManifestClassesLoaded()
+{
+	for (const FSoftClassPath& classPath : _manifestEnemyClasses)
+	{
+		PreloadEnemyClass(classPath.ResolveClass());
+	}
+}
+
+void AAssetPreloader::LogStats() const
+{
+	for (const FPreloadGroup& group : _groups)
+	{
+		if (group.LoadTime >= 0.f)
+		{
+			UE_LOG(LogAssetPreloader, Log, TEXT("%s: %d assets, %.2f ms"), *group.Name.ToString(), group.AssetCount, group.LoadTime);
+		}
+		else
+		{
+			UE_LOG(LogAssetPreloader, Log, TEXT("%s: %d assets, still streaming (%.2f ms so far)"), *group.Name.ToString(), group.AssetCount, (FPlatformTime::Seconds() - group.StartTime) * 1000.0);
+		}
+	}
+}
+
+void AAssetPreloader::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	LogStats();
+
+	// Let the streamed assets be collected along with the world
+	for (FPreloadGroup& group : _groups)
+	{
+		if (group.Handle.IsValid())
+		{
+			group.Handle->ReleaseHandle();
+		}
+	}
+	_groups.Empty();
+
+	Super::EndPlay(EndPlayReason);
+}
@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Engine/StreamableManager.h"
+#include "AssetPreloader.generated.h"
+
+class ABaseEnemy;
+
+/**
+ * Streams soft-referenced assets in named groups so nothing is loaded just because a class default object exists.
+ * At map start it preloads what every enemy in the level, plus the configured manifest, says it needs,
+ * and logs how long each group took. One per world, get it through AAssetPreloader::Get.
+ * Place one in a map to give that map its own manifest, otherwise one is spawned using the config defaults.
+ */
+UCLASS(config=Game)
+class RSTEST_API AAssetPreloader : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AAssetPreloader();
+
+	static AAssetPreloader* Get(const UObject* worldContextObject);
+
+	//Variables
+protected:
+	// Enemies that aren't placed in the map but can be spawned into it later
+	UPROPERTY(config, EditAnywhere, Category = "Asset Preloader Data")
+	TArray<FSoftClassPath> _manifestEnemyClasses;
+
+private:
+	struct FPreloadGroup
+	{
+		FName Name;
+		TSharedPtr<FStreamableHandle> Handle;
+		TArray<FStreamableDelegate> Waiting;
+		int32 AssetCount;
+		double StartTime;
+		float LoadTime; // Negative while still streaming
+	};
+
+	FStreamableManager _streamableManager;
+
+	TArray<FPreloadGroup> _groups;
+
+	TSet<FName> _preloadedEnemyClasses;
+
+	//GettersAndSetters
+public:
+	bool GetIsGroupLoaded(FName groupName) const;
+
+	//Functions
+public:
+	// Starts streaming assets as one group, onLoaded runs once they're all in. Asking for a group that already exists just waits on it
+	void PreloadGroup(FName groupName, const TArray<FSoftObjectPath>& assets, FStreamableDelegate onLoaded = FStreamableDelegate());
+
+	// Preloads whatever the enemy class reports through GatherPreloadAssets, once per class
+	void PreloadEnemyClass(TSubclassOf<ABaseEnemy> enemyClass);
+
+	// Enemies placed in the level plus _manifestEnemyClasses
+	void PreloadWorldManifest();
+
+	void LogStats() const;
+
+protected:
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	FPreloadGroup* FindGroup(FName groupName);
+
+	void OnGroupLoaded(FName groupName);
+
+	void OnManifestClassesLoaded();
+};
@@ -0,0 +1,244 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AttackTokenDirector.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Enemies/BaseEnemy.h"
+#include "Systems/VisibilityService.h"
+#include "Systems/WorldManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAttackTokens, Log, All);
+
+static FAutoConsoleCommandWithWorld GAttackTokenStatsCommand(
+	TEXT("RSTest.Attacks.Stats"),
+	TEXT("Logs queued, granted and dropped attacks for the attack token director of the current world"),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* world)
+	{
+		if (AAttackTokenDirector* director = GetWorldManager<AAttackTokenDirector>(world, false))
+		{
+			director->LogStats();
+		}
+	})
+);
+
+AAttackTokenDirector::AAttackTokenDirector()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false; // Only while attacks are queued
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+	bReplicates = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+
+	_tokensPerWindow = 6;
+	_windowSeconds = 1.f;
+	_maxGrantsPerFrame = 1;
+	_lineOfSightBonus = 1500.f;
+	_waitBonusPerSecond = 2000.f;
+	_maxWaitSeconds = 1.f;
+
+	_availableTokens = 0.f;
+	_lastRefillTime = 0.f;
+
+	_grantedCount = 0;
+	_droppedCount = 0;
+	_highWaterMark = 0;
+}
+
+AAttackTokenDirector* AAttackTokenDirector::Get(const UObject* worldContextObject)
+{
+	return GetWorldManager<AAttackTokenDirector>(worldContextObject);
+}
+
+void AAttackTokenDirector::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Config is only read after construction, start with a full window
+	_availableTokens = _tokensPerWindow;
+	_lastRefillTime = GetWorld()->GetTimeSeconds();
+}
+
+void AAttackTokenDirector::QueueAttack(ABaseEnemy* attacker, const FVector& attackLocation)
+{
+	if (!attacker)
+	{
+		return;
+	}
+
+	// The queue only ever holds the few attacks waiting on a token, a linear search beats keeping a map in sync
+	const int32 existingIndex = _attackers.IndexOfByKey(attacker);
+	if (existingIndex != INDEX_NONE)
+	{
+		_attackLocations[existingIndex] = attackLocation;
+		return;
+	}
+
+	_attackers.Add(attacker);
+	_attackLocations.Add(attackLocation);
+	_queueTimes.Add(GetWorld()->GetTimeSeconds());
+
+	_highWaterMark = FMath::Max(_highWaterMark, _attackers.Num());
+
+	SetActorTickEnabled(true);
+}
+
+void AAttackTokenDirector::CancelAttack(const ABaseEnemy* attacker)
+{
+	const int32 attackIndex = _attackers.IndexOfByKey(attacker);
+	if (attackIndex != INDEX_NONE)
+	{
+		RemoveAttackAtSwap(attackIndex);
+	}
+}
+
+void AAttackTokenDirector::ClearQueue()
+{
+	_attackers.Reset();
+	_attackLocations.Reset();
+	_queueTimes.Reset();
+
+	_availableTokens = _tokensPerWindow;
+	_lastRefillTime = GetWorld()->GetTimeSeconds();
+
+	SetActorTickEnabled(false);
+}
+
+void AAttackTokenDirector::SetTokensPerWindow(int32 tokensPerWindow)
+{
+	_tokensPerWindow = FMath::Max(1, tokensPerWindow);
+	_availableTokens = _tokensPerWindow;
+	_lastRefillTime = GetWorld()->GetTimeSeconds();
+}
+
+void AAttackTokenDirector::LogStats() const
+{
+	UE_LOG(LogAttackTokens, Log, TEXT("Attack tokens: %d queued (high water %d), %.1f tokens available, %llu granted, %llu dropped, %d per %.2fs and %d per frame"),
+		_attackers.Num(), _highWaterMark, _availableTokens, _grantedCount, _droppedCount, _tokensPerWindow, _windowSeconds, _maxGrantsPerFrame);
+}
+
+void AAttackTokenDirector::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const float worldTime = GetWorld()->GetTimeSeconds();
+
+	RefillTokens(worldTime);
+	RemoveExpiredAttacks(worldTime);
+
+	// Only needed when there's a token to hand out
+	if (_availableTokens >= 1.f && _attackers.Num() > 0)
+	{
+		GatherPlayerLocations();
+	}
+
+	int32 grantedThisFrame = 0;
+	while (grantedThisFrame < _maxGrantsPerFrame && _availableTokens >= 1.f && _attackers.Num() > 0)
+	{
+		const int32 attackIndex = FindBestAttack(worldTime);
+		ABaseEnemy* attacker = _attackers[attackIndex].Get();
+		const FVector attackLocation = _attackLocations[attackIndex];
+
+		// Removed first, the attack may well queue the next one
+		RemoveAttackAtSwap(attackIndex);
+
+		_availableTokens -= 1.f;
+		_grantedCount++;
+		grantedThisFrame++;
+
+		attacker->Attack(attackLocation);
+	}
+
+	if (_attackers.Num() == 0)
+	{
+		SetActorTickEnabled(false);
+	}
+}
+
+// Tokens come back at a steady rate rather than all at once when a window ends, so grants don't bunch up at window edges either
+void AAttackTokenDirector::RefillTokens(float worldTime)
+{
+	const float refillRate = _tokensPerWindow / _windowSeconds;
+	_availableTokens = FMath::Min((float)_tokensPerWindow, _availableTokens + (worldTime - _lastRefillTime) * refillRate);
+	_lastRefillTime = worldTime;
+}
+
+void AAttackTokenDirector::RemoveExpiredAttacks(float worldTime)
+{
+	for (int32 i = _attackers.Num() - 1; i >= 0; i--)
+	{
+		if (!_attackers[i].IsValid())
+		{
+			RemoveAttackAtSwap(i);
+		}
+		else if (worldTime - _queueTimes[i] > _maxWaitSeconds)
+		{
+			RemoveAttackAtSwap(i);
+			_droppedCount++;
+		}
+	}
+}
+
+void AAttackTokenDirector::GatherPlayerLocations()
+{
+	_playerLocations.Reset();
+	for (FConstPlayerControllerIterator it = GetWorld()->GetPlayerControllerIterator(); it; ++it)
+	{
+		const APlayerController* playerController = it->Get();
+		const APawn* playerPawn = playerController ? playerController->GetPawn() : nullptr;
+		if (playerPawn)
+		{
+			_playerLocations.Add(playerPawn->GetActorLocation());
+		}
+	}
+}
+
+int32 AAttackTokenDirector::FindBestAttack(float worldTime) const
+{
+	// Only a cached result is read, if the enemy hasn't asked the visibility service it just doesn't get the bonus
+	const AVisibilityService* visibilityService = GetWorldManager<AVisibilityService>(this, false);
+
+	int32 bestIndex = INDEX_NONE;
+	float bestScore = MAX_FLT;
+
+	const int32 attackCount = _attackers.Num();
+	for (int32 i = 0; i < attackCount; i++)
+	{
+		const ABaseEnemy* attacker = _attackers[i].Get();
+
+		const FVector attackerLocation = attacker->GetActorLocation();
+
+		// Without a player every attack scores the same on distance and they go in the order they waited
+		float closestDistSquared = _playerLocations.Num() > 0 ? MAX_FLT : 0.f;
+		for (const FVector& playerLocation : _playerLocations)
+		{
+			closestDistSquared = FMath::Min(closestDistSquared, FVector::DistSquared(attackerLocation, playerLocation));
+		}
+
+		float score = FMath::Sqrt(closestDistSquared) - (worldTime - _queueTimes[i]) * _waitBonusPerSecond;
+
+		bool canSee = false;
+		float resultAge = 0.f;
+		if (visibilityService && visibilityService->GetVisibility(attacker, canSee, resultAge) && canSee)
+		{
+			score -= _lineOfSightBonus;
+		}
+
+		if (score < bestScore)
+		{
+			bestScore = score;
+			bestIndex = i;
+		}
+	}
+
+	return bestIndex;
+}
+
+void AAttackTokenDirector::RemoveAttackAtSwap(int32 attackIndex)
+{
+	_attackers.RemoveAtSwap(attackIndex);
+	_attackLocations.RemoveAtSwap(attackIndex);
+	_queueTimes.RemoveAtSwap(attackIndex);
+}
@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "AttackTokenDirector.generated.h"
+
+class ABaseEnemy;
+
+/**
+ * Decides when enemy attacks actually happen. Enemies whose cooldown is up queue their attack here instead of running it,
+ * and each frame the director grants at most a few of them, picking the one closest to its nearest player first with line of
+ * sight and time spent waiting counting as extra closeness. Tokens refill at a fixed rate, so however many enemies are in the
+ * arena the attack work per frame and per second stays bounded. Attacks that wait too long are dropped.
+ */
+UCLASS(config=Game, notplaceable)
+class RSTEST_API AAttackTokenDirector : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AAttackTokenDirector();
+
+	static AAttackTokenDirector* Get(const UObject* worldContextObject);
+
+	//Variables
+protected:
+	// Attacks granted per window at most, also how many can be saved up while nobody is asking
+	UPROPERTY(config, EditDefaultsOnly, Category = "Attack Token Data", meta = (ClampMin = 1))
+	int32 _tokensPerWindow;
+
+	UPROPERTY(config, EditDefaultsOnly, Category = "Attack Token Data", meta = (ClampMin = 0.1))
+	float _windowSeconds;
+
+	// Hard cap on attacks run in one frame, this is what stops them bunching up
+	UPROPERTY(config, EditDefaultsOnly, Category = "Attack Token Data", meta = (ClampMin = 1))
+	int32 _maxGrantsPerFrame;
+
+	// An enemy that can see the player goes before one this much closer that can't
+	UPROPERTY(config, EditDefaultsOnly, Category = "Attack Token Data", meta = (ClampMin = 0))
+	float _lineOfSightBonus;
+
+	// Distance taken off per second spent waiting, so far enemies get their turn eventually
+	UPROPERTY(config, EditDefaultsOnly, Category = "Attack Token Data", meta = (ClampMin = 0))
+	float _waitBonusPerSecond;
+
+	// A queued attack that hasn't been granted after this long is dropped, its target location would be stale by then
+	UPROPERTY(config, EditDefaultsOnly, Category = "Attack Token Data", meta = (ClampMin = 0.1))
+	float _maxWaitSeconds;
+
+private:
+	// Structure of arrays, index i is the same queued attack in all of them
+	TArray<TWeakObjectPtr<ABaseEnemy>> _attackers;
+	TArray<FVector> _attackLocations;
+	TArray<float> _queueTimes;
+
+	// Gathered each tick, attackers are scored against whichever of these is closest
+	TArray<FVector> _playerLocations;
+
+	float _availableTokens;
+	float _lastRefillTime;
+
+	uint64 _grantedCount;
+	uint64 _droppedCount;
+	int32 _highWaterMark;
+
+	//GettersAndSetters
+public:
+	UFUNCTION(BlueprintCallable, Category = "Attack Token GetSet")
+	int32 GetQueuedCount() const { return _attackers.Num(); }
+
+	uint64 GetGrantedCount() const { return _grantedCount; }
+
+	uint64 GetDroppedCount() const { return _droppedCount; }
+
+	int32 GetTokensPerWindow() const { return _tokensPerWindow; }
+
+	// Also refills the tokens, so a new rate starts from a full window
+	void SetTokensPerWindow(int32 tokensPerWindow);
+
+	//Functions
+public:
+	// Queues the enemy's attack at the location, or moves its queued one there. It runs once the enemy is granted a token
+	void QueueAttack(ABaseEnemy* attacker, const FVector& attackLocation);
+
+	// Drops the enemy's queued attack if it has one
+	void CancelAttack(const ABaseEnemy* attacker);
+
+	// Drops every queued attack and starts again from a full window
+	void ClearQueue();
+
+	void LogStats() const;
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	void RefillTokens(float worldTime);
+
+	void RemoveExpiredAttacks(float worldTime);
+
+	// Index of the queued attack to grant next, INDEX_NONE if there are none
+	int32 FindBestAttack(float worldTime) const;
+
+	void GatherPlayerLocations();
+
+	void RemoveAttackAtSwap(int32 attackIndex);
+};
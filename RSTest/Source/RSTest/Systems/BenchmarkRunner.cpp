@@ -0,0 +1,588 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BenchmarkRunner.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Kismet/KismetMathLibrary.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "GameFramework/PlayerController.h"
+#include "Components/CapsuleComponent.h"
+#include "AIController.h"
+#include "BrainComponent.h"
+#include "RenderCore.h"
+#include "UObject/UObjectArray.h"
+#include "RSTestCharacter.h"
+#include "RSTestProjectile.h"
+#include "RSTestStats.h"
+#include "Enemies/EEarthChanneler.h"
+#include "Powers/EarthSpike.h"
+#include "Systems/ArenaSpatialIndex.h"
+#include "Systems/AttackTokenDirector.h"
+#include "Systems/HitboxHistory.h"
+#include "Systems/WorldManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogBenchmark, Log, All);
+
+static FAutoConsoleCommandWithWorldAndArgs GBenchmarkRunCommand(
+	TEXT("RSTest.Benchmark.Run"),
+	TEXT("Runs the benchmark scenarios in the current world (optionally just the named one) and writes the results to Saved/Benchmarks"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& args, UWorld* world)
+	{
+		if (ABenchmarkRunner* runner = GetWorldManager<ABenchmarkRunner>(world))
+		{
+			runner->StartBenchmarks(args.Num() > 0 ? args[0] : FString(), false);
+		}
+	})
+);
+
+ABenchmarkRunner::ABenchmarkRunner()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+	bReplicates = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+
+	_channelerClass = FSoftClassPath(TEXT("/Game/Blueprints/Enemies/EarthChanneler.EarthChanneler_C"));
+	_earthSpikeClass = FSoftClassPath(TEXT("/Game/Blueprints/Attacks/EarthSpike.EarthSpike_C"));
+	_spawnRadius = 1500.f;
+	_botJumpInterval = 1.5f;
+
+	_phase = EBenchmarkPhase::Idle;
+	_scenarioIndex = INDEX_NONE;
+	_phaseEndTime = 0.f;
+	_quitWhenDone = false;
+	_projectileLifeSpan = 3.f;
+
+	_channelerAttackTimer = 0.f;
+	_spikeTimer = 0.f;
+	_botJumpTimer = 0.f;
+	_projectileDebt = 0.f;
+
+	_queryCountAtStart = 0;
+	_anchorTracesAtStart = 0;
+	_wallRunTracesAtStart = 0;
+	_visibilityTracesAtStart = 0;
+	_projectileSweepsAtStart = 0;
+	_hitboxRewindsAtStart = 0;
+	_attacksGrantedAtStart = 0;
+	_attacksDroppedAtStart = 0;
+
+	_configTokensPerWindow = 0;
+}
+
+ABenchmarkRunner* ABenchmarkRunner::Get(const UObject* worldContextObject)
+{
+	return GetWorldManager<ABenchmarkRunner>(worldContextObject);
+}
+
+void ABenchmarkRunner::StartBenchmarks(const FString& onlyScenario, bool quitWhenDone)
+{
+	if (GetIsRunning())
+	{
+		UE_LOG(LogBenchmark, Warning, TEXT("Benchmark already running"));
+		return;
+	}
+
+	_scenarioQueue.Reset();
+	for (int32 i = 0; i < _scenarios.Num(); i++)
+	{
+		if (onlyScenario.IsEmpty() || _scenarios[i].Name == onlyScenario)
+		{
+			_scenarioQueue.Add(i);
+		}
+	}
+
+	_quitWhenDone = quitWhenDone;
+	_results.Reset();
+
+	if (_scenarioQueue.Num() == 0)
+	{
+		UE_LOG(LogBenchmark, Error, TEXT("No benchmark scenario matches '%s'"), *onlyScenario);
+		if (_quitWhenDone)
+		{
+			FPlatformMisc::RequestExit(false);
+		}
+		return;
+	}
+
+	// Scripted input has to land after the player controller has applied the real (idle) input for the frame
+	if (APlayerController* playerController = UGameplayStatics::GetPlayerController(this, 0))
+	{
+		AddTickPrerequisiteActor(playerController);
+	}
+
+	SetActorTickEnabled(true);
+	StartScenario(_scenarioQueue[0]);
+}
+
+void ABenchmarkRunner::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (_phase == EBenchmarkPhase::Idle)
+	{
+		return;
+	}
+
+	DriveScenario(DeltaTime);
+
+	if (_phase == EBenchmarkPhase::Measure)
+	{
+		RecordFrame(DeltaTime);
+	}
+
+	const float worldTime = GetWorld()->GetTimeSeconds();
+	if (worldTime < _phaseEndTime)
+	{
+		return;
+	}
+
+	if (_phase == EBenchmarkPhase::Warmup)
+	{
+		// Everything the scenario spawns is up and running, measure from here
+		_phase = EBenchmarkPhase::Measure;
+		_phaseEndTime = worldTime + _scenarios[_scenarioIndex].MeasureSeconds;
+
+		_queryCountAtStart = FRSTestQueryCounters::GetTotal();
+		_anchorTracesAtStart = FRSTestQueryCounters::ChannelerAnchorTraces;
+		_wallRunTracesAtStart = FRSTestQueryCounters::WallRunTraces;
+		_visibilityTracesAtStart = FRSTestQueryCounters::VisibilityTraces;
+		_projectileSweepsAtStart = FRSTestQueryCounters::ProjectileSweeps;
+		_hitboxRewindsAtStart = FRSTestQueryCounters::HitboxRewinds;
+
+		const AAttackTokenDirector* attackDirector = AAttackTokenDirector::Get(this);
+		_attacksGrantedAtStart = attackDirector ? attackDirector->GetGrantedCount() : 0;
+		_attacksDroppedAtStart = attackDirector ? attackDirector->GetDroppedCount() : 0;
+		return;
+	}
+
+	FinishScenario();
+
+	_scenarioQueue.RemoveAt(0);
+	if (_scenarioQueue.Num() > 0)
+	{
+		StartScenario(_scenarioQueue[0]);
+		return;
+	}
+
+	_phase = EBenchmarkPhase::Idle;
+	SetActorTickEnabled(false);
+	WriteResults();
+
+	if (_quitWhenDone)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void ABenchmarkRunner::StartScenario(int32 scenarioIndex)
+{
+	const FBenchmarkScenario& scenario = _scenarios[scenarioIndex];
+	UE_LOG(LogBenchmark, Log, TEXT("Benchmark scenario '%s' starting"), *scenario.Name);
+
+	_scenarioIndex = scenarioIndex;
+	_phase = EBenchmarkPhase::Warmup;
+	_phaseEndTime = GetWorld()->GetTimeSeconds() + scenario.WarmupSeconds;
+
+	_channelerAttackTimer = 0.f;
+	_spikeTimer = 0.f;
+	_botJumpTimer = 0.f;
+	_projectileDebt = 0.f;
+
+	_gameThreadMs.Reset();
+	_frameMs.Reset();
+
+	// Set before the player fires anything so every shot in the scenario goes the same way
+	if (AHitboxHistory* hitboxHistory = AHitboxHistory::Get(this))
+	{
+		hitboxHistory->SetSimulatedLatency(scenario.SimulatedLatencyMs * 0.001f);
+	}
+
+	if (scenario.TokensPerWindow > 0)
+	{
+		AAttackTokenDirector* attackDirector = AAttackTokenDirector::Get(this);
+		_configTokensPerWindow = attackDirector->GetTokensPerWindow();
+		attackDirector->SetTokensPerWindow(scenario.TokensPerWindow);
+	}
+
+	ARSTestCharacter* player = GetPlayer();
+	if (!player)
+	{
+		UE_LOG(LogBenchmark, Warning, TEXT("No player character, scenario '%s' only measures the idle map"), *scenario.Name);
+		return;
+	}
+
+	const ARSTestProjectile* projectileDefaults = player->ProjectileClass ? player->ProjectileClass->GetDefaultObject<ARSTestProjectile>() : nullptr;
+	_projectileLifeSpan = (projectileDefaults && projectileDefaults->InitialLifeSpan > 0.f) ? projectileDefaults->InitialLifeSpan : 3.f;
+
+	SpawnChannelers(scenario, player);
+
+	if (scenario.WallRunBot)
+	{
+		PlaceWallRunBot(player);
+	}
+}
+
+void ABenchmarkRunner::FinishScenario()
+{
+	const FBenchmarkScenario& scenario = _scenarios[_scenarioIndex];
+
+	TSharedRef<FJsonObject> result = MakeShared<FJsonObject>();
+	result->SetStringField(TEXT("name"), scenario.Name);
+	result->SetNumberField(TEXT("channelers"), scenario.ChannelerCount);
+	result->SetBoolField(TEXT("attackTokens"), scenario.AttackTokens);
+	result->SetNumberField(TEXT("projectilesInFlight"), scenario.ProjectilesInFlight);
+	result->SetNumberField(TEXT("growingSpikes"), scenario.GrowingSpikes);
+	result->SetBoolField(TEXT("wallRunBot"), scenario.WallRunBot);
+	result->SetNumberField(TEXT("simulatedLatencyMs"), scenario.SimulatedLatencyMs);
+	result->SetNumberField(TEXT("frames"), _frameMs.Num());
+
+	auto addTimings = [&result](const TCHAR* fieldName, TArray<float>& samples)
+	{
+		TSharedRef<FJsonObject> timings = MakeShared<FJsonObject>();
+		if (samples.Num() > 0)
+		{
+			samples.Sort();
+
+			float total = 0.f;
+			for (float sample : samples)
+			{
+				total += sample;
+			}
+
+			timings->SetNumberField(TEXT("mean"), total / samples.Num());
+			timings->SetNumberField(TEXT("median"), samples[samples.Num() / 2]);
+			timings->SetNumberField(TEXT("p95"), samples[FMath::Min(samples.Num() - 1, samples.Num() * 95 / 100)]);
+			timings->SetNumberField(TEXT("max"), samples.Last());
+		}
+		result->SetObjectField(fieldName, timings);
+	};
+	addTimings(TEXT("gameThreadMs"), _gameThreadMs);
+	addTimings(TEXT("frameMs"), _frameMs);
+
+	TSharedRef<FJsonObject> queries = MakeShared<FJsonObject>();
+	queries->SetNumberField(TEXT("total"), FRSTestQueryCounters::GetTotal() - _queryCountAtStart);
+	queries->SetNumberField(TEXT("channelerAnchorTraces"), FRSTestQueryCounters::ChannelerAnchorTraces - _anchorTracesAtStart);
+	queries->SetNumberField(TEXT("wallRunTraces"), FRSTestQueryCounters::WallRunTraces - _wallRunTracesAtStart);
+	queries->SetNumberField(TEXT("visibilityTraces"), FRSTestQueryCounters::VisibilityTraces - _visibilityTracesAtStart);
+	queries->SetNumberField(TEXT("projectileSweeps"), FRSTestQueryCounters::ProjectileSweeps - _projectileSweepsAtStart);
+	// Only the scene queries game code counts itself, the engine's own (like movement component sweeps) aren't in here
+	result->SetObjectField(TEXT("gameQueries"), queries);
+
+	// Tested against the hitbox history, not the physics scene
+	result->SetNumberField(TEXT("hitboxRewinds"), FRSTestQueryCounters::HitboxRewinds - _hitboxRewindsAtStart);
+
+	// Behaviour tree attacks go through the director in every scenario, so these aren't only the scripted ones
+	if (const AAttackTokenDirector* attackDirector = AAttackTokenDirector::Get(this))
+	{
+		TSharedRef<FJsonObject> attacks = MakeShared<FJsonObject>();
+		const uint64 granted = attackDirector->GetGrantedCount() - _attacksGrantedAtStart;
+		const uint64 dropped = attackDirector->GetDroppedCount() - _attacksDroppedAtStart;
+		attacks->SetNumberField(TEXT("granted"), granted);
+		attacks->SetNumberField(TEXT("dropped"), dropped);
+		attacks->SetNumberField(TEXT("droppedFraction"), (granted + dropped) > 0 ? (double)dropped / (granted + dropped) : 0.0);
+		attacks->SetNumberField(TEXT("tokensPerWindow"), attackDirector->GetTokensPerWindow());
+		result->SetObjectField(TEXT("attacks"), attacks);
+	}
+
+	int32 actorCount = 0;
+	for (TActorIterator<AActor> it(GetWorld()); it; ++it)
+	{
+		actorCount++;
+	}
+	result->SetNumberField(TEXT("actors"), actorCount);
+	result->SetNumberField(TEXT("uobjects"), GUObjectArray.GetObjectArrayNumMinusAvailable());
+
+	const FPlatformMemoryStats memoryStats = FPlatformMemory::GetStats();
+	result->SetNumberField(TEXT("usedPhysicalMB"), memoryStats.UsedPhysical / (1024.0 * 1024.0));
+	result->SetNumberField(TEXT("peakUsedPhysicalMB"), memoryStats.PeakUsedPhysical / (1024.0 * 1024.0));
+
+	_results.Add(MakeShared<FJsonValueObject>(result));
+
+	UE_LOG(LogBenchmark, Log, TEXT("Benchmark scenario '%s' done, %d frames"), *scenario.Name, _frameMs.Num());
+
+	ClearScenarioActors();
+}
+
+void ABenchmarkRunner::DriveScenario(float deltaTime)
+{
+	const FBenchmarkScenario& scenario = _scenarios[_scenarioIndex];
+	ARSTestCharacter* player = GetPlayer();
+	if (!player)
+	{
+		return;
+	}
+
+	const FVector playerLocation = player->GetActorLocation();
+
+	_channelerAttackTimer += deltaTime;
+	if (_channelerAttackTimer >= scenario.ChannelerAttackInterval)
+	{
+		_channelerAttackTimer -= scenario.ChannelerAttackInterval;
+
+		AAttackTokenDirector* attackDirector = scenario.AttackTokens ? AAttackTokenDirector::Get(this) : nullptr;
+		for (const TWeakObjectPtr<AEEarthChanneler>& channeler : _channelers)
+		{
+			if (!channeler.IsValid())
+			{
+				continue;
+			}
+
+			if (attackDirector)
+			{
+				attackDirector->QueueAttack(channeler.Get(), playerLocation);
+			}
+			else
+			{
+				channeler->Attack(playerLocation);
+			}
+		}
+	}
+
+	if (scenario.GrowingSpikes > 0)
+	{
+		_spikeTimer -= deltaTime;
+		if (_spikeTimer <= 0.f)
+		{
+			_spikeTimer += scenario.SpikeInterval;
+			SpawnSpikes(scenario, player);
+		}
+	}
+
+	// Fire rate that keeps the requested number in the air for a projectile's life span
+	_projectileDebt += deltaTime * scenario.ProjectilesInFlight / _projectileLifeSpan;
+	while (_projectileDebt >= 1.f)
+	{
+		_projectileDebt -= 1.f;
+		player->ScriptedFire();
+	}
+
+	if (scenario.WallRunBot)
+	{
+		// Forward along the wall while holding towards it, it's on the right
+		player->ScriptedMove(1.f, 1.f);
+
+		_botJumpTimer -= deltaTime;
+		if (_botJumpTimer <= 0.f)
+		{
+			_botJumpTimer += _botJumpInterval;
+			player->Jump();
+		}
+	}
+}
+
+void ABenchmarkRunner::RecordFrame(float deltaTime)
+{
+	// GGameThreadTime is last frame's game thread time, excluding any wait on the render thread
+	_gameThreadMs.Add(FPlatformTime::ToMilliseconds(GGameThreadTime));
+	_frameMs.Add(deltaTime * 1000.f);
+}
+
+void ABenchmarkRunner::SpawnChannelers(const FBenchmarkScenario& scenario, const ARSTestCharacter* player)
+{
+	UClass* channelerClass = scenario.ChannelerCount > 0 ? _channelerClass.TryLoadClass<AEEarthChanneler>() : nullptr;
+	if (!channelerClass)
+	{
+		return;
+	}
+
+	const FVector playerLocation = player->GetActorLocation();
+
+	FActorSpawnParameters spawnParams;
+	spawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	for (int32 i = 0; i < scenario.ChannelerCount; i++)
+	{
+		const FVector spawnLocation = GetRingLocation(playerLocation, i, scenario.ChannelerCount);
+		const FRotator spawnRotation = UKismetMathLibrary::FindLookAtRotation(spawnLocation, playerLocation);
+
+		AEEarthChanneler* channeler = GetWorld()->SpawnActor<AEEarthChanneler>(channelerClass, spawnLocation, FRotator(0.f, spawnRotation.Yaw, 0.f), spawnParams);
+		if (channeler)
+		{
+			if (!channeler->GetController())
+			{
+				channeler->SpawnDefaultController();
+			}
+
+			// Possessing starts the behaviour tree, which would attack on its own cooldown on top of the scripted attacks
+			// and make no two runs the same. The scenario is the only thing that attacks
+			const AAIController* aiController = Cast<AAIController>(channeler->GetController());
+			if (aiController && aiController->GetBrainComponent())
+			{
+				aiController->GetBrainComponent()->StopLogic(TEXT("Benchmark"));
+			}
+			_channelers.Add(channeler);
+		}
+	}
+}
+
+void ABenchmarkRunner::SpawnSpikes(const FBenchmarkScenario& scenario, const ARSTestCharacter* player)
+{
+	UClass* earthSpikeClass = _earthSpikeClass.TryLoadClass<AEarthSpike>();
+	if (!earthSpikeClass)
+	{
+		return;
+	}
+
+	// Out of the floor around the player, same placement the channeler uses for a floor anchor
+	const FVector attackLocation = player->GetActorLocation();
+	const FVector floorCentre = attackLocation - FVector(0.f, 0.f, player->GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+
+	for (int32 i = 0; i < scenario.GrowingSpikes; i++)
+	{
+		const FVector spawnLocation = GetRingLocation(floorCentre, i, scenario.GrowingSpikes);
+
+		AEarthSpike* spike = GetWorld()->SpawnActor<AEarthSpike>(
+			earthSpikeClass,
+			spawnLocation,
+			AEarthSpike::GetSpawnRotation(spawnLocation, attackLocation)
+			);
+		if (spike)
+		{
+			spike->SetAttackLocation(attackLocation);
+			spike->ActivatePowerAfterDelay();
+			_spikes.Add(spike);
+		}
+	}
+}
+
+void ABenchmarkRunner::PlaceWallRunBot(ARSTestCharacter* player) const
+{
+	const AArenaSpatialIndex* arenaIndex = AArenaSpatialIndex::Get(player);
+	if (!arenaIndex)
+	{
+		return;
+	}
+
+	const FVector playerLocation = player->GetActorLocation();
+	const FVector directions[] = { FVector::ForwardVector, -FVector::ForwardVector, FVector::RightVector, -FVector::RightVector };
+
+	bool foundWall = false;
+	FVector nearestWallLocation = FVector::ZeroVector;
+	FVector nearestWallDirection = FVector::ZeroVector;
+	float nearestDistanceSquared = MAX_FLT;
+
+	for (const FVector& direction : directions)
+	{
+		EArenaDirection arenaDirection;
+		bool hasWall = false;
+		FVector wallLocation;
+		AActor* wall = nullptr;
+		if (AArenaSpatialIndex::GetArenaDirection(direction, arenaDirection) &&
+			arenaIndex->FindNearestWall(playerLocation, arenaDirection, MAX_FLT, hasWall, wallLocation, wall) &&
+			hasWall && FVector::DistSquared(playerLocation, wallLocation) < nearestDistanceSquared)
+		{
+			foundWall = true;
+			nearestDistanceSquared = FVector::DistSquared(playerLocation, wallLocation);
+			nearestWallLocation = wallLocation;
+			nearestWallDirection = direction;
+		}
+	}
+
+	if (!foundWall)
+	{
+		UE_LOG(LogBenchmark, Warning, TEXT("No arena wall found for the wall run bot, it will run and jump in place"));
+		return;
+	}
+
+	// Just off the wall with it on the player's right, facing along it
+	const FVector botLocation = nearestWallLocation - nearestWallDirection * (player->GetCapsuleComponent()->GetScaledCapsuleRadius() * 2.f);
+	const FRotator botRotation = FVector::CrossProduct(nearestWallDirection, FVector::UpVector).Rotation();
+
+	player->TeleportTo(FVector(botLocation.X, botLocation.Y, playerLocation.Z), botRotation);
+	if (AController* controller = player->GetController())
+	{
+		controller->SetControlRotation(botRotation);
+	}
+}
+
+void ABenchmarkRunner::ClearScenarioActors()
+{
+	if (AHitboxHistory* hitboxHistory = AHitboxHistory::Get(this))
+	{
+		hitboxHistory->SetSimulatedLatency(0.f);
+	}
+
+	if (_configTokensPerWindow > 0)
+	{
+		if (AAttackTokenDirector* attackDirector = AAttackTokenDirector::Get(this))
+		{
+			attackDirector->SetTokensPerWindow(_configTokensPerWindow);
+		}
+		_configTokensPerWindow = 0;
+	}
+
+	for (const TWeakObjectPtr<AEEarthChanneler>& channeler : _channelers)
+	{
+		if (channeler.IsValid())
+		{
+			if (AController* controller = channeler->GetController())
+			{
+				controller->Destroy();
+			}
+			channeler->Destroy();
+		}
+	}
+	_channelers.Reset();
+
+	// Finished spikes have been retired to instances already, only growing ones are still actors
+	for (const TWeakObjectPtr<AEarthSpike>& spike : _spikes)
+	{
+		if (spike.IsValid())
+		{
+			spike->Destroy();
+		}
+	}
+	_spikes.Reset();
+
+	if (ARSTestCharacter* player = GetPlayer())
+	{
+		player->ScriptedMove(0.f, 0.f);
+	}
+}
+
+void ABenchmarkRunner::WriteResults()
+{
+	TSharedRef<FJsonObject> root = MakeShared<FJsonObject>();
+	root->SetStringField(TEXT("map"), GetWorld()->GetMapName());
+	root->SetStringField(TEXT("build"), FApp::GetBuildVersion());
+	root->SetStringField(TEXT("configuration"), EBuildConfigurations::ToString(FApp::GetBuildConfiguration()));
+	root->SetStringField(TEXT("platform"), FPlatformProperties::PlatformName());
+	root->SetStringField(TEXT("time"), FDateTime::UtcNow().ToIso8601());
+	root->SetArrayField(TEXT("scenarios"), _results);
+
+	FString output;
+	TSharedRef<TJsonWriter<>> writer = TJsonWriterFactory<>::Create(&output);
+	FJsonSerializer::Serialize(root, writer);
+
+	const FString fileName = FString::Printf(TEXT("Benchmark-%s.json"), *FDateTime::Now().ToString());
+	const FString filePath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"), fileName);
+	if (FFileHelper::SaveStringToFile(output, *filePath))
+	{
+		UE_LOG(LogBenchmark, Log, TEXT("Benchmark results written to %s"), *filePath);
+	}
+	else
+	{
+		UE_LOG(LogBenchmark, Error, TEXT("Couldn't write benchmark results to %s"), *filePath);
+	}
+}
+
+ARSTestCharacter* ABenchmarkRunner::GetPlayer() const
+{
+	return Cast<ARSTestCharacter>(UGameplayStatics::GetPlayerCharacter(this, 0));
+}
+
+FVector ABenchmarkRunner::GetRingLocation(const FVector& centre, int32 index, int32 count) const
+{
+	const float angle = 2.f * PI * index / FMath::Max(count, 1);
+	return centre + FVector(FMath::Cos(angle), FMath::Sin(angle), 0.f) * _spawnRadius;
+}
@@ -0,0 +1,188 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "BenchmarkRunner.generated.h"
+
+class AEEarthChanneler;
+class AEarthSpike;
+class ARSTestCharacter;
+class FJsonValue;
+
+USTRUCT()
+struct FBenchmarkScenario
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "Benchmark Data")
+	FString Name;
+
+	UPROPERTY(EditAnywhere, Category = "Benchmark Data", meta = (ClampMin = 0))
+	int32 ChannelerCount;
+
+	// Channelers attack the player this often, scripted rather than left to their behaviour tree so every run does the same work
+	UPROPERTY(EditAnywhere, Category = "Benchmark Data", meta = (ClampMin = 0.1))
+	float ChannelerAttackInterval;
+
+	// The scripted attacks are queued with the attack token director instead of all running on the same frame
+	UPROPERTY(EditAnywhere, Category = "Benchmark Data")
+	bool AttackTokens;
+
+	// Tokens per window the director hands out during the scenario, 0 keeps its config. Sized to the scripted attacks so they're
+	// spread out rather than dropped
+	UPROPERTY(EditAnywhere, Category = "Benchmark Data", meta = (ClampMin = 0))
+	int32 TokensPerWindow;
+
+	// The player fires fast enough to keep about this many projectiles in the air
+	UPROPERTY(EditAnywhere, Category = "Benchmark Data", meta = (ClampMin = 0))
+	int32 ProjectilesInFlight;
+
+	// Spikes started around the player every SpikeInterval seconds
+	UPROPERTY(EditAnywhere, Category = "Benchmark Data", meta = (ClampMin = 0))
+	int32 GrowingSpikes;
+
+	UPROPERTY(EditAnywhere, Category = "Benchmark Data", meta = (ClampMin = 0.1))
+	float SpikeInterval;
+
+	// The player is put next to the nearest arena wall and runs along it, jumping onto it
+	UPROPERTY(EditAnywhere, Category = "Benchmark Data")
+	bool WallRunBot;
+
+	// The player's shots are lag compensated as if they had this much latency, to compare the rewound hit path with the normal one
+	UPROPERTY(EditAnywhere, Category = "Benchmark Data", meta = (ClampMin = 0))
+	float SimulatedLatencyMs;
+
+	UPROPERTY(EditAnywhere, Category = "Benchmark Data", meta = (ClampMin = 0))
+	float WarmupSeconds;
+
+	UPROPERTY(EditAnywhere, Category = "Benchmark Data", meta = (ClampMin = 0.1))
+	float MeasureSeconds;
+
+	FBenchmarkScenario()
+		: ChannelerCount(0)
+		, ChannelerAttackInterval(2.f)
+		, AttackTokens(false)
+		, TokensPerWindow(0)
+		, ProjectilesInFlight(0)
+		, GrowingSpikes(0)
+		, SpikeInterval(1.f)
+		, WallRunBot(false)
+		, SimulatedLatencyMs(0.f)
+		, WarmupSeconds(2.f)
+		, MeasureSeconds(10.f)
+	{}
+};
+
+/**
+ * Runs the configured combat scenarios one after the other in the current map and writes what each one cost to
+ * Saved/Benchmarks as JSON, so builds can be compared scenario by scenario. Meant to be started from the command line,
+ * e.g. "RSTest <BenchmarkMap> -game -nullrhi -RSBenchmark", which quits once every scenario is done.
+ * -RSBenchmarkScenario=<Name> runs just one. RSTest.Benchmark.Run starts the same thing from the console.
+ */
+UCLASS(config=Game, notplaceable)
+class RSTEST_API ABenchmarkRunner : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ABenchmarkRunner();
+
+	static ABenchmarkRunner* Get(const UObject* worldContextObject);
+
+	//Variables
+protected:
+	UPROPERTY(config, EditDefaultsOnly, Category = "Benchmark Data")
+	TArray<FBenchmarkScenario> _scenarios;
+
+	UPROPERTY(config, EditDefaultsOnly, Category = "Benchmark Data")
+	FSoftClassPath _channelerClass;
+
+	UPROPERTY(config, EditDefaultsOnly, Category = "Benchmark Data")
+	FSoftClassPath _earthSpikeClass;
+
+	// Channelers and spikes are placed on a ring this far around the player
+	UPROPERTY(config, EditDefaultsOnly, Category = "Benchmark Data", meta = (ClampMin = 0))
+	float _spawnRadius;
+
+	UPROPERTY(config, EditDefaultsOnly, Category = "Benchmark Data", meta = (ClampMin = 0.1))
+	float _botJumpInterval;
+
+private:
+	enum class EBenchmarkPhase : uint8
+	{
+		Idle,
+		Warmup,
+		Measure,
+	};
+
+	EBenchmarkPhase _phase;
+	int32 _scenarioIndex;
+	float _phaseEndTime;
+	bool _quitWhenDone;
+
+	TArray<int32> _scenarioQueue;
+	TArray<TSharedPtr<FJsonValue>> _results;
+
+	// Scenario state
+	TArray<TWeakObjectPtr<AEEarthChanneler>> _channelers;
+	TArray<TWeakObjectPtr<AEarthSpike>> _spikes;
+	float _channelerAttackTimer;
+	float _spikeTimer;
+	float _botJumpTimer;
+	float _projectileDebt;
+	float _projectileLifeSpan;
+
+	// Measurement
+	TArray<float> _gameThreadMs;
+	TArray<float> _frameMs;
+	uint64 _queryCountAtStart;
+	uint64 _anchorTracesAtStart;
+	uint64 _wallRunTracesAtStart;
+	uint64 _visibilityTracesAtStart;
+	uint64 _projectileSweepsAtStart;
+	uint64 _hitboxRewindsAtStart;
+	uint64 _attacksGrantedAtStart;
+	uint64 _attacksDroppedAtStart;
+
+	// The director's own tokens per window while a scenario overrides it, 0 otherwise
+	int32 _configTokensPerWindow;
+
+	//GettersAndSetters
+public:
+	bool GetIsRunning() const { return _phase != EBenchmarkPhase::Idle; }
+
+	// Scenarios finished in the current or last run
+	int32 GetResultCount() const { return _results.Num(); }
+
+	//Functions
+public:
+	// Runs every scenario, or only the one with the given name
+	void StartBenchmarks(const FString& onlyScenario, bool quitWhenDone);
+
+protected:
+	virtual void Tick(float DeltaTime) override;
+
+	void StartScenario(int32 scenarioIndex);
+
+	void FinishScenario();
+
+	void DriveScenario(float deltaTime);
+
+	void RecordFrame(float deltaTime);
+
+	void SpawnChannelers(const FBenchmarkScenario& scenario, const ARSTestCharacter* player);
+
+	void SpawnSpikes(const FBenchmarkScenario& scenario, const ARSTestCharacter* player);
+
+	void PlaceWallRunBot(ARSTestCharacter* player) const;
+
+	void ClearScenarioActors();
+
+	void WriteResults();
+
+	ARSTestCharacter* GetPlayer() const;
+
+	FVector GetRingLocation(const FVector& centre, int32 index, int32 count) const;
+};
@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CombatReplicator.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "HAL/IConsoleManager.h"
+#include "RSTestPlayerController.h"
+#include "RSTestProjectile.h"
+#include "Powers/EarthSpike.h"
+#include "Systems/WorldManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCombatReplicator, Log, All);
+
+static FAutoConsoleCommandWithWorld GCombatReplicatorStatsCommand(
+	TEXT("RSTest.Net.Events"),
+	TEXT("Logs how many projectile and spike spawn events the server has sent and culled"),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* world)
+	{
+		if (ACombatReplicator* replicator = GetWorldManager<ACombatReplicator>(world, false))
+		{
+			replicator->LogStats();
+		}
+	})
+);
+
+ACombatReplicator::ACombatReplicator()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	// Lives on the server and on every client, each side only uses its own half
+	bReplicates = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+
+	_projectileCullDistance = 5000.f;
+	_spikeCullDistance = 15000.f;
+
+	_projectileEventsSent = 0;
+	_projectileEventsCulled = 0;
+	_spikeEventsSent = 0;
+	_spikeEventsCulled = 0;
+}
+
+ACombatReplicator* ACombatReplicator::Get(const UObject* worldContextObject)
+{
+	return GetWorldManager<ACombatReplicator>(worldContextObject);
+}
+
+void ACombatReplicator::SendProjectileSpawn(const FProjectileSpawnEvent& spawnEvent)
+{
+	if (GetNetMode() == NM_Standalone || GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	for (FConstPlayerControllerIterator it = GetWorld()->GetPlayerControllerIterator(); it; ++it)
+	{
+		ARSTestPlayerController* playerController = Cast<ARSTestPlayerController>(it->Get());
+		if (!playerController || playerController->IsLocalController() || playerController->GetPawn() == spawnEvent.Instigator)
+		{
+			continue;
+		}
+
+		if (!GetIsRelevantTo(playerController, spawnEvent.Location, _projectileCullDistance))
+		{
+			_projectileEventsCulled++;
+			continue;
+		}
+
+		playerController->ClientProjectileSpawned(spawnEvent);
+		_projectileEventsSent++;
+	}
+}
+
+void ACombatReplicator::SendSpikeSpawn(const FSpikeSpawnEvent& spawnEvent)
+{
+	if (GetNetMode() == NM_Standalone || GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	for (FConstPlayerControllerIterator it = GetWorld()->GetPlayerControllerIterator(); it; ++it)
+	{
+		ARSTestPlayerController* playerController = Cast<ARSTestPlayerController>(it->Get());
+		if (!playerController || playerController->IsLocalController())
+		{
+			continue;
+		}
+
+		if (!GetIsRelevantTo(playerController, spawnEvent.Location, _spikeCullDistance))
+		{
+			_spikeEventsCulled++;
+			continue;
+		}
+
+		playerController->ClientSpikeSpawned(spawnEvent);
+		_spikeEventsSent++;
+	}
+}
+
+void ACombatReplicator::ReceiveProjectileSpawn(const FProjectileSpawnEvent& spawnEvent)
+{
+	ARSTestProjectile::LaunchProjectile(this, spawnEvent.ProjectileClass, spawnEvent.Location, spawnEvent.GetRotation(),
+		spawnEvent.Instigator, spawnEvent.Batched, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+}
+
+void ACombatReplicator::ReceiveSpikeSpawn(const FSpikeSpawnEvent& spawnEvent)
+{
+	UWorld* const world = GetWorld();
+	if (!spawnEvent.SpikeClass || !world)
+	{
+		return;
+	}
+
+	AEarthSpike* spike = world->SpawnActor<AEarthSpike>(
+		spawnEvent.SpikeClass,
+		spawnEvent.Location,
+		AEarthSpike::GetSpawnRotation(spawnEvent.Location, spawnEvent.AttackLocation)
+		);
+
+	if (spike)
+	{
+		// The event can arrive a while after the server spawned it, catch up rather than play it late
+		const AGameStateBase* gameState = world->GetGameState();
+		const float serverTime = gameState ? gameState->GetServerWorldTimeSeconds() : spawnEvent.SpawnTime;
+
+		spike->SetAttackLocation(spawnEvent.AttackLocation);
+		spike->ActivatePowerAfterDelay(FMath::Max(serverTime - spawnEvent.SpawnTime, 0.f));
+	}
+}
+
+bool ACombatReplicator::GetIsRelevantTo(APlayerController* playerController, const FVector& location, float cullDistance) const
+{
+	FVector viewLocation;
+	FRotator viewRotation;
+	playerController->GetPlayerViewPoint(viewLocation, viewRotation);
+
+	return FVector::DistSquared(viewLocation, location) <= FMath::Square(cullDistance);
+}
+
+void ACombatReplicator::LogStats() const
+{
+	UE_LOG(LogCombatReplicator, Log, TEXT("Combat replicator: %d projectile events sent (%d culled), %d spike events sent (%d culled)"),
+		_projectileEventsSent, _projectileEventsCulled, _spikeEventsSent, _spikeEventsCulled);
+}
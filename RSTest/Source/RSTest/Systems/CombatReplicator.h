@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Engine/NetSerialization.h"
+#include "CombatReplicator.generated.h"
+
+class AEarthSpike;
+class APlayerController;
+class ARSTestProjectile;
+
+/** A shot as sent to clients, enough for them to fire the same projectile locally */
+USTRUCT()
+struct FProjectileSpawnEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSubclassOf<ARSTestProjectile> ProjectileClass;
+
+	UPROPERTY()
+	FVector_NetQuantize10 Location;
+
+	// FRotator::CompressAxisToShort, projectiles never roll
+	UPROPERTY()
+	uint16 Pitch;
+
+	UPROPERTY()
+	uint16 Yaw;
+
+	// Which projectile system the shot went through, so clients draw it the same way
+	UPROPERTY()
+	bool Batched;
+
+	// Ignored by the projectile's sweeps, it's fired from inside their reach
+	UPROPERTY()
+	AActor* Instigator;
+
+	FProjectileSpawnEvent() : Pitch(0), Yaw(0), Batched(false), Instigator(nullptr) {}
+
+	FProjectileSpawnEvent(TSubclassOf<ARSTestProjectile> projectileClass, const FVector& location, const FRotator& rotation, bool batched, AActor* instigator)
+		: ProjectileClass(projectileClass)
+		, Location(location)
+		, Pitch(FRotator::CompressAxisToShort(rotation.Pitch))
+		, Yaw(FRotator::CompressAxisToShort(rotation.Yaw))
+		, Batched(batched)
+		, Instigator(instigator)
+	{}
+
+	FRotator GetRotation() const { return FRotator(FRotator::DecompressAxisFromShort(Pitch), FRotator::DecompressAxisFromShort(Yaw), 0.f); }
+};
+
+/** A spike as sent to clients. Its rotation and growth follow from where it is, where it's going and when it started */
+USTRUCT()
+struct FSpikeSpawnEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSubclassOf<AEarthSpike> SpikeClass;
+
+	UPROPERTY()
+	FVector_NetQuantize Location;
+
+	UPROPERTY()
+	FVector_NetQuantize AttackLocation;
+
+	// Server world time
+	UPROPERTY()
+	float SpawnTime;
+
+	FSpikeSpawnEvent() : SpawnTime(0.f) {}
+};
+
+/**
+ * Projectiles and spikes have no actor channels, the server sends a compact spawn event instead and every client
+ * spawns its own copy, purely for show - health and damage stay on the server. Events only go to players whose view is
+ * within the cull distance of them, and a shot isn't sent back to the player who fired it since they've already got it.
+ * The same manager receives the events on clients (through ARSTestPlayerController). One per world, get it through Get.
+ */
+UCLASS(config=Game, notplaceable)
+class RSTEST_API ACombatReplicator : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ACombatReplicator();
+
+	static ACombatReplicator* Get(const UObject* worldContextObject);
+
+	//Variables
+protected:
+	UPROPERTY(config, EditDefaultsOnly, Category = "Combat Replicator Data", meta = (ClampMin = 0))
+	float _projectileCullDistance;
+
+	// Spikes are what players dodge, they're sent further out and reliably
+	UPROPERTY(config, EditDefaultsOnly, Category = "Combat Replicator Data", meta = (ClampMin = 0))
+	float _spikeCullDistance;
+
+private:
+	int32 _projectileEventsSent;
+	int32 _projectileEventsCulled;
+	int32 _spikeEventsSent;
+	int32 _spikeEventsCulled;
+
+	//GettersAndSetters
+public:
+	int32 GetProjectileEventsSent() const { return _projectileEventsSent; }
+
+	int32 GetProjectileEventsCulled() const { return _projectileEventsCulled; }
+
+	int32 GetSpikeEventsSent() const { return _spikeEventsSent; }
+
+	int32 GetSpikeEventsCulled() const { return _spikeEventsCulled; }
+
+	//Functions
+public:
+	// Server only, does nothing in a standalone game
+	void SendProjectileSpawn(const FProjectileSpawnEvent& spawnEvent);
+
+	void SendSpikeSpawn(const FSpikeSpawnEvent& spawnEvent);
+
+	// Client only
+	void ReceiveProjectileSpawn(const FProjectileSpawnEvent& spawnEvent);
+
+	void ReceiveSpikeSpawn(const FSpikeSpawnEvent& spawnEvent);
+
+	void LogStats() const;
+
+protected:
+	bool GetIsRelevantTo(APlayerController* playerController, const FVector& location, float cullDistance) const;
+};
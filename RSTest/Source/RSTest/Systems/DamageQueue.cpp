@@ -0,0 +1,153 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "DamageQueue.h"
+#include "Components/LifeSystem.h"
+#include "Interfaces/Damageable.h"
+#include "Systems/WorldManager.h"
+
+ADamageQueue::ADamageQueue()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	// After physics and every actor tick, so all of the frame's hits are in
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
+	bReplicates = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+
+	_combineHitsInFrame = false;
+}
+
+ADamageQueue* ADamageQueue::Get(const UObject* worldContextObject)
+{
+	return GetWorldManager<ADamageQueue>(worldContextObject);
+}
+
+void ADamageQueue::QueueDamage(AActor* target, AActor* attackedBy, float damage)
+{
+	// Only the server applies damage, clients get the result through the life system's replicated health
+	if (!target || target->GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	ADamageQueue* damageQueue = Get(target);
+	if (damageQueue)
+	{
+		damageQueue->Enqueue(target, attackedBy, damage);
+	}
+	else if (IDamageable* damageable = Cast<IDamageable>(target))
+	{
+		if (ApplyDamage(damageable, attackedBy, damage))
+		{
+			damageable->OnKilled();
+		}
+	}
+}
+
+void ADamageQueue::Enqueue(AActor* target, AActor* attackedBy, float damage)
+{
+	FQueuedDamage queuedDamage;
+	queuedDamage.Target = target;
+	queuedDamage.AttackedBy = attackedBy;
+	queuedDamage.Damage = damage;
+	_queuedDamage.Add(queuedDamage);
+
+	if (!IsActorTickEnabled())
+	{
+		SetActorTickEnabled(true);
+	}
+}
+
+void ADamageQueue::ClearQueue()
+{
+	_queuedDamage.Reset();
+	SetActorTickEnabled(false);
+}
+
+void ADamageQueue::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	Flush();
+
+	if (_queuedDamage.Num() == 0)
+	{
+		SetActorTickEnabled(false);
+	}
+}
+
+void ADamageQueue::Flush()
+{
+	// Group hits per target, in the order the targets were first hit so results don't depend on pointer values
+	for (const FQueuedDamage& queuedDamage : _queuedDamage)
+	{
+		AActor* target = queuedDamage.Target.Get();
+		if (!target || target->IsPendingKill())
+		{
+			continue;
+		}
+
+		int32* targetIndex = _targetIndices.Find(target);
+		if (!targetIndex)
+		{
+			IDamageable* damageable = Cast<IDamageable>(target);
+			if (!damageable)
+			{
+				continue;
+			}
+
+			FTargetDamage targetDamage;
+			targetDamage.Target = target;
+			targetDamage.Damageable = damageable;
+			targetDamage.AttackedBy = queuedDamage.AttackedBy.Get();
+			targetDamage.Damage = queuedDamage.Damage;
+			_targetIndices.Add(target, _targetDamage.Add(targetDamage));
+			continue;
+		}
+
+		FTargetDamage& targetDamage = _targetDamage[*targetIndex];
+		if (_combineHitsInFrame)
+		{
+			targetDamage.Damage += queuedDamage.Damage;
+		}
+		else if (queuedDamage.Damage > targetDamage.Damage)
+		{
+			targetDamage.Damage = queuedDamage.Damage;
+			targetDamage.AttackedBy = queuedDamage.AttackedBy.Get();
+		}
+	}
+	_queuedDamage.Reset();
+
+	for (const FTargetDamage& targetDamage : _targetDamage)
+	{
+		if (ApplyDamage(targetDamage.Damageable, targetDamage.AttackedBy, targetDamage.Damage))
+		{
+			_killedTargets.Add(targetDamage.Damageable);
+		}
+	}
+
+	// Deaths last, so nothing above ever touches an actor that's already been removed
+	for (IDamageable* killedTarget : _killedTargets)
+	{
+		killedTarget->OnKilled();
+	}
+
+	_targetDamage.Reset();
+	_targetIndices.Reset();
+	_killedTargets.Reset();
+}
+
+bool ADamageQueue::ApplyDamage(IDamageable* damageable, AActor* attackedBy, float damage)
+{
+	ULifeSystem* lifeSystem = damageable->GetLifeSystem();
+	if (!lifeSystem || lifeSystem->GetIsDead())
+	{
+		return false;
+	}
+
+	lifeSystem->OnTakeDamage(damage);
+	damageable->OnAttacked(attackedBy, damage);
+
+	return lifeSystem->GetIsDead();
+}
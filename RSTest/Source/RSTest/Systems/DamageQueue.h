@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "DamageQueue.generated.h"
+
+class IDamageable;
+
+/**
+ * Collects every hit reported during the frame (usually from physics callbacks) and applies them together
+ * at the end of the frame: hits are grouped per target, invulnerability kicks in once, and deaths are handled last.
+ */
+UCLASS(config=Game, notplaceable)
+class RSTEST_API ADamageQueue : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ADamageQueue();
+
+	static ADamageQueue* Get(const UObject* worldContextObject);
+
+	// Queues damage on target if it's damageable, applies it straight away if there's no queue in this world
+	static void QueueDamage(AActor* target, AActor* attackedBy, float damage);
+
+	//Variables
+protected:
+	// When false only the strongest hit per target per frame counts, which matches hits landing one after another inside the invulnerability window
+	UPROPERTY(config, EditDefaultsOnly, Category = "Damage Queue Data")
+	bool _combineHitsInFrame;
+
+private:
+	struct FQueuedDamage
+	{
+		TWeakObjectPtr<AActor> Target;
+		TWeakObjectPtr<AActor> AttackedBy;
+		float Damage;
+	};
+
+	struct FTargetDamage
+	{
+		AActor* Target;
+		IDamageable* Damageable;
+		AActor* AttackedBy;
+		float Damage;
+	};
+
+	TArray<FQueuedDamage> _queuedDamage;
+
+	// Scratch arrays reused every flush
+	TArray<FTargetDamage> _targetDamage;
+	TMap<AActor*, int32> _targetIndices;
+	TArray<IDamageable*> _killedTargets;
+
+	//Functions
+public:
+	void Enqueue(AActor* target, AActor* attackedBy, float damage);
+
+	void Flush();
+
+	// Drops this frame's hits without applying them
+	void ClearQueue();
+
+protected:
+	virtual void Tick(float DeltaTime) override;
+
+	// Applies damage to the target's life system and lets it react, returns true if this killed it
+	static bool ApplyDamage(IDamageable* damageable, AActor* attackedBy, float damage);
+};
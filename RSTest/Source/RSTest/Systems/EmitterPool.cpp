@@ -0,0 +1,172 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EmitterPool.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Systems/WorldManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogEmitterPool, Log, All);
+
+static FAutoConsoleCommandWithWorld GEmitterPoolStatsCommand(
+	TEXT("RSTest.EmitterPool.Stats"),
+	TEXT("Logs per-template usage and skip/recycle counters for the emitter pool of the current world"),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* world)
+	{
+		if (AEmitterPool* pool = GetWorldManager<AEmitterPool>(world, false))
+		{
+			pool->LogStats();
+		}
+	})
+);
+
+AEmitterPool::AEmitterPool()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+
+	_defaultMaxComponents = 16;
+	_exhaustedPolicy = EEmitterPoolExhaustedPolicy::EPE_RecycleOldest;
+
+	_reuseCount = 0;
+	_skippedCount = 0;
+	_recycledCount = 0;
+}
+
+AEmitterPool* AEmitterPool::Get(const UObject* worldContextObject)
+{
+	return GetWorldManager<AEmitterPool>(worldContextObject);
+}
+
+void AEmitterPool::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	LogStats();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+UParticleSystemComponent* AEmitterPool::AcquireEmitter(UParticleSystem* emitterTemplate, const FVector& location, const FRotator& rotation)
+{
+	if (!emitterTemplate)
+	{
+		return nullptr;
+	}
+
+	FTemplatePool& templatePool = FindOrAddTemplatePool(emitterTemplate);
+
+	UParticleSystemComponent* component = nullptr;
+	while (templatePool.Free.Num() > 0 && !component)
+	{
+		component = templatePool.Free.Pop(false);
+		if (component && component->IsPendingKill())
+		{
+			component = nullptr;
+		}
+	}
+
+	if (component)
+	{
+		_reuseCount++;
+	}
+	else if (templatePool.Active.Num() < templatePool.MaxComponents)
+	{
+		component = CreatePooledEmitter(emitterTemplate);
+	}
+	else if (_exhaustedPolicy == EEmitterPoolExhaustedPolicy::EPE_RecycleOldest && templatePool.Active.Num() > 0)
+	{
+		// Taken out of Active first so a finished callback fired by the reset below can't hand it back to the free list
+		component = templatePool.Active[0];
+		templatePool.Active.RemoveAt(0, 1, false);
+		_recycledCount++;
+	}
+	else
+	{
+		_skippedCount++;
+		return nullptr;
+	}
+
+	if (!component)
+	{
+		return nullptr;
+	}
+
+	component->SetWorldLocationAndRotation(location, rotation);
+	component->SetHiddenInGame(false);
+	component->ActivateSystem(true);
+	templatePool.Active.Add(component);
+
+	return component;
+}
+
+AEmitterPool::FTemplatePool& AEmitterPool::FindOrAddTemplatePool(UParticleSystem* emitterTemplate)
+{
+	for (FTemplatePool& templatePool : _templatePools)
+	{
+		if (templatePool.Template == emitterTemplate)
+		{
+			return templatePool;
+		}
+	}
+
+	FTemplatePool newPool;
+	newPool.Template = emitterTemplate;
+	newPool.MaxComponents = _defaultMaxComponents;
+
+	const FSoftObjectPath templatePath(emitterTemplate);
+	for (const FEmitterPoolCap& cap : _templateCaps)
+	{
+		if (cap.Template.ToSoftObjectPath() == templatePath)
+		{
+			newPool.MaxComponents = FMath::Max(cap.MaxComponents, 1);
+			break;
+		}
+	}
+
+	return _templatePools[_templatePools.Add(newPool)];
+}
+
+UParticleSystemComponent* AEmitterPool::CreatePooledEmitter(UParticleSystem* emitterTemplate)
+{
+	UParticleSystemComponent* component = NewObject<UParticleSystemComponent>(this);
+	component->bAutoActivate = false;
+	component->bAutoDestroy = false;
+	component->SetTemplate(emitterTemplate);
+	component->OnSystemFinished.AddDynamic(this, &AEmitterPool::OnEmitterFinished);
+	component->RegisterComponent();
+
+	_pooledComponents.Add(component);
+	return component;
+}
+
+void AEmitterPool::OnEmitterFinished(UParticleSystemComponent* finishedComponent)
+{
+	if (!finishedComponent)
+	{
+		return;
+	}
+
+	for (FTemplatePool& templatePool : _templatePools)
+	{
+		if (templatePool.Template == finishedComponent->Template && templatePool.Active.Remove(finishedComponent) > 0)
+		{
+			finishedComponent->SetHiddenInGame(true);
+			templatePool.Free.Add(finishedComponent);
+			return;
+		}
+	}
+}
+
+void AEmitterPool::LogStats() const
+{
+	UE_LOG(LogEmitterPool, Log, TEXT("Emitter pool: %d components, %d reuses, %d recycled, %d skipped"),
+		_pooledComponents.Num(), _reuseCount, _recycledCount, _skippedCount);
+
+	for (const FTemplatePool& templatePool : _templatePools)
+	{
+		UE_LOG(LogEmitterPool, Log, TEXT("  %s: %d active, %d free, cap %d"),
+			*GetNameSafe(templatePool.Template), templatePool.Active.Num(), templatePool.Free.Num(), templatePool.MaxComponents);
+	}
+}
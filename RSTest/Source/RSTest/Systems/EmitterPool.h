@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "EmitterPool.generated.h"
+
+class UParticleSystem;
+class UParticleSystemComponent;
+
+UENUM(BlueprintType)
+enum class EEmitterPoolExhaustedPolicy : uint8
+{
+	EPE_Skip 			UMETA(DisplayName = "Skip New Effect"),
+	EPE_RecycleOldest 	UMETA(DisplayName = "Recycle Oldest"),
+};
+
+USTRUCT()
+struct FEmitterPoolCap
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "Emitter Pool Data")
+	TSoftObjectPtr<UParticleSystem> Template;
+
+	UPROPERTY(EditAnywhere, Category = "Emitter Pool Data", meta = (ClampMin = 1))
+	int32 MaxComponents;
+
+	FEmitterPoolCap() : MaxComponents(16) {}
+};
+
+/**
+ * Reusable particle system components, so effects played every few frames don't allocate and register a component each time.
+ * Each template has a cap on how many components it may own, which puts an upper bound on what the effect can cost.
+ * One pool exists per world, get it through AEmitterPool::Get.
+ */
+UCLASS(config=Game, notplaceable)
+class RSTEST_API AEmitterPool : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AEmitterPool();
+
+	static AEmitterPool* Get(const UObject* worldContextObject);
+
+	//Variables
+protected:
+	// Cap for templates that aren't listed in _templateCaps
+	UPROPERTY(config, EditDefaultsOnly, Category = "Emitter Pool Data", meta = (ClampMin = 1))
+	int32 _defaultMaxComponents;
+
+	UPROPERTY(config, EditDefaultsOnly, Category = "Emitter Pool Data")
+	TArray<FEmitterPoolCap> _templateCaps;
+
+	// What happens when every component of a template is in use
+	UPROPERTY(config, EditDefaultsOnly, Category = "Emitter Pool Data")
+	EEmitterPoolExhaustedPolicy _exhaustedPolicy;
+
+private:
+	struct FTemplatePool
+	{
+		UParticleSystem* Template;
+		int32 MaxComponents;
+		TArray<UParticleSystemComponent*> Free;
+		TArray<UParticleSystemComponent*> Active; // Oldest first
+	};
+
+	// Every component owned by the pool - keeps them, and through them the templates, referenced for GC
+	UPROPERTY(Transient)
+	TArray<UParticleSystemComponent*> _pooledComponents;
+
+	TArray<FTemplatePool> _templatePools;
+
+	int32 _reuseCount;
+	int32 _skippedCount;
+	int32 _recycledCount;
+
+	//GettersAndSetters
+public:
+	UFUNCTION(BlueprintCallable, Category = "Emitter Pool GetSet")
+	int32 GetPooledCount() const { return _pooledComponents.Num(); }
+
+	UFUNCTION(BlueprintCallable, Category = "Emitter Pool GetSet")
+	int32 GetSkippedCount() const { return _skippedCount; }
+
+	UFUNCTION(BlueprintCallable, Category = "Emitter Pool GetSet")
+	int32 GetRecycledCount() const { return _recycledCount; }
+
+	//Functions
+public:
+	// Plays the template at the given transform. Returns nullptr if its cap is reached and the policy is to skip.
+	// The component goes back to the pool by itself when the system finishes, so don't hold on to it past that
+	UParticleSystemComponent* AcquireEmitter(UParticleSystem* emitterTemplate, const FVector& location, const FRotator& rotation = FRotator::ZeroRotator);
+
+	void LogStats() const;
+
+protected:
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	FTemplatePool& FindOrAddTemplatePool(UParticleSystem* emitterTemplate);
+
+	UParticleSystemComponent* CreatePooledEmitter(UParticleSystem* emitterTemplate);
+
+	UFUNCTION()
+	void OnEmitterFinished(UParticleSystemComponent* finishedComponent);
+};
@@ -0,0 +1,434 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EnemyDirector.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "TimerManager.h"
+#include "RSTestStats.h"
+#include "Enemies/BaseEnemy.h"
+#include "Systems/AssetPreloader.h"
+#include "Systems/EnemyWaveData.h"
+#include "Systems/WorldManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogEnemyDirector, Log, All);
+
+static FAutoConsoleCommandWithWorld GEnemyDirectorStatsCommand(
+	TEXT("RSTest.Enemies.Stats"),
+	TEXT("Logs wave progress and pool counters for the enemy director of the current world"),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* world)
+	{
+		if (AEnemyDirector* director = GetWorldManager<AEnemyDirector>(world, false))
+		{
+			director->LogStats();
+		}
+	})
+);
+
+AEnemyDirector::AEnemyDirector()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	bReplicates = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+
+	_waveData = nullptr;
+	_autoStartWaves = true;
+	_activationsPerFrame = 4;
+
+	_isReady = false;
+	_currentWave = -1;
+	_nextWaveTime = -1.f;
+
+	_activeCount = 0;
+	_poolMisses = 0;
+	_highWaterMark = 0;
+
+	_anchorTraceWindowCount = 0;
+	_anchorTraceWindowStart = 0.f;
+	_anchorTraceRate = 0.f;
+}
+
+AEnemyDirector* AEnemyDirector::Get(const UObject* worldContextObject)
+{
+	return GetWorldManager<AEnemyDirector>(worldContextObject);
+}
+
+void AEnemyDirector::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// On a timer rather than when traces are added, so a quiet second reads as 0 instead of keeping the last busy one
+	_anchorTraceWindowStart = GetWorld()->GetTimeSeconds();
+	GetWorldTimerManager().SetTimer(_anchorTraceRateHandle, this, &AEnemyDirector::SampleAnchorTraceRate, 1.f, true);
+
+	// Enemies are spawned by the server and replicated, a client's copy of the director stays idle
+	if (!_waveData || GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	TArray<FSoftObjectPath> enemyClasses;
+	for (const FEnemyWave& wave : _waveData->Waves)
+	{
+		for (const FEnemyWaveSpawn& spawn : wave.Spawns)
+		{
+			enemyClasses.AddUnique(spawn.EnemyClass.ToSoftObjectPath());
+
+			if (!_spawnPoints.Contains(spawn.SpawnPointTag))
+			{
+				TArray<AActor*> taggedActors;
+				if (!spawn.SpawnPointTag.IsNone())
+				{
+					UGameplayStatics::GetAllActorsWithTag(this, spawn.SpawnPointTag, taggedActors);
+				}
+
+				TArray<TWeakObjectPtr<AActor>>& spawnPoints = _spawnPoints.Add(spawn.SpawnPointTag);
+				for (AActor* taggedActor : taggedActors)
+				{
+					spawnPoints.Add(taggedActor);
+				}
+			}
+		}
+	}
+
+	if (AAssetPreloader* preloader = AAssetPreloader::Get(this))
+	{
+		preloader->PreloadGroup(TEXT("EnemyWaves"), enemyClasses, FStreamableDelegate::CreateUObject(this, &AEnemyDirector::OnWaveClassesLoaded));
+	}
+	else
+	{
+		OnWaveClassesLoaded();
+	}
+}
+
+void AEnemyDirector::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	LogStats();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AEnemyDirector::SampleAnchorTraceRate()
+{
+	const float worldTime = GetWorld()->GetTimeSeconds();
+	const float elapsed = worldTime - _anchorTraceWindowStart;
+	if (elapsed > 0.f)
+	{
+		_anchorTraceRate = _anchorTraceWindowCount / elapsed;
+		SET_FLOAT_STAT(STAT_ChannelerAnchorTracesPerSecond, _anchorTraceRate);
+	}
+
+	_anchorTraceWindowCount = 0;
+	_anchorTraceWindowStart = worldTime;
+}
+
+void AEnemyDirector::OnWaveClassesLoaded()
+{
+	TMap<FSoftObjectPath, int32> peakCounts;
+	_waveData->GetPeakEnemyCounts(peakCounts);
+
+	// Spawning is the expensive part, get it all done now rather than when a wave starts
+	const double prewarmStartTime = FPlatformTime::Seconds();
+	for (const TPair<FSoftObjectPath, int32>& peakCount : peakCounts)
+	{
+		Prewarm(TSoftClassPtr<ABaseEnemy>(peakCount.Key).LoadSynchronous(), peakCount.Value);
+	}
+
+	UE_LOG(LogEnemyDirector, Log, TEXT("Enemy director: pre-spawned %d enemies in %.2f ms"),
+		_pooledEnemies.Num(), (FPlatformTime::Seconds() - prewarmStartTime) * 1000.0);
+
+	_isReady = true;
+	SetActorTickEnabled(true);
+
+	if (_autoStartWaves)
+	{
+		ScheduleNextWave();
+	}
+}
+
+void AEnemyDirector::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	ProcessPendingActivations();
+
+	if (_nextWaveTime >= 0.f && GetWorld()->GetTimeSeconds() >= _nextWaveTime)
+	{
+		_nextWaveTime = -1.f;
+		StartNextWave();
+	}
+}
+
+bool AEnemyDirector::StartWave(int32 waveIndex)
+{
+	if (!_waveData || !_waveData->Waves.IsValidIndex(waveIndex))
+	{
+		return false;
+	}
+
+	_currentWave = waveIndex;
+	_nextWaveTime = -1.f;
+
+	for (const FEnemyWaveSpawn& spawn : _waveData->Waves[waveIndex].Spawns)
+	{
+		UClass* enemyClass = spawn.EnemyClass.Get();
+		if (!enemyClass)
+		{
+			continue;
+		}
+
+		for (int32 i = 0; i < spawn.Count; i++)
+		{
+			FPendingActivation activation;
+			activation.EnemyClass = enemyClass;
+			activation.SpawnPointTag = spawn.SpawnPointTag;
+			_pendingActivations.Add(activation);
+		}
+	}
+
+	UE_LOG(LogEnemyDirector, Log, TEXT("Enemy director: starting wave %d with %d enemies"), waveIndex, _pendingActivations.Num());
+	return true;
+}
+
+void AEnemyDirector::ScheduleNextWave()
+{
+	const int32 nextWave = _currentWave + 1;
+	if (_waveData && _waveData->Waves.IsValidIndex(nextWave))
+	{
+		_nextWaveTime = GetWorld()->GetTimeSeconds() + _waveData->Waves[nextWave].StartDelay;
+	}
+}
+
+void AEnemyDirector::ProcessPendingActivations()
+{
+	int32 activatedCount = 0;
+	while (activatedCount < _pendingActivations.Num() && activatedCount < _activationsPerFrame)
+	{
+		const FPendingActivation& activation = _pendingActivations[activatedCount];
+
+		FVector spawnLocation;
+		FRotator spawnRotation;
+		GetSpawnTransform(activation.EnemyClass, activation.SpawnPointTag, spawnLocation, spawnRotation);
+
+		// Spawn point is blocked, try again next frame (at the next point with the same tag)
+		if (!AcquireEnemy(activation.EnemyClass, spawnLocation, spawnRotation))
+		{
+			break;
+		}
+		activatedCount++;
+	}
+
+	if (activatedCount > 0)
+	{
+		_pendingActivations.RemoveAt(0, activatedCount, false);
+	}
+}
+
+void AEnemyDirector::GetSpawnTransform(UClass* enemyClass, FName spawnPointTag, FVector& outLocation, FRotator& outRotation)
+{
+	outLocation = GetActorLocation();
+	outRotation = GetActorRotation();
+
+	const TArray<TWeakObjectPtr<AActor>>* spawnPoints = _spawnPoints.Find(spawnPointTag);
+	if (spawnPoints && spawnPoints->Num() > 0)
+	{
+		int32& nextSpawnPoint = _nextSpawnPoints.FindOrAdd(spawnPointTag);
+		const AActor* spawnPoint = (*spawnPoints)[nextSpawnPoint % spawnPoints->Num()].Get();
+		nextSpawnPoint = (nextSpawnPoint + 1) % spawnPoints->Num();
+
+		if (spawnPoint)
+		{
+			outLocation = spawnPoint->GetActorLocation();
+			outRotation = FRotator(0.f, spawnPoint->GetActorRotation().Yaw, 0.f);
+		}
+	}
+
+	// Spawn points sit on the floor, the capsule's centre goes above them
+	if (const ABaseEnemy* enemyDefaults = enemyClass->GetDefaultObject<ABaseEnemy>())
+	{
+		outLocation.Z += enemyDefaults->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	}
+}
+
+void AEnemyDirector::Prewarm(TSubclassOf<ABaseEnemy> enemyClass, int32 count)
+{
+	if (!enemyClass)
+	{
+		return;
+	}
+
+	TArray<ABaseEnemy*>& freeList = _freeEnemies.FindOrAdd(enemyClass);
+	while (freeList.Num() < count)
+	{
+		ABaseEnemy* enemy = SpawnPooledEnemy(enemyClass);
+		if (!enemy)
+		{
+			break;
+		}
+		freeList.Add(enemy);
+	}
+}
+
+ABaseEnemy* AEnemyDirector::AcquireEnemy(TSubclassOf<ABaseEnemy> enemyClass, const FVector& location, const FRotator& rotation)
+{
+	if (!enemyClass)
+	{
+		return nullptr;
+	}
+
+	ABaseEnemy* enemy = nullptr;
+
+	TArray<ABaseEnemy*>& freeList = _freeEnemies.FindOrAdd(enemyClass);
+	while (freeList.Num() > 0 && !enemy)
+	{
+		enemy = freeList.Pop(false);
+		if (enemy && enemy->IsPendingKill())
+		{
+			enemy = nullptr;
+		}
+	}
+
+	if (!enemy)
+	{
+		_poolMisses++;
+		enemy = SpawnPooledEnemy(enemyClass);
+		if (!enemy)
+		{
+			return nullptr;
+		}
+	}
+
+	if (!enemy->ActivateFromPool(location, rotation))
+	{
+		freeList.Add(enemy);
+		return nullptr;
+	}
+
+	_activeCount++;
+	_highWaterMark = FMath::Max(_highWaterMark, _activeCount);
+
+	return enemy;
+}
+
+void AEnemyDirector::ReleaseEnemy(ABaseEnemy* enemy)
+{
+	if (!enemy || !enemy->GetIsActiveInPool())
+	{
+		return;
+	}
+
+	enemy->DeactivateToPool();
+
+	_freeEnemies.FindOrAdd(enemy->GetClass()).Add(enemy);
+
+	OnActiveEnemyRemoved();
+}
+
+bool AEnemyDirector::WakeEnemy(ABaseEnemy* enemy, const FVector& location, const FRotator& rotation)
+{
+	if (!enemy || enemy->GetIsActiveInPool())
+	{
+		return false;
+	}
+
+	TArray<ABaseEnemy*>* freeList = _freeEnemies.Find(enemy->GetClass());
+	if (!freeList || freeList->RemoveSingleSwap(enemy, false) == 0)
+	{
+		return false;
+	}
+
+	if (!enemy->ActivateFromPool(location, rotation))
+	{
+		freeList->Add(enemy);
+		return false;
+	}
+
+	_activeCount++;
+	_highWaterMark = FMath::Max(_highWaterMark, _activeCount);
+
+	return true;
+}
+
+void AEnemyDirector::ForgetEnemy(ABaseEnemy* enemy)
+{
+	_pooledEnemies.RemoveSingleSwap(enemy, false);
+	if (TArray<ABaseEnemy*>* freeList = _freeEnemies.Find(enemy->GetClass()))
+	{
+		freeList->RemoveSingleSwap(enemy, false);
+	}
+
+	if (enemy->GetIsActiveInPool())
+	{
+		OnActiveEnemyRemoved();
+	}
+}
+
+void AEnemyDirector::OnActiveEnemyRemoved()
+{
+	_activeCount--;
+
+	if (_autoStartWaves && _activeCount == 0 && _pendingActivations.Num() == 0)
+	{
+		ScheduleNextWave();
+	}
+}
+
+ABaseEnemy* AEnemyDirector::SpawnPooledEnemy(UClass* enemyClass)
+{
+	UWorld* const world = GetWorld();
+	if (!world)
+	{
+		return nullptr;
+	}
+
+	// Deferred so the enemy knows it belongs to the director before BeginPlay
+	ABaseEnemy* enemy = world->SpawnActorDeferred<ABaseEnemy>(
+		enemyClass,
+		GetActorTransform(),
+		nullptr,
+		nullptr,
+		ESpawnActorCollisionHandlingMethod::AlwaysSpawn
+		);
+
+	if (enemy)
+	{
+		enemy->SetOwnerDirector(this);
+		enemy->FinishSpawning(GetActorTransform());
+
+		// Spawned enemies only get a controller automatically if their class asks for one, the pool needs it either way
+		if (!enemy->GetController())
+		{
+			enemy->SpawnDefaultController();
+		}
+
+		enemy->DeactivateToPool();
+		_pooledEnemies.Add(enemy);
+	}
+
+	return enemy;
+}
+
+void AEnemyDirector::CaptureWaveState(FWaveState& outState) const
+{
+	outState.CurrentWave = _currentWave;
+	outState.NextWaveDelay = _nextWaveTime >= 0.f ? FMath::Max(_nextWaveTime - GetWorld()->GetTimeSeconds(), 0.f) : -1.f;
+	outState.PendingActivations = _pendingActivations;
+	outState.NextSpawnPoints = _nextSpawnPoints;
+}
+
+void AEnemyDirector::RestoreWaveState(const FWaveState& state)
+{
+	_currentWave = state.CurrentWave;
+	_nextWaveTime = state.NextWaveDelay >= 0.f ? GetWorld()->GetTimeSeconds() + state.NextWaveDelay : -1.f;
+	_pendingActivations = state.PendingActivations;
+	_nextSpawnPoints = state.NextSpawnPoints;
+}
+
+void AEnemyDirector::LogStats() const
+{
+	UE_LOG(LogEnemyDirector, Log, TEXT("Enemy director: wave %d, %d pooled, %d active, %d waiting to activate, %d misses, %d high-water"),
+		_currentWave, _pooledEnemies.Num(), _activeCount, _pendingActivations.Num(), _poolMisses, _highWaterMark);
+}
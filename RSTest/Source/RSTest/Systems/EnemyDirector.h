@@ -0,0 +1,157 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "EnemyDirector.generated.h"
+
+class ABaseEnemy;
+class UEnemyWaveData;
+
+/**
+ * Runs the waves in a UEnemyWaveData. Every enemy class the waves use is streamed in and pre-spawned asleep while the map loads,
+ * as many of each as the biggest wave needs. Waves then wake pooled enemies up a few per frame, and killed enemies go back
+ * to sleep in the pool instead of being destroyed. One per world, place one in a map and give it wave data to use it.
+ */
+UCLASS(config=Game)
+class RSTEST_API AEnemyDirector : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AEnemyDirector();
+
+	static AEnemyDirector* Get(const UObject* worldContextObject);
+
+	//Variables
+protected:
+	UPROPERTY(EditAnywhere, Category = "Enemy Director Data")
+	UEnemyWaveData* _waveData;
+
+	// Start the first wave once the pools are ready, and every following one once the previous is cleared
+	UPROPERTY(EditAnywhere, Category = "Enemy Director Data")
+	bool _autoStartWaves;
+
+	// Pooled enemies woken up per frame, a wave bigger than this appears over a few frames
+	UPROPERTY(config, EditAnywhere, Category = "Enemy Director Data", meta = (ClampMin = 1))
+	int32 _activationsPerFrame;
+
+private:
+	struct FPendingActivation
+	{
+		UClass* EnemyClass;
+		FName SpawnPointTag;
+	};
+
+	// Every enemy owned by the director, awake or not - keeps them referenced for GC
+	UPROPERTY(Transient)
+	TArray<ABaseEnemy*> _pooledEnemies;
+
+	TMap<UClass*, TArray<ABaseEnemy*>> _freeEnemies;
+
+	TArray<FPendingActivation> _pendingActivations;
+
+	TMap<FName, TArray<TWeakObjectPtr<AActor>>> _spawnPoints;
+	TMap<FName, int32> _nextSpawnPoints;
+
+	bool _isReady;
+	int32 _currentWave;
+	float _nextWaveTime; // Negative when no wave is scheduled
+
+	int32 _activeCount;
+	int32 _poolMisses;
+	int32 _highWaterMark;
+
+	// Channeler anchor traces in this world, sampled into a rate once a second so it drops back to 0 when they stop
+	int32 _anchorTraceWindowCount;
+	float _anchorTraceWindowStart;
+	float _anchorTraceRate;
+	FTimerHandle _anchorTraceRateHandle;
+
+	//GettersAndSetters
+public:
+	UFUNCTION(BlueprintCallable, Category = "Enemy Director GetSet")
+	bool GetIsReady() const { return _isReady; }
+
+	// Without wave data the director never gets ready, there's nothing for it to do
+	UFUNCTION(BlueprintCallable, Category = "Enemy Director GetSet")
+	bool GetHasWaveData() const { return _waveData != nullptr; }
+
+	UFUNCTION(BlueprintCallable, Category = "Enemy Director GetSet")
+	int32 GetCurrentWave() const { return _currentWave; }
+
+	UFUNCTION(BlueprintCallable, Category = "Enemy Director GetSet")
+	int32 GetActiveCount() const { return _activeCount; }
+
+	UFUNCTION(BlueprintCallable, Category = "Enemy Director GetSet")
+	int32 GetPooledCount() const { return _pooledEnemies.Num(); }
+
+	UFUNCTION(BlueprintCallable, Category = "Enemy Director GetSet")
+	float GetAnchorTraceRate() const { return _anchorTraceRate; }
+
+	//Functions
+public:
+	// Queues every enemy of the wave for activation, returns false if there's no such wave
+	UFUNCTION(BlueprintCallable, Category = "Enemy Director")
+	bool StartWave(int32 waveIndex);
+
+	UFUNCTION(BlueprintCallable, Category = "Enemy Director")
+	bool StartNextWave() { return StartWave(_currentWave + 1); }
+
+	// Fills the pool up to count sleeping enemies of the given class
+	void Prewarm(TSubclassOf<ABaseEnemy> enemyClass, int32 count);
+
+	// Wakes up a pooled enemy (spawning one if the pool is empty), returns nullptr if it couldn't be placed
+	ABaseEnemy* AcquireEnemy(TSubclassOf<ABaseEnemy> enemyClass, const FVector& location, const FRotator& rotation);
+
+	void ReleaseEnemy(ABaseEnemy* enemy);
+
+	// Wakes up this particular pooled enemy, returns false if it isn't asleep in the pool or couldn't be placed
+	bool WakeEnemy(ABaseEnemy* enemy, const FVector& location, const FRotator& rotation);
+
+	// Called when a pooled enemy gets destroyed by something other than the director
+	void ForgetEnemy(ABaseEnemy* enemy);
+
+	void AddAnchorTraces(int32 count) { _anchorTraceWindowCount += count; }
+
+	void LogStats() const;
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	void OnWaveClassesLoaded();
+
+	void ProcessPendingActivations();
+
+	void ScheduleNextWave();
+
+	// Called whenever an awake enemy leaves play (released to the pool or destroyed), moves on to the next wave once none are left
+	void OnActiveEnemyRemoved();
+
+	void GetSpawnTransform(UClass* enemyClass, FName spawnPointTag, FVector& outLocation, FRotator& outRotation);
+
+	ABaseEnemy* SpawnPooledEnemy(UClass* enemyClass);
+
+	void SampleAnchorTraceRate();
+
+	//Snapshot
+public:
+	// Wave progress, captured and put back by the arena snapshot. Which enemies are awake is restored enemy by enemy
+	struct FWaveState
+	{
+		int32 CurrentWave;
+		float NextWaveDelay; // Negative when no wave is scheduled
+		TArray<FPendingActivation> PendingActivations;
+		TMap<FName, int32> NextSpawnPoints;
+	};
+
+	void CaptureWaveState(FWaveState& outState) const;
+
+	// Call after the enemies have been woken or released, releasing the last one schedules a wave of its own
+	void RestoreWaveState(const FWaveState& state);
+};
@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EnemyWaveData.h"
+#include "Enemies/BaseEnemy.h"
+
+void UEnemyWaveData::GetPeakEnemyCounts(TMap<FSoftObjectPath, int32>& outPeakCounts) const
+{
+	TMap<FSoftObjectPath, int32> waveCounts;
+	for (const FEnemyWave& wave : Waves)
+	{
+		waveCounts.Reset();
+		for (const FEnemyWaveSpawn& spawn : wave.Spawns)
+		{
+			if (!spawn.EnemyClass.IsNull())
+			{
+				waveCounts.FindOrAdd(spawn.EnemyClass.ToSoftObjectPath()) += spawn.Count;
+			}
+		}
+
+		for (const TPair<FSoftObjectPath, int32>& waveCount : waveCounts)
+		{
+			int32& peakCount = outPeakCounts.FindOrAdd(waveCount.Key);
+			peakCount = FMath::Max(peakCount, waveCount.Value);
+		}
+	}
+}
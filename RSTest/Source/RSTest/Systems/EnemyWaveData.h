@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "EnemyWaveData.generated.h"
+
+class ABaseEnemy;
+
+USTRUCT(BlueprintType)
+struct FEnemyWaveSpawn
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Enemy Wave Data")
+	TSoftClassPtr<ABaseEnemy> EnemyClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Enemy Wave Data", meta = (ClampMin = 1))
+	int32 Count;
+
+	// Enemies appear at level actors with this tag, taking turns between them
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Enemy Wave Data")
+	FName SpawnPointTag;
+
+	FEnemyWaveSpawn() : Count(1) {}
+};
+
+USTRUCT(BlueprintType)
+struct FEnemyWave
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Enemy Wave Data")
+	TArray<FEnemyWaveSpawn> Spawns;
+
+	// Seconds between the previous wave being cleared (or the director starting) and this one appearing
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Enemy Wave Data", meta = (ClampMin = 0))
+	float StartDelay;
+
+	FEnemyWave() : StartDelay(2.f) {}
+};
+
+/**
+ * The waves an AEnemyDirector runs through, in order.
+ */
+UCLASS(BlueprintType)
+class RSTEST_API UEnemyWaveData : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Enemy Wave Data")
+	TArray<FEnemyWave> Waves;
+
+	//Functions
+public:
+	// The most enemies of each class any single wave asks for, which is how many of each the director keeps pooled
+	void GetPeakEnemyCounts(TMap<FSoftObjectPath, int32>& outPeakCounts) const;
+};
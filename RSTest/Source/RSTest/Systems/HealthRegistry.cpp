@@ -0,0 +1,271 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HealthRegistry.h"
+#include "Engine/World.h"
+#include "Components/LifeSystem.h"
+#include "Systems/WorldManager.h"
+
+AHealthRegistry::AHealthRegistry()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+}
+
+AHealthRegistry* AHealthRegistry::Get(const UObject* worldContextObject)
+{
+	return GetWorldManager<AHealthRegistry>(worldContextObject);
+}
+
+int32 AHealthRegistry::Resolve(const FHealthHandle& handle) const
+{
+	if (!_slotGenerations.IsValidIndex(handle.Slot) || _slotGenerations[handle.Slot] != handle.Generation)
+	{
+		return INDEX_NONE;
+	}
+	return _slotToDense[handle.Slot];
+}
+
+float AHealthRegistry::GetWorldTime() const
+{
+	const UWorld* world = GetWorld();
+	return world ? world->GetTimeSeconds() : 0.f;
+}
+
+FHealthHandle AHealthRegistry::Register(ULifeSystem* owner, float maxHealth, float invulnerabilityWindow)
+{
+	const int32 denseIndex = _health.Num();
+
+	int32 slot;
+	if (_freeSlots.Num() > 0)
+	{
+		slot = _freeSlots.Pop(false);
+		_slotToDense[slot] = denseIndex;
+	}
+	else
+	{
+		slot = _slotToDense.Add(denseIndex);
+		_slotGenerations.Add(0);
+	}
+
+	_health.Add(maxHealth);
+	_maxHealth.Add(maxHealth);
+	_invulnerableUntil.Add(0.f);
+	_invulnerabilityWindow.Add(invulnerabilityWindow);
+	_isDead.Add(maxHealth <= 0.f); // In case they start at 0 health
+	_owners.Add(owner);
+	_denseToSlot.Add(slot);
+
+	FHealthHandle handle;
+	handle.Slot = slot;
+	handle.Generation = _slotGenerations[slot];
+	return handle;
+}
+
+void AHealthRegistry::Unregister(FHealthHandle& handle)
+{
+	const int32 denseIndex = Resolve(handle);
+	if (denseIndex == INDEX_NONE)
+	{
+		handle = FHealthHandle();
+		return;
+	}
+
+	// The last entry moves into the removed one's place, so its slot has to follow it
+	const int32 lastIndex = _health.Num() - 1;
+	_slotToDense[_denseToSlot[lastIndex]] = denseIndex;
+
+	_health.RemoveAtSwap(denseIndex, 1, false);
+	_maxHealth.RemoveAtSwap(denseIndex, 1, false);
+	_invulnerableUntil.RemoveAtSwap(denseIndex, 1, false);
+	_invulnerabilityWindow.RemoveAtSwap(denseIndex, 1, false);
+	_isDead.RemoveAtSwap(denseIndex, 1, false);
+	_owners.RemoveAtSwap(denseIndex, 1, false);
+	_denseToSlot.RemoveAtSwap(denseIndex, 1, false);
+
+	_slotToDense[handle.Slot] = INDEX_NONE;
+	_slotGenerations[handle.Slot]++;
+	_freeSlots.Add(handle.Slot);
+
+	handle = FHealthHandle();
+}
+
+void AHealthRegistry::ResetEntry(const FHealthHandle& handle)
+{
+	const int32 denseIndex = Resolve(handle);
+	if (denseIndex != INDEX_NONE)
+	{
+		const float oldHealth = _health[denseIndex];
+		const bool wasDead = _isDead[denseIndex];
+
+		_health[denseIndex] = _maxHealth[denseIndex];
+		_invulnerableUntil[denseIndex] = 0.f;
+		_isDead[denseIndex] = _maxHealth[denseIndex] <= 0.f;
+
+		NotifyOwner(denseIndex, oldHealth, wasDead);
+	}
+}
+
+float AHealthRegistry::GetHealth(const FHealthHandle& handle) const
+{
+	const int32 denseIndex = Resolve(handle);
+	return denseIndex != INDEX_NONE ? _health[denseIndex] : 0.f;
+}
+
+void AHealthRegistry::SetHealth(const FHealthHandle& handle, float newHealth)
+{
+	const int32 denseIndex = Resolve(handle);
+	if (denseIndex != INDEX_NONE)
+	{
+		const float oldHealth = _health[denseIndex];
+		_health[denseIndex] = newHealth;
+		NotifyOwner(denseIndex, oldHealth, _isDead[denseIndex]);
+	}
+}
+
+void AHealthRegistry::SetReplicatedState(const FHealthHandle& handle, float newHealth, bool isDead)
+{
+	const int32 denseIndex = Resolve(handle);
+	if (denseIndex != INDEX_NONE)
+	{
+		const float oldHealth = _health[denseIndex];
+		const bool wasDead = _isDead[denseIndex];
+
+		_health[denseIndex] = newHealth;
+		_isDead[denseIndex] = isDead;
+		NotifyOwner(denseIndex, oldHealth, wasDead);
+	}
+}
+
+void AHealthRegistry::AddHealth(const FHealthHandle& handle, float amount)
+{
+	const int32 denseIndex = Resolve(handle);
+	if (denseIndex != INDEX_NONE)
+	{
+		const float oldHealth = _health[denseIndex];
+		_health[denseIndex] = FMath::Clamp(_health[denseIndex] + amount, 0.f, _maxHealth[denseIndex]);
+		NotifyOwner(denseIndex, oldHealth, _isDead[denseIndex]);
+	}
+}
+
+float AHealthRegistry::GetMaxHealth(const FHealthHandle& handle) const
+{
+	const int32 denseIndex = Resolve(handle);
+	return denseIndex != INDEX_NONE ? _maxHealth[denseIndex] : 0.f;
+}
+
+bool AHealthRegistry::GetIsDead(const FHealthHandle& handle) const
+{
+	const int32 denseIndex = Resolve(handle);
+	return denseIndex != INDEX_NONE && _isDead[denseIndex];
+}
+
+bool AHealthRegistry::GetIsInvulnerable(const FHealthHandle& handle) const
+{
+	const int32 denseIndex = Resolve(handle);
+	return denseIndex != INDEX_NONE && GetWorldTime() < _invulnerableUntil[denseIndex];
+}
+
+bool AHealthRegistry::ApplyDamage(const FHealthHandle& handle, float damageAmount)
+{
+	const int32 denseIndex = Resolve(handle);
+	if (denseIndex == INDEX_NONE || _isDead[denseIndex])
+	{
+		return false;
+	}
+
+	const float worldTime = GetWorldTime();
+	if (worldTime < _invulnerableUntil[denseIndex])
+	{
+		return false;
+	}
+
+	const float oldHealth = _health[denseIndex];
+	_health[denseIndex] = FMath::Max(_health[denseIndex] - damageAmount, 0.f);
+
+	const bool killed = _health[denseIndex] <= 0.f;
+	if (killed)
+	{
+		_isDead[denseIndex] = true;
+	}
+	else
+	{
+		_invulnerableUntil[denseIndex] = worldTime + _invulnerabilityWindow[denseIndex];
+	}
+
+	NotifyOwner(denseIndex, oldHealth, false);
+	return killed;
+}
+
+void AHealthRegistry::RegenerateAll(float amount)
+{
+	// Listeners are told after the pass, one of them unregistering mid-loop would shuffle the arrays
+	TArray<TPair<TWeakObjectPtr<ULifeSystem>, float>, TInlineAllocator<16>> changedOwners;
+
+	const int32 entryCount = _health.Num();
+	for (int32 i = 0; i < entryCount; i++)
+	{
+		if (!_isDead[i] && _health[i] < _maxHealth[i])
+		{
+			changedOwners.Emplace(_owners[i], _health[i]);
+			_health[i] = FMath::Min(_health[i] + amount, _maxHealth[i]);
+		}
+	}
+
+	for (const TPair<TWeakObjectPtr<ULifeSystem>, float>& changedOwner : changedOwners)
+	{
+		if (ULifeSystem* lifeSystem = changedOwner.Key.Get())
+		{
+			lifeSystem->BroadcastHealthChanged(lifeSystem->GetHealth(), changedOwner.Value, false);
+		}
+	}
+}
+
+void AHealthRegistry::NotifyOwner(int32 denseIndex, float oldHealth, bool wasDead)
+{
+	const bool died = _isDead[denseIndex] && !wasDead;
+	if (_health[denseIndex] == oldHealth && !died)
+	{
+		return;
+	}
+
+	if (ULifeSystem* lifeSystem = _owners[denseIndex].Get())
+	{
+		lifeSystem->BroadcastHealthChanged(_health[denseIndex], oldHealth, died);
+	}
+}
+
+void AHealthRegistry::GetBelowHealth(float healthThreshold, TArray<ULifeSystem*>& outLifeSystems) const
+{
+	outLifeSystems.Reset();
+
+	const int32 entryCount = _health.Num();
+	for (int32 i = 0; i < entryCount; i++)
+	{
+		if (!_isDead[i] && _health[i] <= healthThreshold)
+		{
+			if (ULifeSystem* lifeSystem = _owners[i].Get())
+			{
+				outLifeSystems.Add(lifeSystem);
+			}
+		}
+	}
+}
+
+void AHealthRegistry::GetBelowHealthFraction(float healthFraction, TArray<ULifeSystem*>& outLifeSystems) const
+{
+	outLifeSystems.Reset();
+
+	const int32 entryCount = _health.Num();
+	for (int32 i = 0; i < entryCount; i++)
+	{
+		if (!_isDead[i] && _health[i] <= _maxHealth[i] * healthFraction)
+		{
+			if (ULifeSystem* lifeSystem = _owners[i].Get())
+			{
+				outLifeSystems.Add(lifeSystem);
+			}
+		}
+	}
+}
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "HealthRegistry.generated.h"
+
+class ULifeSystem;
+
+/** Identifies an entry in the health registry, stays safe to use after the entry is removed */
+struct FHealthHandle
+{
+	FHealthHandle() : Slot(INDEX_NONE), Generation(0) {}
+
+	bool IsSet() const { return Slot != INDEX_NONE; }
+
+	int32 Slot;
+	int32 Generation;
+};
+
+/**
+ * Health for everything that can take damage, kept in packed arrays so bulk updates and queries are linear scans.
+ * Invulnerability after a hit is a world time stamp instead of a timer. Entries are reached through FHealthHandle,
+ * which maps onto the dense arrays and survives other entries being swapped around on removal.
+ * ULifeSystem components register themselves and are just a view onto their entry. One per world, get it through AHealthRegistry::Get.
+ */
+UCLASS(notplaceable)
+class RSTEST_API AHealthRegistry : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AHealthRegistry();
+
+	UFUNCTION(BlueprintPure, Category = "Health Registry", meta = (WorldContext = "worldContextObject"))
+	static AHealthRegistry* Get(const UObject* worldContextObject);
+
+	//Variables
+private:
+	// Dense, one element per registered entry
+	TArray<float> _health;
+	TArray<float> _maxHealth;
+	TArray<float> _invulnerableUntil;
+	TArray<float> _invulnerabilityWindow;
+	TArray<bool> _isDead;
+	TArray<TWeakObjectPtr<ULifeSystem>> _owners;
+	TArray<int32> _denseToSlot;
+
+	// Sparse, indexed by FHealthHandle::Slot
+	TArray<int32> _slotToDense;
+	TArray<int32> _slotGenerations;
+	TArray<int32> _freeSlots;
+
+	//GettersAndSetters
+public:
+	UFUNCTION(BlueprintCallable, Category = "Health Registry GetSet")
+	int32 GetEntryCount() const { return _health.Num(); }
+
+	bool IsHandleValid(const FHealthHandle& handle) const { return Resolve(handle) != INDEX_NONE; }
+
+	float GetHealth(const FHealthHandle& handle) const;
+	void SetHealth(const FHealthHandle& handle, float newHealth);
+
+	// Adds (or with a negative amount removes) health, clamped between 0 and max health
+	void AddHealth(const FHealthHandle& handle, float amount);
+
+	float GetMaxHealth(const FHealthHandle& handle) const;
+
+	bool GetIsDead(const FHealthHandle& handle) const;
+
+	bool GetIsInvulnerable(const FHealthHandle& handle) const;
+
+	//Functions
+public:
+	FHealthHandle Register(ULifeSystem* owner, float maxHealth, float invulnerabilityWindow);
+
+	void Unregister(FHealthHandle& handle);
+
+	// Takes health and death as they are on the server, for clients' copies of replicated entries
+	void SetReplicatedState(const FHealthHandle& handle, float newHealth, bool isDead);
+
+	// Back to full health, alive and not invulnerable, for entries that are reused rather than re-registered
+	void ResetEntry(const FHealthHandle& handle);
+
+	// Returns true if this hit killed the entry. Hits during the invulnerability window after a previous hit are ignored
+	bool ApplyDamage(const FHealthHandle& handle, float damageAmount);
+
+	// Adds health to every living entry, up to their max
+	UFUNCTION(BlueprintCallable, Category = "Health Registry")
+	void RegenerateAll(float amount);
+
+	// Living entries whose health is at or below the threshold
+	UFUNCTION(BlueprintCallable, Category = "Health Registry")
+	void GetBelowHealth(float healthThreshold, TArray<ULifeSystem*>& outLifeSystems) const;
+
+	// Same as GetBelowHealth but against a fraction (0 to 1) of each entry's max health
+	UFUNCTION(BlueprintCallable, Category = "Health Registry")
+	void GetBelowHealthFraction(float healthFraction, TArray<ULifeSystem*>& outLifeSystems) const;
+
+protected:
+	int32 Resolve(const FHealthHandle& handle) const;
+
+	// Tells the entry's life system if its health changed or it just died, call last since listeners can change the registry
+	void NotifyOwner(int32 denseIndex, float oldHealth, bool wasDead);
+
+	float GetWorldTime() const;
+};
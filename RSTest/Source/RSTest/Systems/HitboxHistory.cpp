@@ -0,0 +1,321 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HitboxHistory.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "RSTestStats.h"
+#include "Systems/WorldManager.h"
+
+AHitboxHistory::AHitboxHistory()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false; // Only while recording
+	PrimaryActorTick.TickGroup = TG_PostPhysics; // Once this frame's movement is done
+	bReplicates = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+
+	_historySeconds = 0.25f;
+	_initialTargets = 256;
+	_fallbackTickRate = 60.f;
+	_viewDelaySeconds = 0.1f;
+
+	_historyFrames = 0;
+	_columnCount = 0;
+	_recordInterval = 0.f;
+	_nextRecordTime = 0.f;
+	_isRecording = false;
+	_simulatedLatency = 0.f;
+	_newestFrame = INDEX_NONE;
+	_recordedFrames = 0;
+}
+
+AHitboxHistory* AHitboxHistory::Get(const UObject* worldContextObject)
+{
+	return GetWorldManager<AHitboxHistory>(worldContextObject);
+}
+
+void AHitboxHistory::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// Characters register in their BeginPlay, which can run before ours when the level's actors start, so the columns
+	// have to be there as soon as Get has spawned us. Config has been read by now, and so has the net driver, the map
+	// starts listening before any of its actors are initialized
+	const UNetDriver* netDriver = GetWorld()->GetNetDriver();
+	const float tickRate = (netDriver && netDriver->NetServerMaxTickRate > 0) ? (float)netDriver->NetServerMaxTickRate : _fallbackTickRate;
+	_recordInterval = 1.f / tickRate;
+
+	// One extra frame either end so the oldest time asked for always has a frame on both sides
+	_historyFrames = FMath::CeilToInt(_historySeconds * tickRate) + 2;
+
+	_frameTimes.Init(-MAX_FLT, _historyFrames);
+	SetColumnCount(_initialTargets);
+}
+
+void AHitboxHistory::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Clients never rewind, their hits don't count
+	_isRecording = GetNetMode() == NM_DedicatedServer || GetNetMode() == NM_ListenServer;
+	SetActorTickEnabled(true);
+}
+
+int32 AHitboxHistory::Register(ACharacter* target)
+{
+	if (!target)
+	{
+		return INDEX_NONE;
+	}
+
+	// Rare, only when more characters are about than the config allowed for, and only ever doubles
+	if (_freeSlots.Num() == 0)
+	{
+		SetColumnCount(FMath::Max(_columnCount * 2, 1));
+	}
+
+	const int32 slot = _freeSlots.Pop(false);
+	_targets[slot] = target;
+	_usedSlots.Add(slot);
+
+	// Nothing in this column is about this character until its first frame is recorded
+	for (int32 frame = 0; frame < _historyFrames; frame++)
+	{
+		_collidable[frame * _columnCount + slot] = 0;
+	}
+	return slot;
+}
+
+void AHitboxHistory::SetColumnCount(int32 columnCount)
+{
+	const int32 oldColumnCount = _columnCount;
+	if (columnCount <= oldColumnCount)
+	{
+		return;
+	}
+
+	TArray<FVector> centres;
+	TArray<uint8> collidable;
+	centres.SetNumZeroed(_historyFrames * columnCount);
+	collidable.SetNumZeroed(_historyFrames * columnCount);
+	if (oldColumnCount > 0)
+	{
+		for (int32 frame = 0; frame < _historyFrames; frame++)
+		{
+			FMemory::Memcpy(centres.GetData() + frame * columnCount, _centres.GetData() + frame * oldColumnCount, oldColumnCount * sizeof(FVector));
+			FMemory::Memcpy(collidable.GetData() + frame * columnCount, _collidable.GetData() + frame * oldColumnCount, oldColumnCount * sizeof(uint8));
+		}
+	}
+	_centres = MoveTemp(centres);
+	_collidable = MoveTemp(collidable);
+	_columnCount = columnCount;
+
+	_targets.SetNum(columnCount);
+	_radii.SetNumZeroed(columnCount);
+	_halfHeights.SetNumZeroed(columnCount);
+
+	// Popped off the end, so the lowest new column is handed out first
+	_freeSlots.Reserve(_freeSlots.Num() + columnCount - oldColumnCount);
+	for (int32 slot = columnCount - 1; slot >= oldColumnCount; slot--)
+	{
+		_freeSlots.Add(slot);
+	}
+	_usedSlots.Reserve(columnCount);
+}
+
+void AHitboxHistory::Unregister(int32& slot)
+{
+	if (slot == INDEX_NONE || !_targets.IsValidIndex(slot))
+	{
+		return;
+	}
+
+	_targets[slot] = nullptr;
+	_usedSlots.RemoveSingleSwap(slot, false);
+	_freeSlots.Add(slot);
+	slot = INDEX_NONE;
+}
+
+void AHitboxHistory::ClearHistory()
+{
+	_newestFrame = INDEX_NONE;
+	_recordedFrames = 0;
+}
+
+void AHitboxHistory::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!GetIsRecording())
+	{
+		return;
+	}
+
+	const float worldTime = GetWorld()->GetTimeSeconds();
+	if (worldTime >= _nextRecordTime)
+	{
+		// Keeps to the tick rate on average even when frames don't line up with it
+		_nextRecordTime = FMath::Max(_nextRecordTime + _recordInterval, worldTime);
+		RecordFrame(worldTime);
+	}
+}
+
+void AHitboxHistory::RecordFrame(float worldTime)
+{
+	RSTEST_SCOPE_COUNTER(HitboxRecord);
+
+	_newestFrame = (_newestFrame + 1) % _historyFrames;
+	_recordedFrames = FMath::Min(_recordedFrames + 1, _historyFrames);
+	_frameTimes[_newestFrame] = worldTime;
+
+	FVector* centres = _centres.GetData() + _newestFrame * _columnCount;
+	uint8* collidable = _collidable.GetData() + _newestFrame * _columnCount;
+
+	for (const int32 slot : _usedSlots)
+	{
+		const ACharacter* target = _targets[slot].Get();
+		const UCapsuleComponent* capsule = target ? target->GetCapsuleComponent() : nullptr;
+		if (!capsule)
+		{
+			collidable[slot] = 0;
+			continue;
+		}
+
+		centres[slot] = capsule->GetComponentLocation();
+		collidable[slot] = (target->GetActorEnableCollision() && capsule->IsCollisionEnabled()) ? 1 : 0;
+
+		// Crouching changes these, it's too rare to keep a history of
+		_radii[slot] = capsule->GetScaledCapsuleRadius();
+		_halfHeights[slot] = capsule->GetScaledCapsuleHalfHeight();
+	}
+}
+
+float AHitboxHistory::GetRewindSeconds(const AActor* shooter) const
+{
+	const APawn* shooterPawn = Cast<APawn>(shooter);
+	const APlayerController* playerController = shooterPawn ? Cast<APlayerController>(shooterPawn->GetController()) : nullptr;
+	if (!playerController)
+	{
+		return 0.f;
+	}
+
+	float latency = 0.f;
+	if (_simulatedLatency > 0.f)
+	{
+		latency = _simulatedLatency;
+	}
+	else if (_isRecording && !playerController->IsLocalController() && playerController->PlayerState)
+	{
+		// The shot was fired against a world that was a trip out of date, and has taken a trip to get here
+		latency = playerController->PlayerState->ExactPing * 0.001f + _viewDelaySeconds;
+	}
+
+	return FMath::Min(latency, _historySeconds);
+}
+
+bool AHitboxHistory::FindFrames(float worldTime, int32& outOlder, int32& outNewer, float& outAlpha) const
+{
+	if (_recordedFrames == 0)
+	{
+		return false;
+	}
+
+	// Walk back from the newest frame, there's only a handful of them
+	outNewer = _newestFrame;
+	outOlder = _newestFrame;
+	outAlpha = 0.f;
+	for (int32 i = 1; i < _recordedFrames; i++)
+	{
+		if (_frameTimes[outNewer] <= worldTime)
+		{
+			break;
+		}
+		outOlder = (outNewer - 1 + _historyFrames) % _historyFrames;
+		if (_frameTimes[outOlder] <= worldTime)
+		{
+			const float frameSpan = _frameTimes[outNewer] - _frameTimes[outOlder];
+			outAlpha = frameSpan > 0.f ? (worldTime - _frameTimes[outOlder]) / frameSpan : 0.f;
+			return true;
+		}
+		outNewer = outOlder;
+	}
+
+	// Newer than everything recorded, or older than the history goes back, use the nearest frame
+	outOlder = outNewer;
+	return true;
+}
+
+bool AHitboxHistory::SweepRewound(const FVector& start, const FVector& end, float radius, float worldTime, const AActor* ignoreActor, FHitboxRewindHit& outHit) const
+{
+	RSTEST_SCOPE_COUNTER(HitboxRewind);
+	FRSTestQueryCounters::HitboxRewinds++;
+
+	int32 olderFrame, newerFrame;
+	float alpha;
+	if (!FindFrames(worldTime, olderFrame, newerFrame, alpha))
+	{
+		return false;
+	}
+
+	const FVector* olderCentres = _centres.GetData() + olderFrame * _columnCount;
+	const FVector* newerCentres = _centres.GetData() + newerFrame * _columnCount;
+	const uint8* olderCollidable = _collidable.GetData() + olderFrame * _columnCount;
+	const uint8* newerCollidable = _collidable.GetData() + newerFrame * _columnCount;
+
+	float closestDistance = MAX_FLT;
+	int32 closestSlot = INDEX_NONE;
+	FVector closestShotPoint, closestAxisPoint;
+
+	for (const int32 slot : _usedSlots)
+	{
+		// Frames from before the character registered were cleared when it took the column
+		if (!olderCollidable[slot] || !newerCollidable[slot])
+		{
+			continue;
+		}
+
+		const ACharacter* target = _targets[slot].Get();
+		if (!target || target == ignoreActor)
+		{
+			continue;
+		}
+
+		const FVector centre = FMath::Lerp(olderCentres[slot], newerCentres[slot], alpha);
+		const float capsuleRadius = _radii[slot];
+		const FVector axisOffset(0.f, 0.f, FMath::Max(_halfHeights[slot] - capsuleRadius, 0.f));
+
+		FVector shotPoint, axisPoint;
+		FMath::SegmentDistToSegmentSafe(start, end, centre - axisOffset, centre + axisOffset, shotPoint, axisPoint);
+		if (FVector::DistSquared(shotPoint, axisPoint) > FMath::Square(radius + capsuleRadius))
+		{
+			continue;
+		}
+
+		const float distance = FVector::Dist(start, shotPoint);
+		if (distance < closestDistance)
+		{
+			closestDistance = distance;
+			closestSlot = slot;
+			closestShotPoint = shotPoint;
+			closestAxisPoint = axisPoint;
+		}
+	}
+
+	if (closestSlot == INDEX_NONE)
+	{
+		return false;
+	}
+
+	ACharacter* target = _targets[closestSlot].Get();
+	outHit.Actor = target;
+	outHit.Capsule = target->GetCapsuleComponent();
+	outHit.Normal = (closestShotPoint - closestAxisPoint).GetSafeNormal();
+	outHit.Location = closestAxisPoint + outHit.Normal * _radii[closestSlot];
+	outHit.Distance = closestDistance;
+	return true;
+}
@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "HitboxHistory.generated.h"
+
+class ACharacter;
+class UCapsuleComponent;
+
+/** A hit found against where a character's capsule was at some earlier time */
+struct FHitboxRewindHit
+{
+	FHitboxRewindHit() : Actor(nullptr), Capsule(nullptr), Location(ForceInitToZero), Normal(ForceInitToZero), Distance(0.f) {}
+
+	ACharacter* Actor;
+	UCapsuleComponent* Capsule;
+	FVector Location;
+	FVector Normal;
+
+	// Along the shot, from its start
+	float Distance;
+};
+
+/**
+ * Where every character's capsule has been over the last _historySeconds, so the server can check a remote player's shot
+ * against what that player was looking at when they fired rather than where things have got to since. Capsule centres
+ * are recorded at the server tick rate into a ring of frames laid out in one flat array (frame by frame, one column per
+ * registered character), so recording a frame is a single pass of writes. Only records on servers, or while a latency
+ * is being simulated for benchmarks. Enemies and player characters register themselves. One per world, get it through Get.
+ */
+UCLASS(config=Game, notplaceable)
+class RSTEST_API AHitboxHistory : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AHitboxHistory();
+
+	static AHitboxHistory* Get(const UObject* worldContextObject);
+
+	//Variables
+protected:
+	UPROPERTY(config, EditDefaultsOnly, Category = "Hitbox History Data", meta = (ClampMin = 0))
+	float _historySeconds;
+
+	// Columns allocated up front, the history doubles them if more characters than this register. Compensated shots ignore
+	// the Pawn channel, so every character has to have a column
+	UPROPERTY(config, EditDefaultsOnly, Category = "Hitbox History Data", meta = (ClampMin = 1))
+	int32 _initialTargets;
+
+	// Recording rate when there's no net driver to take the server tick rate from
+	UPROPERTY(config, EditDefaultsOnly, Category = "Hitbox History Data", meta = (ClampMin = 1))
+	float _fallbackTickRate;
+
+	// How far behind the server the other characters are drawn on a client on top of the round trip, i.e. the character
+	// movement smoothing on simulated proxies
+	UPROPERTY(config, EditDefaultsOnly, Category = "Hitbox History Data", meta = (ClampMin = 0))
+	float _viewDelaySeconds;
+
+private:
+	int32 _historyFrames;
+	int32 _columnCount;
+	float _recordInterval;
+	float _nextRecordTime;
+	bool _isRecording;
+
+	// Used for every shooter when above 0, lets the benchmark measure the rewind path without a network
+	float _simulatedLatency;
+
+	// Ring of frames, _newestFrame is the last one written
+	TArray<float> _frameTimes;
+	int32 _newestFrame;
+	int32 _recordedFrames;
+
+	// _historyFrames x _columnCount, frame-major
+	TArray<FVector> _centres;
+	TArray<uint8> _collidable;
+
+	// Per column
+	TArray<TWeakObjectPtr<ACharacter>> _targets;
+	TArray<float> _radii;
+	TArray<float> _halfHeights;
+	TArray<int32> _freeSlots;
+
+	// Columns in use, the only ones recorded and tested
+	TArray<int32> _usedSlots;
+
+	//GettersAndSetters
+public:
+	bool GetIsRecording() const { return _isRecording || _simulatedLatency > 0.f; }
+
+	int32 GetTargetCount() const { return _usedSlots.Num(); }
+
+	void SetSimulatedLatency(float seconds) { _simulatedLatency = FMath::Max(seconds, 0.f); }
+
+	//Functions
+public:
+	// Returns the column for the character, adding columns if they're all taken
+	int32 Register(ACharacter* target);
+
+	void Unregister(int32& slot);
+
+	// Forgets every recorded frame, for when characters are teleported and their old positions shouldn't be hit any more
+	void ClearHistory();
+
+	// How far back a shot from this actor should be checked, 0 for anyone but a remote (or simulated) player
+	float GetRewindSeconds(const AActor* shooter) const;
+
+	/**
+	 * Tests a sphere swept from start to end against every registered capsule as it was at the given world time, returns the
+	 * closest hit along the shot. Characters that had collision off at the time are skipped
+	 */
+	bool SweepRewound(const FVector& start, const FVector& end, float radius, float worldTime, const AActor* ignoreActor, FHitboxRewindHit& outHit) const;
+
+protected:
+	virtual void PostInitializeComponents() override;
+
+	virtual void BeginPlay() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	void RecordFrame(float worldTime);
+
+	// Re-lays the frames out with columnCount columns, keeping what's recorded in the existing ones
+	void SetColumnCount(int32 columnCount);
+
+	// The two recorded frames either side of the time and how far between them it is, false if nothing's recorded yet
+	bool FindFrames(float worldTime, int32& outOlder, int32& outNewer, float& outAlpha) const;
+};
@@ -0,0 +1,444 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "InputRecorder.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/Controller.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "RSTestCharacter.h"
+#include "Systems/WorldManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogInputRecorder, Log, All);
+
+static const uint32 kInputRecordingMagic = 0x52534952; // "RSIR"
+static const uint32 kInputRecordingVersion = 1;
+
+static FAutoConsoleCommandWithWorldAndArgs GInputRecordCommand(
+	TEXT("RSTest.Input.Record"),
+	TEXT("Records the player's input to Saved/InputRecordings/<Name>.rsinput until RSTest.Input.Stop, the name defaults to the current time"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& args, UWorld* world)
+	{
+		if (AInputRecorder* recorder = GetWorldManager<AInputRecorder>(world))
+		{
+			recorder->StartRecording(args.Num() > 0 ? args[0] : FString());
+		}
+	})
+);
+
+static FAutoConsoleCommandWithWorldAndArgs GInputReplayCommand(
+	TEXT("RSTest.Input.Replay"),
+	TEXT("Replays Saved/InputRecordings/<Name>.rsinput on the player"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& args, UWorld* world)
+	{
+		AInputRecorder* recorder = GetWorldManager<AInputRecorder>(world);
+		if (recorder && args.Num() > 0)
+		{
+			recorder->StartReplay(args[0], false);
+		}
+	})
+);
+
+static FAutoConsoleCommandWithWorld GInputStopCommand(
+	TEXT("RSTest.Input.Stop"),
+	TEXT("Saves the input recording in progress, or ends the replay in progress"),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* world)
+	{
+		if (AInputRecorder* recorder = GetWorldManager<AInputRecorder>(world, false))
+		{
+			recorder->Stop();
+		}
+	})
+);
+
+AInputRecorder::AInputRecorder()
+{
+	// Driven by the character's input handlers, nothing to do per frame on its own
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+
+	_mode = EInputRecorderMode::Idle;
+	_quitWhenDone = false;
+
+	_seed = 0;
+	_startLocation = FVector::ZeroVector;
+	_startRotation = FRotator::ZeroRotator;
+	_startControlRotation = FRotator::ZeroRotator;
+	_startVelocity = FVector::ZeroVector;
+
+	_frameIndex = -1;
+	_engineFrame = 0;
+
+	_previousUseFixedTimeStep = false;
+	_previousFixedDeltaTime = 0.0;
+}
+
+AInputRecorder* AInputRecorder::Get(const UObject* worldContextObject)
+{
+	return GetWorldManager<AInputRecorder>(worldContextObject);
+}
+
+void AInputRecorder::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Stop();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool AInputRecorder::StartRecording(const FString& recordingName)
+{
+	if (_mode != EInputRecorderMode::Idle)
+	{
+		UE_LOG(LogInputRecorder, Warning, TEXT("Input recorder: already busy, stop it first"));
+		return false;
+	}
+
+	ARSTestCharacter* character = GetPlayerCharacter();
+	if (!character)
+	{
+		UE_LOG(LogInputRecorder, Warning, TEXT("Input recorder: no player character to record"));
+		return false;
+	}
+
+	_recordingName = recordingName.IsEmpty() ? FString::Printf(TEXT("Input-%s"), *FDateTime::Now().ToString()) : recordingName;
+	_character = character;
+
+	// Anything random from here on comes out the same in the replay
+	_seed = (int32)(FPlatformTime::Cycles() & 0x7fffffff);
+	FMath::RandInit(_seed);
+	FMath::SRandInit(_seed);
+
+	_startLocation = character->GetActorLocation();
+	_startRotation = character->GetActorRotation();
+	_startControlRotation = character->GetControlRotation();
+	_startVelocity = character->GetVelocity();
+
+	_frames.Reset();
+	_frameIndex = -1;
+	_engineFrame = GFrameCounter;
+
+	_mode = EInputRecorderMode::Recording;
+	character->SetInputRecorder(this);
+
+	UE_LOG(LogInputRecorder, Log, TEXT("Input recorder: recording '%s'"), *_recordingName);
+	return true;
+}
+
+bool AInputRecorder::StartReplay(const FString& recordingName, bool quitWhenDone)
+{
+	if (_mode != EInputRecorderMode::Idle)
+	{
+		UE_LOG(LogInputRecorder, Warning, TEXT("Input recorder: already busy, stop it first"));
+		return false;
+	}
+
+	ARSTestCharacter* character = GetPlayerCharacter();
+	if (!character)
+	{
+		UE_LOG(LogInputRecorder, Warning, TEXT("Input recorder: no player character to replay on"));
+		return false;
+	}
+
+	if (!LoadRecording(recordingName) || _frames.Num() == 0)
+	{
+		return false;
+	}
+
+	_recordingName = recordingName;
+	_quitWhenDone = quitWhenDone;
+	_character = character;
+
+	FMath::RandInit(_seed);
+	FMath::SRandInit(_seed);
+
+	character->SetActorLocationAndRotation(_startLocation, _startRotation, false, nullptr, ETeleportType::TeleportPhysics);
+	if (AController* controller = character->GetController())
+	{
+		controller->SetControlRotation(_startControlRotation);
+	}
+	character->GetCharacterMovement()->Velocity = _startVelocity;
+
+	// Every frame takes as long as it did when recorded, however long it really takes. The engine picks a frame's
+	// time before any game code runs, so each frame's time is set one frame ahead
+	_previousUseFixedTimeStep = FApp::UseFixedTimeStep();
+	_previousFixedDeltaTime = FApp::GetFixedDeltaTime();
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(_frames[0].DeltaSeconds);
+
+	_frameIndex = -1;
+	_engineFrame = GFrameCounter;
+
+	_mode = EInputRecorderMode::Replaying;
+	character->SetInputRecorder(this);
+
+	UE_LOG(LogInputRecorder, Log, TEXT("Input recorder: replaying '%s', %d frames"), *_recordingName, _frames.Num());
+	return true;
+}
+
+void AInputRecorder::Stop()
+{
+	if (_mode == EInputRecorderMode::Recording)
+	{
+		_mode = EInputRecorderMode::Idle;
+		if (_character.IsValid())
+		{
+			_character->SetInputRecorder(nullptr);
+		}
+
+		SaveRecording();
+	}
+	else if (_mode == EInputRecorderMode::Replaying)
+	{
+		UE_LOG(LogInputRecorder, Log, TEXT("Input recorder: replay of '%s' stopped at frame %d of %d"), *_recordingName, _frameIndex, _frames.Num());
+		FinishReplay();
+	}
+}
+
+void AInputRecorder::FinishReplay()
+{
+	_mode = EInputRecorderMode::Idle;
+	if (_character.IsValid())
+	{
+		_character->SetInputRecorder(nullptr);
+	}
+
+	FApp::SetUseFixedTimeStep(_previousUseFixedTimeStep);
+	FApp::SetFixedDeltaTime(_previousFixedDeltaTime);
+
+	UE_LOG(LogInputRecorder, Log, TEXT("Input recorder: replay of '%s' finished"), *_recordingName);
+
+	if (_quitWhenDone)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+float AInputRecorder::FilterAxis(const ARSTestCharacter* character, ERecordedInputAxis axis, float liveValue)
+{
+	if (_mode == EInputRecorderMode::Idle || character != _character.Get())
+	{
+		return liveValue;
+	}
+
+	SyncFrame();
+	if (_frameIndex < 0)
+	{
+		return liveValue;
+	}
+
+	if (_mode == EInputRecorderMode::Recording)
+	{
+		_frames[_frameIndex].Axes[(int32)axis] = liveValue;
+		return liveValue;
+	}
+
+	if (_mode == EInputRecorderMode::Replaying)
+	{
+		return _frames[_frameIndex].Axes[(int32)axis];
+	}
+
+	return liveValue;
+}
+
+bool AInputRecorder::FilterAction(const ARSTestCharacter* character, ERecordedInputAction action)
+{
+	if (_mode == EInputRecorderMode::Idle || character != _character.Get())
+	{
+		return true;
+	}
+
+	SyncFrame();
+	if (_frameIndex < 0)
+	{
+		return true;
+	}
+
+	if (_mode == EInputRecorderMode::Recording)
+	{
+		_frames[_frameIndex].Actions |= 1 << (uint8)action;
+		return true;
+	}
+
+	// Live presses would change what happens, only the recorded ones count
+	return _mode != EInputRecorderMode::Replaying;
+}
+
+void AInputRecorder::SyncFrame()
+{
+	// Input handled in the frame the recorder was started in isn't part of the recording
+	if (_engineFrame == GFrameCounter)
+	{
+		return;
+	}
+	_engineFrame = GFrameCounter;
+
+	if (_mode == EInputRecorderMode::Recording)
+	{
+		_frameIndex = _frames.AddZeroed();
+		_frames[_frameIndex].DeltaSeconds = FApp::GetDeltaTime();
+	}
+	else if (_mode == EInputRecorderMode::Replaying)
+	{
+		_frameIndex++;
+		if (!_frames.IsValidIndex(_frameIndex))
+		{
+			_frameIndex = -1;
+			FinishReplay();
+			return;
+		}
+
+		if (_frames.IsValidIndex(_frameIndex + 1))
+		{
+			FApp::SetFixedDeltaTime(_frames[_frameIndex + 1].DeltaSeconds);
+		}
+
+		ARSTestCharacter* character = _character.Get();
+		const uint8 actions = _frames[_frameIndex].Actions;
+		for (int32 i = 0; i < (int32)ERecordedInputAction::Count && character; i++)
+		{
+			if (actions & (1 << i))
+			{
+				character->ApplyRecordedInputAction((ERecordedInputAction)i);
+			}
+		}
+	}
+}
+
+// Header, then per frame: delta time, action bits, a mask of the axes that changed since the previous frame and their new values
+bool AInputRecorder::SaveRecording() const
+{
+	TArray<uint8> bytes;
+	FMemoryWriter writer(bytes);
+
+	uint32 magic = kInputRecordingMagic;
+	uint32 version = kInputRecordingVersion;
+	int32 seed = _seed;
+	FString mapName = GetWorld()->GetMapName();
+	mapName.RemoveFromStart(GetWorld()->StreamingLevelsPrefix);
+	FVector startLocation = _startLocation;
+	FRotator startRotation = _startRotation;
+	FRotator startControlRotation = _startControlRotation;
+	FVector startVelocity = _startVelocity;
+	int32 frameCount = _frames.Num();
+
+	writer << magic << version << seed << mapName;
+	writer << startLocation << startRotation << startControlRotation << startVelocity;
+	writer << frameCount;
+
+	float previousAxes[(int32)ERecordedInputAxis::Count] = {};
+	for (const FRecordedInputFrame& frame : _frames)
+	{
+		float deltaSeconds = frame.DeltaSeconds;
+		uint8 actions = frame.Actions;
+		uint8 changedAxes = 0;
+		for (int32 i = 0; i < (int32)ERecordedInputAxis::Count; i++)
+		{
+			if (frame.Axes[i] != previousAxes[i])
+			{
+				changedAxes |= 1 << i;
+			}
+		}
+
+		writer << deltaSeconds << actions << changedAxes;
+		for (int32 i = 0; i < (int32)ERecordedInputAxis::Count; i++)
+		{
+			if (changedAxes & (1 << i))
+			{
+				float value = frame.Axes[i];
+				writer << value;
+				previousAxes[i] = value;
+			}
+		}
+	}
+
+	const FString filePath = GetRecordingPath(_recordingName);
+	if (!FFileHelper::SaveArrayToFile(bytes, *filePath))
+	{
+		UE_LOG(LogInputRecorder, Warning, TEXT("Input recorder: couldn't write %s"), *filePath);
+		return false;
+	}
+
+	UE_LOG(LogInputRecorder, Log, TEXT("Input recorder: saved %d frames (%d bytes) to %s"), _frames.Num(), bytes.Num(), *filePath);
+	return true;
+}
+
+bool AInputRecorder::LoadRecording(const FString& recordingName)
+{
+	const FString filePath = GetRecordingPath(recordingName);
+
+	TArray<uint8> bytes;
+	if (!FFileHelper::LoadFileToArray(bytes, *filePath))
+	{
+		UE_LOG(LogInputRecorder, Warning, TEXT("Input recorder: couldn't read %s"), *filePath);
+		return false;
+	}
+
+	FMemoryReader reader(bytes);
+
+	uint32 magic = 0;
+	uint32 version = 0;
+	reader << magic << version;
+	if (magic != kInputRecordingMagic || version != kInputRecordingVersion)
+	{
+		UE_LOG(LogInputRecorder, Warning, TEXT("Input recorder: %s isn't a version %u input recording"), *filePath, kInputRecordingVersion);
+		return false;
+	}
+
+	FString mapName;
+	int32 frameCount = 0;
+	reader << _seed << mapName;
+	reader << _startLocation << _startRotation << _startControlRotation << _startVelocity;
+	reader << frameCount;
+
+	FString currentMapName = GetWorld()->GetMapName();
+	currentMapName.RemoveFromStart(GetWorld()->StreamingLevelsPrefix);
+	if (mapName != currentMapName)
+	{
+		UE_LOG(LogInputRecorder, Warning, TEXT("Input recorder: %s was recorded on %s, replaying it on %s"), *filePath, *mapName, *currentMapName);
+	}
+
+	_frames.Reset(frameCount);
+
+	float axes[(int32)ERecordedInputAxis::Count] = {};
+	for (int32 frameIndex = 0; frameIndex < frameCount && !reader.IsError(); frameIndex++)
+	{
+		FRecordedInputFrame frame;
+		uint8 changedAxes = 0;
+		reader << frame.DeltaSeconds << frame.Actions << changedAxes;
+		for (int32 i = 0; i < (int32)ERecordedInputAxis::Count; i++)
+		{
+			if (changedAxes & (1 << i))
+			{
+				reader << axes[i];
+			}
+			frame.Axes[i] = axes[i];
+		}
+		_frames.Add(frame);
+	}
+
+	if (reader.IsError())
+	{
+		UE_LOG(LogInputRecorder, Warning, TEXT("Input recorder: %s is truncated"), *filePath);
+		_frames.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+ARSTestCharacter* AInputRecorder::GetPlayerCharacter() const
+{
+	return Cast<ARSTestCharacter>(UGameplayStatics::GetPlayerCharacter(this, 0));
+}
+
+FString AInputRecorder::GetRecordingPath(const FString& recordingName)
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("InputRecordings"), recordingName + TEXT(".rsinput"));
+}
@@ -0,0 +1,129 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "InputRecorder.generated.h"
+
+class ARSTestCharacter;
+
+// Every axis the character binds, in the order they're stored
+enum class ERecordedInputAxis : uint8
+{
+	MoveForward,
+	MoveRight,
+	Turn,
+	TurnRate,
+	LookUp,
+	LookUpRate,
+
+	Count
+};
+
+enum class ERecordedInputAction : uint8
+{
+	JumpPressed,
+	JumpReleased,
+	Fire,
+
+	Count
+};
+
+/**
+ * Records what the player's bound input handlers receive each frame, with the frame's delta time and the random seed, and
+ * replays it through the same handlers with the same frame times, so a session can be profiled again and again.
+ * Recordings are written to Saved/InputRecordings/<Name>.rsinput.
+ *
+ * The character passes all of its bound input through FilterAxis and FilterAction. While recording the live values are
+ * stored, while replaying they're swapped for the recorded ones (and live actions are dropped). Frames are told apart by
+ * the first handler call in each one, actions are replayed before axes since that's the order input dispatches them in.
+ *
+ * -RSRecordInput[=Name] records from map start until the game ends, -RSReplayInput=Name replays from map start and quits
+ * once the recording runs out. RSTest.Input.Record, RSTest.Input.Stop and RSTest.Input.Replay do the same from the console.
+ */
+UCLASS(notplaceable)
+class RSTEST_API AInputRecorder : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AInputRecorder();
+
+	static AInputRecorder* Get(const UObject* worldContextObject);
+
+	//Variables
+private:
+	enum class EInputRecorderMode : uint8
+	{
+		Idle,
+		Recording,
+		Replaying,
+	};
+
+	struct FRecordedInputFrame
+	{
+		float DeltaSeconds;
+		uint8 Actions; // One bit per ERecordedInputAction
+		float Axes[(int32)ERecordedInputAxis::Count];
+	};
+
+	EInputRecorderMode _mode;
+	FString _recordingName;
+	bool _quitWhenDone;
+
+	TWeakObjectPtr<ARSTestCharacter> _character;
+
+	int32 _seed;
+	FVector _startLocation;
+	FRotator _startRotation;
+	FRotator _startControlRotation;
+	FVector _startVelocity;
+
+	TArray<FRecordedInputFrame> _frames;
+	int32 _frameIndex; // Frame being recorded or replayed, -1 before the first one
+	uint64 _engineFrame; // GFrameCounter of that frame
+
+	// Timing to put back once a replay is over
+	bool _previousUseFixedTimeStep;
+	double _previousFixedDeltaTime;
+
+	//GettersAndSetters
+public:
+	bool GetIsRecording() const { return _mode == EInputRecorderMode::Recording; }
+
+	bool GetIsReplaying() const { return _mode == EInputRecorderMode::Replaying; }
+
+	//Functions
+public:
+	// Starts recording the first player's input from the next frame, an empty name picks one from the current time
+	bool StartRecording(const FString& recordingName);
+
+	// Loads a recording and replays it on the first player from the next frame
+	bool StartReplay(const FString& recordingName, bool quitWhenDone);
+
+	// Saves the recording, or ends the replay early
+	void Stop();
+
+	// Called by the character with what an axis binding received, returns the value the handler should use
+	float FilterAxis(const ARSTestCharacter* character, ERecordedInputAxis axis, float liveValue);
+
+	// Called by the character when an action binding fires, returns whether the handler should run
+	bool FilterAction(const ARSTestCharacter* character, ERecordedInputAction action);
+
+protected:
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Moves on to a new frame if this is the first handler call of one, replaying that frame's actions
+	void SyncFrame();
+
+	void FinishReplay();
+
+	bool SaveRecording() const;
+
+	bool LoadRecording(const FString& recordingName);
+
+	ARSTestCharacter* GetPlayerCharacter() const;
+
+	static FString GetRecordingPath(const FString& recordingName);
+};
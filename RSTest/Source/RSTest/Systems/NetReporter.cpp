@@ -0,0 +1,408 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NetReporter.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Stats/Stats.h"
+#include "Systems/ArenaSpatialIndex.h"
+#include "Systems/CombatReplicator.h"
+#include "Systems/WorldManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogNetReport, Log, All);
+
+static FAutoConsoleCommandWithWorldAndArgs GNetReportCommand(
+	TEXT("RSTest.Net.Report"),
+	TEXT("Measures bandwidth and game thread time per connected client for the given number of seconds (default 30) and writes it to Saved/NetReports"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& args, UWorld* world)
+	{
+		if (ANetReporter* reporter = GetWorldManager<ANetReporter>(world))
+		{
+			reporter->StartReport(args.Num() > 0 ? FCString::Atof(*args[0]) : 30.f, 0, false);
+		}
+	})
+);
+
+ANetReporter::ANetReporter()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false; // Only while a report is running
+	bReplicates = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+
+	_warmupSeconds = 5.f;
+	_baselineSeconds = 5.f;
+	_clientWaitTimeout = 120.f;
+
+	_phase = ENetReportPhase::Idle;
+	_phaseEndTime = 0.f;
+	_measureSeconds = 0.f;
+	_wantedClients = 0;
+	_quitWhenDone = false;
+	_nextSampleTime = 0.f;
+	_lastFrameCycles = 0;
+	_lastIdleCycles = 0;
+
+	_projectileEventsAtStart = 0;
+	_projectileCulledAtStart = 0;
+	_spikeEventsAtStart = 0;
+	_spikeCulledAtStart = 0;
+}
+
+ANetReporter* ANetReporter::Get(const UObject* worldContextObject)
+{
+	return GetWorldManager<ANetReporter>(worldContextObject);
+}
+
+void ANetReporter::StartReport(float measureSeconds, int32 wantedClients, bool quitWhenDone)
+{
+	if (GetIsRunning())
+	{
+		UE_LOG(LogNetReport, Warning, TEXT("A net report is already running"));
+		return;
+	}
+
+	if (GetNetMode() != NM_DedicatedServer && GetNetMode() != NM_ListenServer)
+	{
+		UE_LOG(LogNetReport, Warning, TEXT("Net reports can only be run on a server"));
+		if (quitWhenDone)
+		{
+			FPlatformMisc::RequestExit(false);
+		}
+		return;
+	}
+
+	_measureSeconds = FMath::Max(measureSeconds, 1.f);
+	_wantedClients = wantedClients;
+	_quitWhenDone = quitWhenDone;
+
+	_baselineGameThreadMs.Reset();
+	SetActorTickEnabled(true);
+	MeasureGameThreadMs(); // Starts the first frame here
+
+	// Without a baseline there's no per client cost to report, but the rest of the report still stands
+	if (GetClientCount() > 0)
+	{
+		UE_LOG(LogNetReport, Warning, TEXT("Clients are already connected, the net report can't measure a baseline"));
+		StartWaitingForClients();
+		return;
+	}
+
+	_phase = ENetReportPhase::Baseline;
+	_phaseEndTime = GetWorld()->GetRealTimeSeconds() + _baselineSeconds;
+	UE_LOG(LogNetReport, Log, TEXT("Net report measuring a %.0f second baseline with no clients"), _baselineSeconds);
+}
+
+void ANetReporter::StartWaitingForClients()
+{
+	_phase = ENetReportPhase::WaitingForClients;
+	_phaseEndTime = GetWorld()->GetRealTimeSeconds() + _clientWaitTimeout;
+
+	UE_LOG(LogNetReport, Log, TEXT("Net report waiting for %d clients"), _wantedClients);
+}
+
+void ANetReporter::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Every tick, each sample covers exactly one frame
+	const float gameThreadMs = MeasureGameThreadMs();
+
+	// Real time, a loaded server running behind shouldn't stretch the report out
+	const float realTime = GetWorld()->GetRealTimeSeconds();
+
+	switch (_phase)
+	{
+	case ENetReportPhase::Baseline:
+		if (GetClientCount() > 0 || realTime >= _phaseEndTime)
+		{
+			if (GetClientCount() > 0)
+			{
+				UE_LOG(LogNetReport, Warning, TEXT("A client joined %.1f seconds into the baseline, using what was sampled"),
+					_baselineSeconds - (_phaseEndTime - realTime));
+			}
+			StartWaitingForClients();
+		}
+		else
+		{
+			_baselineGameThreadMs.Add(gameThreadMs);
+		}
+		break;
+
+	case ENetReportPhase::WaitingForClients:
+		if (GetClientCount() >= _wantedClients || realTime >= _phaseEndTime)
+		{
+			if (GetClientCount() < _wantedClients)
+			{
+				UE_LOG(LogNetReport, Warning, TEXT("Only %d of %d clients joined, reporting on those"), GetClientCount(), _wantedClients);
+			}
+			_phase = ENetReportPhase::Warmup;
+			_phaseEndTime = realTime + _warmupSeconds;
+		}
+		break;
+
+	case ENetReportPhase::Warmup:
+		if (realTime >= _phaseEndTime)
+		{
+			StartMeasuring();
+		}
+		break;
+
+	case ENetReportPhase::Measure:
+		// On a server the game thread is mostly simulation and replication
+		_gameThreadMs.Add(gameThreadMs);
+
+		// The connections' byte rates are only updated once a second
+		if (realTime >= _nextSampleTime)
+		{
+			_nextSampleTime += 1.f;
+			SampleConnections();
+		}
+
+		if (realTime >= _phaseEndTime)
+		{
+			FinishReport();
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+float ANetReporter::MeasureGameThreadMs()
+{
+	const uint32 frameCycles = FPlatformTime::Cycles();
+	const uint32 elapsedCycles = frameCycles - _lastFrameCycles;
+	_lastFrameCycles = frameCycles;
+
+	uint32 idleCycles = 0;
+#if STATS
+	// The engine zeroes the count now and then, whatever's there after that is all new
+	const uint32 totalIdleCycles = FThreadIdleStats::Get().Waits;
+	idleCycles = totalIdleCycles >= _lastIdleCycles ? totalIdleCycles - _lastIdleCycles : totalIdleCycles;
+	_lastIdleCycles = totalIdleCycles;
+#endif
+
+	return FPlatformTime::ToMilliseconds(elapsedCycles - FMath::Min(idleCycles, elapsedCycles));
+}
+
+void ANetReporter::StartMeasuring()
+{
+	const float realTime = GetWorld()->GetRealTimeSeconds();
+	_phase = ENetReportPhase::Measure;
+	_phaseEndTime = realTime + _measureSeconds;
+	_nextSampleTime = realTime + 1.f;
+
+	_gameThreadMs.Reset();
+	_serverInBytesPerSecond.Reset();
+	_serverOutBytesPerSecond.Reset();
+	_connectionSamples.Reset();
+
+	if (ACombatReplicator* replicator = ACombatReplicator::Get(this))
+	{
+		_projectileEventsAtStart = replicator->GetProjectileEventsSent();
+		_projectileCulledAtStart = replicator->GetProjectileEventsCulled();
+		_spikeEventsAtStart = replicator->GetSpikeEventsSent();
+		_spikeCulledAtStart = replicator->GetSpikeEventsCulled();
+	}
+
+	UE_LOG(LogNetReport, Log, TEXT("Net report measuring %d clients for %.0f seconds"), GetClientCount(), _measureSeconds);
+}
+
+void ANetReporter::SampleConnections()
+{
+	UNetDriver* netDriver = GetWorld()->GetNetDriver();
+	if (!netDriver)
+	{
+		return;
+	}
+
+	_serverInBytesPerSecond.Add(netDriver->InBytesPerSecond);
+	_serverOutBytesPerSecond.Add(netDriver->OutBytesPerSecond);
+
+	for (UNetConnection* connection : netDriver->ClientConnections)
+	{
+		if (!connection || connection->State != USOCK_Open)
+		{
+			continue;
+		}
+
+		FConnectionSamples& samples = _connectionSamples.FindOrAdd(connection);
+		if (samples.Address.IsEmpty())
+		{
+			samples.Address = connection->LowLevelGetRemoteAddress(true);
+		}
+		samples.InBytesPerSecond.Add(connection->InBytesPerSecond);
+		samples.OutBytesPerSecond.Add(connection->OutBytesPerSecond);
+	}
+}
+
+void ANetReporter::FinishReport()
+{
+	_phase = ENetReportPhase::Idle;
+	SetActorTickEnabled(false);
+
+	auto average = [](const TArray<float>& samples)
+	{
+		float total = 0.f;
+		for (float sample : samples)
+		{
+			total += sample;
+		}
+		return samples.Num() > 0 ? total / samples.Num() : 0.f;
+	};
+
+	const int32 clientCount = FMath::Max(_connectionSamples.Num(), GetClientCount());
+
+	TSharedRef<FJsonObject> root = MakeShared<FJsonObject>();
+	root->SetStringField(TEXT("map"), GetWorld()->GetMapName());
+	root->SetStringField(TEXT("build"), FApp::GetBuildVersion());
+	root->SetStringField(TEXT("configuration"), EBuildConfigurations::ToString(FApp::GetBuildConfiguration()));
+	root->SetStringField(TEXT("platform"), FPlatformProperties::PlatformName());
+	root->SetStringField(TEXT("time"), FDateTime::UtcNow().ToIso8601());
+	root->SetBoolField(TEXT("dedicated"), GetNetMode() == NM_DedicatedServer);
+	root->SetNumberField(TEXT("clients"), clientCount);
+	root->SetNumberField(TEXT("seconds"), _measureSeconds);
+	root->SetNumberField(TEXT("frames"), _gameThreadMs.Num());
+
+	// Builds without stats can't tell idle time apart, their game thread times include the tick rate sleep
+	root->SetBoolField(TEXT("gameThreadIncludesIdle"), !STATS);
+
+	TSharedRef<FJsonObject> gameThread = MakeShared<FJsonObject>();
+	if (_gameThreadMs.Num() > 0)
+	{
+		const float averageMs = average(_gameThreadMs);
+		_gameThreadMs.Sort();
+		gameThread->SetNumberField(TEXT("avg"), averageMs);
+		gameThread->SetNumberField(TEXT("p95"), _gameThreadMs[FMath::Min(FMath::FloorToInt(_gameThreadMs.Num() * 0.95f), _gameThreadMs.Num() - 1)]);
+		gameThread->SetNumberField(TEXT("max"), _gameThreadMs.Last());
+
+		// What the clients added over the empty server, split between them. Left out without a baseline to compare with
+		if (_baselineGameThreadMs.Num() > 0)
+		{
+			const float baselineMs = average(_baselineGameThreadMs);
+			gameThread->SetNumberField(TEXT("baselineAvg"), baselineMs);
+			gameThread->SetNumberField(TEXT("baselineFrames"), _baselineGameThreadMs.Num());
+			gameThread->SetNumberField(TEXT("marginalPerClient"), clientCount > 0 ? (averageMs - baselineMs) / clientCount : 0.f);
+		}
+	}
+	root->SetObjectField(TEXT("gameThreadMs"), gameThread);
+
+	int32 replicatedArenaActors = 0;
+	int32 dormantArenaActors = 0;
+	CountArenaDormancy(replicatedArenaActors, dormantArenaActors);
+	TSharedRef<FJsonObject> arenaDormancy = MakeShared<FJsonObject>();
+	arenaDormancy->SetNumberField(TEXT("replicated"), replicatedArenaActors);
+	arenaDormancy->SetNumberField(TEXT("dormant"), dormantArenaActors);
+	root->SetObjectField(TEXT("arenaActors"), arenaDormancy);
+
+	root->SetNumberField(TEXT("serverInBytesPerSecond"), average(_serverInBytesPerSecond));
+	root->SetNumberField(TEXT("serverOutBytesPerSecond"), average(_serverOutBytesPerSecond));
+
+	TArray<TSharedPtr<FJsonValue>> connections;
+	float totalIn = 0.f;
+	float totalOut = 0.f;
+	for (const TPair<TWeakObjectPtr<UObject>, FConnectionSamples>& pair : _connectionSamples)
+	{
+		const float inBytes = average(pair.Value.InBytesPerSecond);
+		const float outBytes = average(pair.Value.OutBytesPerSecond);
+		totalIn += inBytes;
+		totalOut += outBytes;
+
+		TSharedRef<FJsonObject> connection = MakeShared<FJsonObject>();
+		connection->SetStringField(TEXT("address"), pair.Value.Address);
+		connection->SetNumberField(TEXT("inBytesPerSecond"), inBytes);
+		connection->SetNumberField(TEXT("outBytesPerSecond"), outBytes);
+		connections.Add(MakeShared<FJsonValueObject>(connection));
+	}
+	root->SetArrayField(TEXT("connections"), connections);
+	root->SetNumberField(TEXT("avgInBytesPerSecondPerClient"), connections.Num() > 0 ? totalIn / connections.Num() : 0.f);
+	root->SetNumberField(TEXT("avgOutBytesPerSecondPerClient"), connections.Num() > 0 ? totalOut / connections.Num() : 0.f);
+
+	if (ACombatReplicator* replicator = ACombatReplicator::Get(this))
+	{
+		TSharedRef<FJsonObject> events = MakeShared<FJsonObject>();
+		events->SetNumberField(TEXT("projectilesSent"), replicator->GetProjectileEventsSent() - _projectileEventsAtStart);
+		events->SetNumberField(TEXT("projectilesCulled"), replicator->GetProjectileEventsCulled() - _projectileCulledAtStart);
+		events->SetNumberField(TEXT("spikesSent"), replicator->GetSpikeEventsSent() - _spikeEventsAtStart);
+		events->SetNumberField(TEXT("spikesCulled"), replicator->GetSpikeEventsCulled() - _spikeCulledAtStart);
+		root->SetObjectField(TEXT("combatEvents"), events);
+	}
+
+	FString output;
+	TSharedRef<TJsonWriter<>> writer = TJsonWriterFactory<>::Create(&output);
+	FJsonSerializer::Serialize(root, writer);
+
+	const FString fileName = FString::Printf(TEXT("NetReport-%dClients-%s.json"), clientCount, *FDateTime::Now().ToString());
+	const FString filePath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("NetReports"), fileName);
+	if (FFileHelper::SaveStringToFile(output, *filePath))
+	{
+		UE_LOG(LogNetReport, Log, TEXT("Net report written to %s"), *filePath);
+	}
+	else
+	{
+		UE_LOG(LogNetReport, Error, TEXT("Couldn't write net report to %s"), *filePath);
+	}
+
+	if (_quitWhenDone)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+int32 ANetReporter::GetClientCount() const
+{
+	const UNetDriver* netDriver = GetWorld()->GetNetDriver();
+	if (!netDriver)
+	{
+		return 0;
+	}
+
+	int32 clientCount = 0;
+	for (const UNetConnection* connection : netDriver->ClientConnections)
+	{
+		if (connection && connection->State == USOCK_Open && connection->PlayerController)
+		{
+			clientCount++;
+		}
+	}
+	return clientCount;
+}
+
+void ANetReporter::CountArenaDormancy(int32& outReplicated, int32& outDormant) const
+{
+	outReplicated = 0;
+	outDormant = 0;
+
+	const AArenaSpatialIndex* arenaIndex = GetWorldManager<AArenaSpatialIndex>(this, false);
+	if (!arenaIndex)
+	{
+		return;
+	}
+
+	auto countActors = [&outReplicated, &outDormant](const TArray<TWeakObjectPtr<AActor>>& actors)
+	{
+		for (const TWeakObjectPtr<AActor>& actor : actors)
+		{
+			if (actor.IsValid() && actor->GetIsReplicated())
+			{
+				outReplicated++;
+				if (actor->NetDormancy == DORM_DormantAll || actor->NetDormancy == DORM_Initial)
+				{
+					outDormant++;
+				}
+			}
+		}
+	};
+	countActors(arenaIndex->GetTileActors());
+	countActors(arenaIndex->GetWallActors());
+}
@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "NetReporter.generated.h"
+
+/**
+ * Measures what the connected clients cost a listen or dedicated server: bytes per second up and down each connection,
+ * game thread time per frame and how much each client adds to it, plus the combat replicator's event counts. The per client
+ * cost is marginal: game thread time is first sampled with nobody connected, and what the clients add on top of that is
+ * split between them. That covers replicating to them and any simulation they cause, like enemies they wake up.
+ * Written to Saved/NetReports as JSON. Started from the server's command line with -RSNetReport=<Seconds> (and
+ * -RSNetReportClients=<N> to wait until that many clients have joined first), which quits once the report is written,
+ * or from the console with RSTest.Net.Report [Seconds].
+ */
+UCLASS(config=Game, notplaceable)
+class RSTEST_API ANetReporter : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ANetReporter();
+
+	static ANetReporter* Get(const UObject* worldContextObject);
+
+	//Variables
+protected:
+	// Time for newly joined clients to load in and settle before measuring starts
+	UPROPERTY(config, EditDefaultsOnly, Category = "Net Report Data", meta = (ClampMin = 0))
+	float _warmupSeconds;
+
+	// Game thread time is sampled this long with no clients connected first, cut short if one joins
+	UPROPERTY(config, EditDefaultsOnly, Category = "Net Report Data", meta = (ClampMin = 0))
+	float _baselineSeconds;
+
+	// Gives up waiting for clients after this long and reports on whoever has joined
+	UPROPERTY(config, EditDefaultsOnly, Category = "Net Report Data", meta = (ClampMin = 0))
+	float _clientWaitTimeout;
+
+private:
+	enum class ENetReportPhase : uint8
+	{
+		Idle,
+		Baseline,
+		WaitingForClients,
+		Warmup,
+		Measure,
+	};
+
+	struct FConnectionSamples
+	{
+		FString Address;
+		TArray<float> InBytesPerSecond;
+		TArray<float> OutBytesPerSecond;
+	};
+
+	ENetReportPhase _phase;
+	float _phaseEndTime;
+	float _measureSeconds;
+	int32 _wantedClients;
+	bool _quitWhenDone;
+
+	float _nextSampleTime;
+
+	// Cycle counts at the last tick, for measuring the game thread's busy time between ticks ourselves
+	uint32 _lastFrameCycles;
+	uint32 _lastIdleCycles;
+	TArray<float> _baselineGameThreadMs;
+	TArray<float> _gameThreadMs;
+	TArray<float> _serverInBytesPerSecond;
+	TArray<float> _serverOutBytesPerSecond;
+	TMap<TWeakObjectPtr<UObject>, FConnectionSamples> _connectionSamples;
+
+	int32 _projectileEventsAtStart;
+	int32 _projectileCulledAtStart;
+	int32 _spikeEventsAtStart;
+	int32 _spikeCulledAtStart;
+
+	//GettersAndSetters
+public:
+	bool GetIsRunning() const { return _phase != ENetReportPhase::Idle; }
+
+	//Functions
+public:
+	// Server only. Waits for wantedClients connections first if there's fewer than that
+	void StartReport(float measureSeconds, int32 wantedClients, bool quitWhenDone);
+
+protected:
+	virtual void Tick(float DeltaTime) override;
+
+	void StartWaitingForClients();
+
+	// Game thread time since the last call less the time it spent idle, e.g. sleeping to hold a dedicated server's tick rate.
+	// GGameThreadTime can't be used, it's only set when a viewport draws and a dedicated server has none
+	float MeasureGameThreadMs();
+
+	void StartMeasuring();
+
+	void SampleConnections();
+
+	void FinishReport();
+
+	int32 GetClientCount() const;
+
+	// Replicated arena tiles and walls, and how many of them have gone dormant
+	void CountArenaDormancy(int32& outReplicated, int32& outDormant) const;
+};
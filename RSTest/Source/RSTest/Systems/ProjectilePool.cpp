@@ -0,0 +1,196 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProjectilePool.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "RSTestProjectile.h"
+#include "Systems/WorldManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogProjectilePool, Log, All);
+
+static FAutoConsoleCommandWithWorld GProjectilePoolStatsCommand(
+	TEXT("RSTest.ProjectilePool.Stats"),
+	TEXT("Logs hit/miss/high-water counters for the projectile pool of the current world"),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* world)
+	{
+		if (AProjectilePool* pool = GetWorldManager<AProjectilePool>(world, false))
+		{
+			pool->LogStats();
+		}
+	})
+);
+
+AProjectilePool::AProjectilePool()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+
+	_prewarmCount = 32;
+	_maxFreePerClass = 128;
+}
+
+AProjectilePool* AProjectilePool::Get(const UObject* worldContextObject)
+{
+	return GetWorldManager<AProjectilePool>(worldContextObject);
+}
+
+void AProjectilePool::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	LogStats();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AProjectilePool::Prewarm(TSubclassOf<ARSTestProjectile> projectileClass, int32 count)
+{
+	if (!projectileClass)
+	{
+		return;
+	}
+
+	if (count < 0)
+	{
+		count = _prewarmCount;
+	}
+
+	TArray<ARSTestProjectile*>& freeList = _freeProjectiles.FindOrAdd(projectileClass);
+	while (freeList.Num() < count)
+	{
+		ARSTestProjectile* projectile = SpawnPooledProjectile(projectileClass);
+		if (!projectile)
+		{
+			break;
+		}
+		freeList.Add(projectile);
+	}
+}
+
+ARSTestProjectile* AProjectilePool::AcquireProjectile(TSubclassOf<ARSTestProjectile> projectileClass, const FVector& location, const FRotator& rotation, AActor* owner, ESpawnActorCollisionHandlingMethod collisionHandling)
+{
+	if (!projectileClass)
+	{
+		return nullptr;
+	}
+
+	ARSTestProjectile* projectile = nullptr;
+
+	TArray<ARSTestProjectile*>& freeList = _freeProjectiles.FindOrAdd(projectileClass);
+	while (freeList.Num() > 0 && !projectile)
+	{
+		projectile = freeList.Pop(false);
+		if (projectile && projectile->IsPendingKill())
+		{
+			projectile = nullptr;
+		}
+	}
+
+	if (projectile)
+	{
+		_poolHits++;
+	}
+	else
+	{
+		_poolMisses++;
+		projectile = SpawnPooledProjectile(projectileClass);
+		if (!projectile)
+		{
+			return nullptr;
+		}
+	}
+
+	projectile->SetOwner(owner);
+	projectile->Instigator = Cast<APawn>(owner);
+
+	// Mirror what SpawnActor would do with the same collision handling: adjust out of geometry, or give up
+	if (!projectile->ActivateFromPool(location, rotation, collisionHandling))
+	{
+		freeList.Add(projectile);
+		return nullptr;
+	}
+
+	_activeCount++;
+	_highWaterMark = FMath::Max(_highWaterMark, _activeCount);
+
+	return projectile;
+}
+
+void AProjectilePool::ReleaseProjectile(ARSTestProjectile* projectile)
+{
+	if (!projectile || !projectile->GetIsActiveInPool())
+	{
+		return;
+	}
+
+	projectile->DeactivateToPool();
+	_activeCount--;
+
+	TArray<ARSTestProjectile*>& freeList = _freeProjectiles.FindOrAdd(projectile->GetClass());
+	if (freeList.Num() < _maxFreePerClass)
+	{
+		freeList.Add(projectile);
+	}
+	else
+	{
+		_pooledProjectiles.RemoveSingleSwap(projectile, false);
+		projectile->SetOwnerPool(nullptr);
+		projectile->Destroy();
+	}
+}
+
+void AProjectilePool::ReleaseAll()
+{
+	// Backwards, releasing past the free limit destroys the projectile and takes it out of the array
+	for (int32 i = _pooledProjectiles.Num() - 1; i >= 0; i--)
+	{
+		ReleaseProjectile(_pooledProjectiles[i]);
+	}
+}
+
+void AProjectilePool::ForgetProjectile(ARSTestProjectile* projectile)
+{
+	if (projectile->GetIsActiveInPool())
+	{
+		_activeCount--;
+	}
+
+	_pooledProjectiles.RemoveSingleSwap(projectile, false);
+	if (TArray<ARSTestProjectile*>* freeList = _freeProjectiles.Find(projectile->GetClass()))
+	{
+		freeList->RemoveSingleSwap(projectile, false);
+	}
+}
+
+ARSTestProjectile* AProjectilePool::SpawnPooledProjectile(UClass* projectileClass)
+{
+	UWorld* const world = GetWorld();
+	if (!world)
+	{
+		return nullptr;
+	}
+
+	// Deferred so the projectile knows it belongs to the pool before BeginPlay puts it to sleep
+	ARSTestProjectile* projectile = world->SpawnActorDeferred<ARSTestProjectile>(
+		projectileClass,
+		GetActorTransform(),
+		nullptr,
+		nullptr,
+		ESpawnActorCollisionHandlingMethod::AlwaysSpawn
+		);
+
+	if (projectile)
+	{
+		projectile->SetOwnerPool(this);
+		projectile->FinishSpawning(GetActorTransform());
+		_pooledProjectiles.Add(projectile);
+	}
+
+	return projectile;
+}
+
+void AProjectilePool::LogStats() const
+{
+	UE_LOG(LogProjectilePool, Log, TEXT("Projectile pool: %d pooled, %d active, %d hits, %d misses, %d high-water"),
+		_pooledProjectiles.Num(), _activeCount, _poolHits, _poolMisses, _highWaterMark);
+}
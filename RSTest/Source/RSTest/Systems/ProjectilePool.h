@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "ProjectilePool.generated.h"
+
+class ARSTestProjectile;
+
+/**
+ * Hands out pre-spawned projectiles and takes them back instead of spawning/destroying one per shot.
+ * One pool exists per world, get it through AProjectilePool::Get.
+ */
+UCLASS(config=Game, notplaceable)
+class RSTEST_API AProjectilePool : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AProjectilePool();
+
+	static AProjectilePool* Get(const UObject* worldContextObject);
+
+	//Variables
+protected:
+	UPROPERTY(config, EditDefaultsOnly, Category = "Projectile Pool Data", meta = (ClampMin = 0))
+	int32 _prewarmCount;
+
+	// Returned projectiles above this amount (per class) are destroyed rather than kept around
+	UPROPERTY(config, EditDefaultsOnly, Category = "Projectile Pool Data", meta = (ClampMin = 0))
+	int32 _maxFreePerClass;
+
+private:
+	// Every projectile owned by the pool, in use or not - keeps them referenced for GC
+	UPROPERTY(Transient)
+	TArray<ARSTestProjectile*> _pooledProjectiles;
+
+	TMap<UClass*, TArray<ARSTestProjectile*>> _freeProjectiles;
+
+	int32 _poolHits;
+	int32 _poolMisses;
+	int32 _activeCount;
+	int32 _highWaterMark;
+
+	//GettersAndSetters
+public:
+	UFUNCTION(BlueprintCallable, Category = "Projectile Pool GetSet")
+	int32 GetPoolHits() const { return _poolHits; }
+
+	UFUNCTION(BlueprintCallable, Category = "Projectile Pool GetSet")
+	int32 GetPoolMisses() const { return _poolMisses; }
+
+	UFUNCTION(BlueprintCallable, Category = "Projectile Pool GetSet")
+	int32 GetActiveCount() const { return _activeCount; }
+
+	UFUNCTION(BlueprintCallable, Category = "Projectile Pool GetSet")
+	int32 GetHighWaterMark() const { return _highWaterMark; }
+
+	UFUNCTION(BlueprintCallable, Category = "Projectile Pool GetSet")
+	int32 GetPooledCount() const { return _pooledProjectiles.Num(); }
+
+	//Functions
+public:
+	// Fills the pool up to count free projectiles of the given class, a negative count uses _prewarmCount
+	void Prewarm(TSubclassOf<ARSTestProjectile> projectileClass, int32 count = -1);
+
+	// Returns nullptr if the projectile couldn't be placed (same rules as SpawnActor with the given collision handling)
+	ARSTestProjectile* AcquireProjectile(TSubclassOf<ARSTestProjectile> projectileClass, const FVector& location, const FRotator& rotation, AActor* owner, ESpawnActorCollisionHandlingMethod collisionHandling = ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+
+	void ReleaseProjectile(ARSTestProjectile* projectile);
+
+	// Puts every projectile in use back to sleep
+	void ReleaseAll();
+
+	// Called when a pooled projectile gets destroyed by something other than the pool
+	void ForgetProjectile(ARSTestProjectile* projectile);
+
+	void LogStats() const;
+
+protected:
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	ARSTestProjectile* SpawnPooledProjectile(UClass* projectileClass);
+};
@@ -0,0 +1,409 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProjectileSimulationManager.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/SphereComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "RSTestProjectile.h"
+#include "RSTestStats.h"
+#include "Systems/HitboxHistory.h"
+#include "Systems/WorldManager.h"
+
+// How far a bounced bullet is lifted off the surface it hit
+static const float kBounceSurfaceOffset = 0.5f;
+
+AProjectileSimulationManager::AProjectileSimulationManager()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+	bReplicates = false;
+
+	_projectileInstances = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("ProjectileInstances"));
+	_projectileInstances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	_projectileInstances->bGenerateOverlapEvents = false;
+	_projectileInstances->SetCanEverAffectNavigation(false);
+	_projectileInstances->CastShadow = false;
+	RootComponent = _projectileInstances;
+
+	_maxProjectiles = 2048;
+	_projectileMesh = FSoftObjectPath(TEXT("/Game/FirstPerson/Meshes/FirstPersonProjectileMesh.FirstPersonProjectileMesh"));
+	_projectileMeshScale = FVector(0.06f);
+	_bounceStopSpeed = 5.f;
+
+	_sweepTime = 0.f;
+	_rejectedCount = 0;
+}
+
+AProjectileSimulationManager* AProjectileSimulationManager::Get(const UObject* worldContextObject)
+{
+	return GetWorldManager<AProjectileSimulationManager>(worldContextObject);
+}
+
+void AProjectileSimulationManager::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UStaticMesh* mesh = Cast<UStaticMesh>(_projectileMesh.TryLoad()))
+	{
+		_projectileInstances->SetStaticMesh(mesh);
+	}
+
+	_positions.Reserve(_maxProjectiles);
+	_velocities.Reserve(_maxProjectiles);
+	_sweepEnds.Reserve(_maxProjectiles);
+	_remainingLife.Reserve(_maxProjectiles);
+	_carriedSeconds.Reserve(_maxProjectiles);
+	_bounces.Reserve(_maxProjectiles);
+	_flags.Reserve(_maxProjectiles);
+	_typeIndices.Reserve(_maxProjectiles);
+	_sweepHandles.Reserve(_maxProjectiles);
+	_instigators.Reserve(_maxProjectiles);
+	_rewindSeconds.Reserve(_maxProjectiles);
+
+	_hitboxHistory = AHitboxHistory::Get(this);
+}
+
+void AProjectileSimulationManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Bullets still in the air when the world goes away
+	FRSTestGauges::Add(ERSTestGauge::LiveProjectiles, -_positions.Num());
+
+	Super::EndPlay(EndPlayReason);
+}
+
+int32 AProjectileSimulationManager::FindOrAddType(UClass* projectileClass)
+{
+	for (int32 i = 0; i < _types.Num(); i++)
+	{
+		if (_types[i].ProjectileClass == projectileClass)
+		{
+			return i;
+		}
+	}
+
+	const ARSTestProjectile* projectileDefaults = projectileClass->GetDefaultObject<ARSTestProjectile>();
+	const UProjectileMovementComponent* movementDefaults = projectileDefaults->GetProjectileMovement();
+
+	FProjectileType newType;
+	newType.ProjectileClass = projectileClass;
+	newType.Speed = movementDefaults->InitialSpeed;
+	newType.MaxSpeed = movementDefaults->MaxSpeed;
+	newType.GravityScale = movementDefaults->ProjectileGravityScale;
+	newType.Bounciness = movementDefaults->Bounciness;
+	newType.Friction = movementDefaults->Friction;
+	newType.bShouldBounce = movementDefaults->bShouldBounce;
+	newType.Damage = projectileDefaults->GetDamage();
+	newType.Radius = projectileDefaults->GetCollisionComp()->GetUnscaledSphereRadius();
+	newType.LifeSpan = projectileDefaults->InitialLifeSpan;
+
+	return _types.Add(newType);
+}
+
+bool AProjectileSimulationManager::FireProjectile(TSubclassOf<ARSTestProjectile> projectileClass, const FVector& location, const FRotator& rotation, AActor* instigator)
+{
+	if (!projectileClass || _types.Num() >= MAX_uint8)
+	{
+		return false;
+	}
+
+	if (_positions.Num() >= _maxProjectiles)
+	{
+		_rejectedCount++;
+		return false;
+	}
+
+	const int32 typeIndex = FindOrAddType(projectileClass);
+	const FProjectileType& type = _types[typeIndex];
+
+	_positions.Add(location);
+	_velocities.Add(rotation.Vector() * type.Speed);
+	_sweepEnds.Add(location);
+	_remainingLife.Add(type.LifeSpan > 0.f ? type.LifeSpan : MAX_FLT);
+	_carriedSeconds.Add(0.f);
+	_bounces.Add(0);
+	_flags.Add(0);
+	_typeIndices.Add((uint8)typeIndex);
+	_sweepHandles.Add(FTraceHandle());
+	_instigators.Add(instigator);
+	_rewindSeconds.Add(_hitboxHistory.IsValid() ? _hitboxHistory->GetRewindSeconds(instigator) : 0.f);
+
+	FRSTestGauges::Add(ERSTestGauge::LiveProjectiles, 1);
+	return true;
+}
+
+void AProjectileSimulationManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (_positions.Num() == 0 && _projectileInstances->GetInstanceCount() == 0)
+	{
+		return;
+	}
+
+	ResolveSweeps();
+	Integrate(DeltaTime);
+	RemoveFlaggedBullets();
+	IssueSweeps();
+	UpdateInstances();
+}
+
+// Reads back the sweeps issued last frame and commits each bullet to the end of its sweep or to what it hit
+void AProjectileSimulationManager::ResolveSweeps()
+{
+	UWorld* const world = GetWorld();
+	FTraceDatum traceData;
+
+	const int32 bulletCount = _positions.Num();
+	for (int32 i = 0; i < bulletCount; i++)
+	{
+		if (!_sweepHandles[i].IsValid())
+		{
+			continue;
+		}
+
+		const bool hasData = world->QueryTraceData(_sweepHandles[i], traceData);
+		_sweepHandles[i].Invalidate();
+
+		const FHitResult* blockingHit = nullptr;
+		if (hasData)
+		{
+			for (const FHitResult& hit : traceData.OutHits)
+			{
+				if (hit.bBlockingHit)
+				{
+					blockingHit = &hit;
+					break;
+				}
+			}
+		}
+
+		// Characters weren't in the sweep, anything hit in the history before the scene hit comes first
+		FHitResult rewoundHit;
+		if (_rewindSeconds[i] > 0.f && FindRewoundHit(i, blockingHit ? blockingHit->Location : _sweepEnds[i], rewoundHit))
+		{
+			blockingHit = &rewoundHit;
+		}
+
+		if (blockingHit)
+		{
+			if (HandleHit(i, *blockingHit))
+			{
+				_flags[i] |= BF_Remove;
+			}
+		}
+		else
+		{
+			_positions[i] = _sweepEnds[i];
+		}
+	}
+}
+
+bool AProjectileSimulationManager::HandleHit(int32 bulletIndex, const FHitResult& hit)
+{
+	const FProjectileType& type = _types[_typeIndices[bulletIndex]];
+
+	// Part of the sweep after the hit, sweeps are always velocity times the time they cover
+	const float speed = _velocities[bulletIndex].Size();
+	const float remainingSeconds = speed > KINDA_SMALL_NUMBER ? (1.f - hit.Time) * FVector::Dist(_positions[bulletIndex], _sweepEnds[bulletIndex]) / speed : 0.f;
+
+	_positions[bulletIndex] = hit.Location;
+
+	// Same damage rules as the actor projectile, the bullet is used up if it hurt something
+	if (ARSTestProjectile::ApplyHitDamage(_instigators[bulletIndex].Get(), hit.GetActor(), type.Damage))
+	{
+		return true;
+	}
+
+	if (!type.bShouldBounce)
+	{
+		_velocities[bulletIndex] = FVector::ZeroVector;
+		_flags[bulletIndex] |= BF_Resting;
+		return false;
+	}
+
+	// Mirrors UProjectileMovementComponent::ComputeBounceDelta
+	FVector velocity = _velocities[bulletIndex];
+	const FVector normal = hit.Normal;
+	const float velocityDotNormal = FVector::DotProduct(velocity, normal);
+	if (velocityDotNormal <= 0.f)
+	{
+		const FVector projectedNormal = normal * -velocityDotNormal;
+		velocity += projectedNormal;
+		velocity *= FMath::Clamp(1.f - type.Friction, 0.f, 1.f);
+		velocity += projectedNormal * FMath::Max(type.Bounciness, 0.f);
+		if (type.MaxSpeed > 0.f)
+		{
+			velocity = velocity.GetClampedToMaxSize(type.MaxSpeed);
+		}
+	}
+
+	_bounces[bulletIndex] = (uint8)FMath::Min(_bounces[bulletIndex] + 1, (int32)MAX_uint8);
+
+	if (velocity.SizeSquared() < FMath::Square(_bounceStopSpeed))
+	{
+		velocity = FVector::ZeroVector;
+		_flags[bulletIndex] |= BF_Resting;
+	}
+	else
+	{
+		// Off the surface, a sweep starting in contact with it comes back as an initial overlap and pins the bullet there.
+		// The rest of the frame is spent on the new velocity in next frame's sweep, rather than moved here without one
+		_positions[bulletIndex] += hit.Normal * kBounceSurfaceOffset;
+		_carriedSeconds[bulletIndex] = remainingSeconds;
+	}
+
+	_velocities[bulletIndex] = velocity;
+	return false;
+}
+
+bool AProjectileSimulationManager::FindRewoundHit(int32 bulletIndex, const FVector& sweepEnd, FHitResult& outHit) const
+{
+	FHitboxRewindHit rewoundHit;
+	if (!_hitboxHistory.IsValid() || !_hitboxHistory->SweepRewound(_positions[bulletIndex], sweepEnd, _types[_typeIndices[bulletIndex]].Radius,
+		_sweepTime - _rewindSeconds[bulletIndex], _instigators[bulletIndex].Get(), rewoundHit))
+	{
+		return false;
+	}
+
+	outHit = FHitResult(rewoundHit.Actor, rewoundHit.Capsule, rewoundHit.Location, rewoundHit.Normal);
+	outHit.bBlockingHit = true;
+
+	const float sweepLength = FVector::Dist(_positions[bulletIndex], _sweepEnds[bulletIndex]);
+	outHit.Time = sweepLength > KINDA_SMALL_NUMBER ? FMath::Clamp(rewoundHit.Distance / sweepLength, 0.f, 1.f) : 0.f;
+	return true;
+}
+
+void AProjectileSimulationManager::Integrate(float deltaTime)
+{
+	const int32 bulletCount = _positions.Num();
+	const float gravityStep = GetWorld()->GetGravityZ() * deltaTime;
+
+	// Kept as separate flat loops over each array so the compiler can vectorize them
+	float* remainingLife = _remainingLife.GetData();
+	uint8* flags = _flags.GetData();
+	for (int32 i = 0; i < bulletCount; i++)
+	{
+		remainingLife[i] -= deltaTime;
+		flags[i] |= (remainingLife[i] <= 0.f) ? BF_Remove : 0;
+	}
+
+	FVector* velocities = _velocities.GetData();
+	const uint8* typeIndices = _typeIndices.GetData();
+	for (int32 i = 0; i < bulletCount; i++)
+	{
+		const float gravityScale = (flags[i] & BF_Resting) ? 0.f : _types[typeIndices[i]].GravityScale;
+		velocities[i].Z += gravityStep * gravityScale;
+	}
+
+	// Time a bounce didn't get to spend last frame goes on the front of this frame's sweep
+	const FVector* positions = _positions.GetData();
+	FVector* sweepEnds = _sweepEnds.GetData();
+	float* carriedSeconds = _carriedSeconds.GetData();
+	for (int32 i = 0; i < bulletCount; i++)
+	{
+		sweepEnds[i] = positions[i] + velocities[i] * (deltaTime + carriedSeconds[i]);
+		carriedSeconds[i] = 0.f;
+	}
+}
+
+void AProjectileSimulationManager::IssueSweeps()
+{
+	UWorld* const world = GetWorld();
+	_sweepTime = world->GetTimeSeconds();
+
+	FCollisionResponseParams rewoundResponseParams;
+	rewoundResponseParams.CollisionResponse.SetResponse(ECC_Pawn, ECR_Ignore);
+
+	const int32 bulletCount = _positions.Num();
+	for (int32 i = 0; i < bulletCount; i++)
+	{
+		if (_flags[i] & BF_Resting)
+		{
+			continue;
+		}
+
+		FCollisionQueryParams sweepParams(FName(TEXT("BatchedProjectileSweep")), false);
+		if (_instigators[i].IsValid())
+		{
+			sweepParams.AddIgnoredActor(_instigators[i].Get());
+		}
+
+		_sweepHandles[i] = world->AsyncSweepByChannel(
+			EAsyncTraceType::Single,
+			_positions[i],
+			_sweepEnds[i],
+			ECC_GameTraceChannel1, // Projectile object channel, gives the same responses as the "Projectile" profile
+			FCollisionShape::MakeSphere(_types[_typeIndices[i]].Radius),
+			sweepParams,
+			_rewindSeconds[i] > 0.f ? rewoundResponseParams : FCollisionResponseParams::DefaultResponseParam
+			);
+		FRSTestQueryCounters::ProjectileSweeps++;
+	}
+}
+
+void AProjectileSimulationManager::ClearProjectiles()
+{
+	// Sweeps still in flight are never read back, their results are just dropped
+	for (int32 i = _positions.Num() - 1; i >= 0; i--)
+	{
+		RemoveBulletAtSwap(i);
+	}
+
+	UpdateInstances();
+}
+
+void AProjectileSimulationManager::RemoveFlaggedBullets()
+{
+	for (int32 i = _positions.Num() - 1; i >= 0; i--)
+	{
+		if (_flags[i] & BF_Remove)
+		{
+			RemoveBulletAtSwap(i);
+		}
+	}
+}
+
+void AProjectileSimulationManager::RemoveBulletAtSwap(int32 bulletIndex)
+{
+	_positions.RemoveAtSwap(bulletIndex, 1, false);
+	_velocities.RemoveAtSwap(bulletIndex, 1, false);
+	_sweepEnds.RemoveAtSwap(bulletIndex, 1, false);
+	_remainingLife.RemoveAtSwap(bulletIndex, 1, false);
+	_carriedSeconds.RemoveAtSwap(bulletIndex, 1, false);
+	_bounces.RemoveAtSwap(bulletIndex, 1, false);
+	_flags.RemoveAtSwap(bulletIndex, 1, false);
+	_typeIndices.RemoveAtSwap(bulletIndex, 1, false);
+	_sweepHandles.RemoveAtSwap(bulletIndex, 1, false);
+	_instigators.RemoveAtSwap(bulletIndex, 1, false);
+	_rewindSeconds.RemoveAtSwap(bulletIndex, 1, false);
+
+	FRSTestGauges::Add(ERSTestGauge::LiveProjectiles, -1);
+}
+
+// One instance per live bullet, instances past the live count are trimmed from the end so indices never shift
+void AProjectileSimulationManager::UpdateInstances()
+{
+	const int32 bulletCount = _positions.Num();
+
+	while (_projectileInstances->GetInstanceCount() > bulletCount)
+	{
+		_projectileInstances->RemoveInstance(_projectileInstances->GetInstanceCount() - 1);
+	}
+
+	for (int32 i = 0; i < bulletCount; i++)
+	{
+		const FTransform instanceTransform(_velocities[i].ToOrientationQuat(), _positions[i], _projectileMeshScale);
+		if (i < _projectileInstances->GetInstanceCount())
+		{
+			_projectileInstances->UpdateInstanceTransform(i, instanceTransform, true, false, true);
+		}
+		else
+		{
+			_projectileInstances->AddInstanceWorldSpace(instanceTransform);
+		}
+	}
+
+	_projectileInstances->MarkRenderStateDirty();
+}
@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "WorldCollision.h"
+#include "ProjectileSimulationManager.generated.h"
+
+class AHitboxHistory;
+class ARSTestProjectile;
+class UInstancedStaticMeshComponent;
+
+/**
+ * Simulates player bullets without an actor each: all live bullets are kept in flat arrays and moved in one pass per frame.
+ * Collision is resolved with async sweeps that are issued one frame and read back the next, so bullets are
+ * drawn at their last confirmed position. Movement rules are taken from the projectile class defaults.
+ */
+UCLASS(config=Game, notplaceable)
+class RSTEST_API AProjectileSimulationManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AProjectileSimulationManager();
+
+	static AProjectileSimulationManager* Get(const UObject* worldContextObject);
+
+	//Variables
+protected:
+	// Hard cap on bullets in flight, this bounds the per-frame cost (one sweep per bullet)
+	UPROPERTY(config, EditDefaultsOnly, Category = "Projectile Simulation Data", meta = (ClampMin = 1))
+	int32 _maxProjectiles;
+
+	UPROPERTY(config, EditDefaultsOnly, Category = "Projectile Simulation Data")
+	FSoftObjectPath _projectileMesh;
+
+	UPROPERTY(config, EditDefaultsOnly, Category = "Projectile Simulation Data")
+	FVector _projectileMeshScale;
+
+	// Speed below which a bouncing bullet comes to rest, same as UProjectileMovementComponent's default
+	UPROPERTY(config, EditDefaultsOnly, Category = "Projectile Simulation Data")
+	float _bounceStopSpeed;
+
+private:
+	// Movement rules shared by every bullet fired from the same projectile class
+	struct FProjectileType
+	{
+		UClass* ProjectileClass;
+		float Speed;
+		float MaxSpeed;
+		float GravityScale;
+		float Bounciness;
+		float Friction;
+		float Damage;
+		float Radius;
+		float LifeSpan;
+		bool bShouldBounce;
+	};
+
+	enum EBulletFlags : uint8
+	{
+		BF_Resting = 1 << 0,
+		BF_Remove = 1 << 1,
+	};
+
+	TArray<FProjectileType> _types;
+
+	// Structure of arrays, index i is the same bullet in all of them
+	TArray<FVector> _positions;
+	TArray<FVector> _velocities;
+	TArray<FVector> _sweepEnds;
+	TArray<float> _remainingLife;
+	TArray<float> _carriedSeconds;
+	TArray<uint8> _bounces;
+	TArray<uint8> _flags;
+	TArray<uint8> _typeIndices;
+	TArray<FTraceHandle> _sweepHandles;
+	TArray<TWeakObjectPtr<AActor>> _instigators;
+
+	// Lag compensation, above 0 the bullet hits characters where they were this long before the sweep (see AHitboxHistory)
+	// and its physics sweeps ignore their current capsules
+	TArray<float> _rewindSeconds;
+
+	TWeakObjectPtr<AHitboxHistory> _hitboxHistory;
+
+	// When last frame's sweeps were issued, what the rewound tests are measured back from
+	float _sweepTime;
+
+	int32 _rejectedCount;
+
+	//GettersAndSetters
+public:
+	UFUNCTION(BlueprintCallable, Category = "Projectile Simulation GetSet")
+	int32 GetLiveCount() const { return _positions.Num(); }
+
+	UFUNCTION(BlueprintCallable, Category = "Projectile Simulation GetSet")
+	int32 GetRejectedCount() const { return _rejectedCount; }
+
+	//Functions
+public:
+	// Returns false if the manager is full, the caller can then fall back to an actor projectile
+	bool FireProjectile(TSubclassOf<ARSTestProjectile> projectileClass, const FVector& location, const FRotator& rotation, AActor* instigator);
+
+	// Removes every bullet in flight without it hitting anything
+	void ClearProjectiles();
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	int32 FindOrAddType(UClass* projectileClass);
+
+	void ResolveSweeps();
+
+	void Integrate(float deltaTime);
+
+	void IssueSweeps();
+
+	void RemoveFlaggedBullets();
+
+	void UpdateInstances();
+
+	// Returns true if the bullet is used up by the hit
+	bool HandleHit(int32 bulletIndex, const FHitResult& hit);
+
+	// Tests the bullet's last sweep, up to sweepEnd, against the hitbox history
+	bool FindRewoundHit(int32 bulletIndex, const FVector& sweepEnd, FHitResult& outHit) const;
+
+	void RemoveBulletAtSwap(int32 bulletIndex);
+
+	//Visuals
+protected:
+	UPROPERTY(VisibleDefaultsOnly)
+	UInstancedStaticMeshComponent* _projectileInstances;
+};
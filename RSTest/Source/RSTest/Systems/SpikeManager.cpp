@@ -0,0 +1,223 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpikeManager.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+#include "Interfaces/Damageable.h"
+#include "Powers/EarthSpike.h"
+#include "Systems/WorldManager.h"
+
+ASpikeManager::ASpikeManager()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false; // Only while spikes are growing
+	bReplicates = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+	RootComponent->SetMobility(EComponentMobility::Static);
+
+	_maxSpikeCount = 64;
+}
+
+ASpikeManager* ASpikeManager::Get(const UObject* worldContextObject)
+{
+	return GetWorldManager<ASpikeManager>(worldContextObject);
+}
+
+int32 ASpikeManager::GetRetiredSpikeCount() const
+{
+	int32 result = 0;
+	for (const FSpikeInstanceRing& ring : _spikeRings)
+	{
+		result += ring.Instances->GetInstanceCount();
+	}
+	return result;
+}
+
+bool ASpikeManager::GetOverlapsSpike(const FBox& worldBox) const
+{
+	// Spike actors, growing or still waiting to
+	for (TActorIterator<AEarthSpike> it(GetWorld()); it; ++it)
+	{
+		if (it->GetComponentsBoundingBox().Intersect(worldBox))
+		{
+			return true;
+		}
+	}
+
+	for (const FSpikeInstanceRing& ring : _spikeRings)
+	{
+		const FBox meshBounds = ring.Mesh->GetBoundingBox();
+		const int32 instanceCount = ring.Instances->GetInstanceCount();
+		for (int32 instance = 0; instance < instanceCount; instance++)
+		{
+			FTransform instanceTransform;
+			ring.Instances->GetInstanceTransform(instance, instanceTransform, true);
+			if (meshBounds.TransformBy(instanceTransform).Intersect(worldBox))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void ASpikeManager::RetireSpike(AEarthSpike* spike)
+{
+	UStaticMeshComponent* spikeMesh = spike ? spike->GetPowerMesh() : nullptr;
+	if (!spikeMesh || !spikeMesh->GetStaticMesh())
+	{
+		return;
+	}
+
+	FSpikeInstanceRing& ring = FindOrAddRing(spikeMesh);
+	const FTransform spikeTransform = spikeMesh->GetComponentTransform();
+
+	if (ring.Instances->GetInstanceCount() < _maxSpikeCount)
+	{
+		ring.Instances->AddInstanceWorldSpace(spikeTransform);
+	}
+	else
+	{
+		// Full, so the oldest spike is moved to where the new one is rather than removing and re-adding
+		ring.Instances->UpdateInstanceTransform(ring.OldestSlot, spikeTransform, true, true, true);
+		ring.OldestSlot = (ring.OldestSlot + 1) % _maxSpikeCount;
+	}
+
+	spike->Destroy();
+}
+
+void ASpikeManager::RegisterGrowingSpike(AEarthSpike* spike)
+{
+	_growingSpikes.AddUnique(spike);
+	SetActorTickEnabled(true);
+}
+
+void ASpikeManager::ClearSpikes()
+{
+	// Not just the growing ones, spikes that grow with physics overlaps never register here
+	for (TActorIterator<AEarthSpike> it(GetWorld()); it; ++it)
+	{
+		it->Destroy();
+	}
+	_growingSpikes.Reset();
+
+	for (FSpikeInstanceRing& ring : _spikeRings)
+	{
+		ring.Instances->ClearInstances();
+		ring.OldestSlot = 0;
+	}
+
+	SetActorTickEnabled(false);
+}
+
+void ASpikeManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const float worldTime = GetWorld()->GetTimeSeconds();
+
+	// A client's spikes are only for show, the server's copies do the hitting
+	if (GetNetMode() != NM_Client)
+	{
+		GatherTargets();
+	}
+	else
+	{
+		_targets.Reset();
+	}
+
+	for (int32 i = _growingSpikes.Num() - 1; i >= 0; i--)
+	{
+		AEarthSpike* spike = _growingSpikes[i];
+		if (!spike || spike->IsPendingKill())
+		{
+			_growingSpikes.RemoveAtSwap(i);
+			continue;
+		}
+
+		// The spike only ever grows out from its base, so its current box covers everything it swept through since last frame
+		const bool stillGrowing = spike->UpdateAnalyticGrowth(worldTime);
+		for (const FSpikeTarget& target : _targets)
+		{
+			spike->TestAnalyticHit(target.Actor, target.CapsuleStart, target.CapsuleEnd, target.CapsuleRadius);
+		}
+
+		if (!stillGrowing)
+		{
+			_growingSpikes.RemoveAtSwap(i);
+			spike->FinishAnalyticGrowth();
+		}
+	}
+
+	if (_growingSpikes.Num() == 0)
+	{
+		SetActorTickEnabled(false);
+	}
+}
+
+// Spikes only hurt players, so the candidates are just the player pawns
+void ASpikeManager::GatherTargets()
+{
+	_targets.Reset();
+
+	for (FConstPlayerControllerIterator it = GetWorld()->GetPlayerControllerIterator(); it; ++it)
+	{
+		APlayerController* playerController = it->Get();
+		ACharacter* character = playerController ? Cast<ACharacter>(playerController->GetPawn()) : nullptr;
+		IDamageable* damageable = Cast<IDamageable>(character);
+		if (!damageable || damageable->GetDamageTeam() != EDamageTeam::DT_Player)
+		{
+			continue;
+		}
+
+		const UCapsuleComponent* capsule = character->GetCapsuleComponent();
+		const FVector capsuleAxis = capsule->GetUpVector() * capsule->GetScaledCapsuleHalfHeight_WithoutHemisphere();
+
+		FSpikeTarget target;
+		target.Actor = character;
+		target.CapsuleStart = capsule->GetComponentLocation() + capsuleAxis;
+		target.CapsuleEnd = capsule->GetComponentLocation() - capsuleAxis;
+		target.CapsuleRadius = capsule->GetScaledCapsuleRadius();
+		_targets.Add(target);
+	}
+}
+
+ASpikeManager::FSpikeInstanceRing& ASpikeManager::FindOrAddRing(const UStaticMeshComponent* spikeMesh)
+{
+	UStaticMesh* mesh = spikeMesh->GetStaticMesh();
+	for (FSpikeInstanceRing& ring : _spikeRings)
+	{
+		if (ring.Mesh == mesh)
+		{
+			return ring;
+		}
+	}
+
+	UHierarchicalInstancedStaticMeshComponent* instances = NewObject<UHierarchicalInstancedStaticMeshComponent>(this);
+	instances->SetMobility(EComponentMobility::Movable); // Instances are added and moved at runtime, Static is only for what the lighting build sees
+	instances->SetStaticMesh(mesh);
+	for (int32 i = 0; i < spikeMesh->GetNumMaterials(); i++)
+	{
+		instances->SetMaterial(i, spikeMesh->GetMaterial(i));
+	}
+	instances->SetCollisionProfileName(spikeMesh->GetCollisionProfileName());
+	instances->SetCollisionObjectType(spikeMesh->GetCollisionObjectType());
+	instances->bGenerateOverlapEvents = true; // With the WallRunnable object type above, keeps retired spikes wall runnable
+	instances->CastShadow = spikeMesh->CastShadow;
+	instances->SetupAttachment(RootComponent);
+	instances->RegisterComponent();
+	_spikeInstanceComponents.Add(instances);
+
+	FSpikeInstanceRing newRing;
+	newRing.Mesh = mesh;
+	newRing.Instances = instances;
+	newRing.OldestSlot = 0;
+	return _spikeRings[_spikeRings.Add(newRing)];
+}
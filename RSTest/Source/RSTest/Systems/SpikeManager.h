@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "SpikeManager.generated.h"
+
+class AEarthSpike;
+class UHierarchicalInstancedStaticMeshComponent;
+class UStaticMesh;
+
+/**
+ * Finished Earth Spikes are handed over here and turned into instances of one hierarchical instanced mesh per spike mesh,
+ * the instances carry the spike's collision. Only _maxSpikeCount finished spikes are kept, the oldest is reused first.
+ * Spikes using analytic growth are also grown here, with one hit test pass against the players for all of them.
+ */
+UCLASS(config=Game, notplaceable)
+class RSTEST_API ASpikeManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ASpikeManager();
+
+	static ASpikeManager* Get(const UObject* worldContextObject);
+
+	//Variables
+protected:
+	// Per spike mesh - there's only ever been the one
+	UPROPERTY(config, EditDefaultsOnly, Category = "Spike Manager Data", meta = (ClampMin = 1))
+	int32 _maxSpikeCount;
+
+private:
+	struct FSpikeInstanceRing
+	{
+		UStaticMesh* Mesh;
+		UHierarchicalInstancedStaticMeshComponent* Instances;
+		int32 OldestSlot;
+	};
+
+	UPROPERTY(Transient)
+	TArray<UHierarchicalInstancedStaticMeshComponent*> _spikeInstanceComponents;
+
+	UPROPERTY(Transient)
+	TArray<AEarthSpike*> _growingSpikes;
+
+	struct FSpikeTarget
+	{
+		AActor* Actor;
+		FVector CapsuleStart;
+		FVector CapsuleEnd;
+		float CapsuleRadius;
+	};
+
+	TArray<FSpikeTarget> _targets;
+
+	TArray<FSpikeInstanceRing> _spikeRings;
+
+	//GettersAndSetters
+public:
+	UFUNCTION(BlueprintCallable, Category = "Spike Manager GetSet")
+	int32 GetRetiredSpikeCount() const;
+
+	// Whether any spike, as an actor or a finished instance, has colliding bounds touching the box. Checks each one, there are
+	// only ever _maxSpikeCount instances
+	bool GetOverlapsSpike(const FBox& worldBox) const;
+
+	//Functions
+public:
+	// Replaces a finished spike actor with an instance, the actor is destroyed
+	void RetireSpike(AEarthSpike* spike);
+
+	void RegisterGrowingSpike(AEarthSpike* spike);
+
+	// Destroys every spike actor in the world and removes the finished spike instances
+	void ClearSpikes();
+
+protected:
+	virtual void Tick(float DeltaTime) override;
+
+	void GatherTargets();
+
+	FSpikeInstanceRing& FindOrAddRing(const class UStaticMeshComponent* spikeMesh);
+};
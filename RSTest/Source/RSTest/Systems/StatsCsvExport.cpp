@@ -0,0 +1,129 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "StatsCsvExport.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/Paths.h"
+#include "RSTestStats.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogStatsCsvExport, Log, All);
+
+static FArchive* GStatsCsvFile = nullptr;
+static FString GStatsCsvFilePath;
+static FDelegateHandle GStatsCsvEndFrameHandle;
+static FDelegateHandle GStatsCsvPreExitHandle;
+static uint64 GStatsCsvFirstFrame = 0;
+static uint64 GStatsCsvQueriesAtLastRow = 0;
+
+static FAutoConsoleCommand GStatsCsvCommand(
+	TEXT("RSTest.Stats.Csv"),
+	TEXT("Starts or stops writing the RSTest hot path counters and gauges to a CSV file in Saved/Profiling, one row per frame. Takes start or stop, toggles without one"),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& args)
+	{
+		const bool start = args.Num() > 0 ? args[0].Equals(TEXT("start"), ESearchCase::IgnoreCase) : !GetIsStatsCsvExportRunning();
+		if (start)
+		{
+			StartStatsCsvExport();
+		}
+		else
+		{
+			StopStatsCsvExport();
+		}
+	})
+);
+
+static void WriteStatsCsvLine(const FString& line)
+{
+	FTCHARToUTF8 utf8Line(*(line + LINE_TERMINATOR));
+	GStatsCsvFile->Serialize((void*)utf8Line.Get(), utf8Line.Length());
+}
+
+static void WriteStatsCsvRow()
+{
+	// GGameThreadTime is last frame's game thread time, the scope counters below are this frame's
+	FString row = FString::Printf(TEXT("%llu,%.3f,%.3f"),
+		GFrameCounter - GStatsCsvFirstFrame, FApp::GetDeltaTime() * 1000.0, FPlatformTime::ToMilliseconds(GGameThreadTime));
+
+	const double msPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1000.0;
+	for (int32 i = 0; i < (int32)ERSTestScope::Count; i++)
+	{
+		row += FString::Printf(TEXT(",%.4f,%llu"), FRSTestScopeCounters::Cycles[i] * msPerCycle, FRSTestScopeCounters::Calls[i]);
+	}
+
+	for (int32 i = 0; i < (int32)ERSTestGauge::Count; i++)
+	{
+		row += FString::Printf(TEXT(",%d"), FRSTestGauges::Get((ERSTestGauge)i));
+	}
+
+	const uint64 queryCount = FRSTestQueryCounters::GetTotal();
+	row += FString::Printf(TEXT(",%llu"), queryCount - GStatsCsvQueriesAtLastRow);
+	GStatsCsvQueriesAtLastRow = queryCount;
+
+	WriteStatsCsvLine(row);
+	FRSTestScopeCounters::Reset();
+}
+
+void StartStatsCsvExport()
+{
+	if (GStatsCsvFile)
+	{
+		return;
+	}
+
+	const FString fileName = FString::Printf(TEXT("RSTest-%s.csv"), *FDateTime::Now().ToString());
+	GStatsCsvFilePath = FPaths::Combine(FPaths::ProfilingDir(), fileName);
+	GStatsCsvFile = IFileManager::Get().CreateFileWriter(*GStatsCsvFilePath);
+	if (!GStatsCsvFile)
+	{
+		UE_LOG(LogStatsCsvExport, Warning, TEXT("Stats CSV: couldn't open %s"), *GStatsCsvFilePath);
+		return;
+	}
+
+	FString header = TEXT("Frame,FrameMs,GameThreadMs");
+	for (int32 i = 0; i < (int32)ERSTestScope::Count; i++)
+	{
+		const TCHAR* scopeName = FRSTestScopeCounters::GetName((ERSTestScope)i);
+		header += FString::Printf(TEXT(",%sMs,%sCalls"), scopeName, scopeName);
+	}
+	for (int32 i = 0; i < (int32)ERSTestGauge::Count; i++)
+	{
+		header += FString::Printf(TEXT(",%s"), FRSTestGauges::GetName((ERSTestGauge)i));
+	}
+	header += TEXT(",GameQueries");
+	WriteStatsCsvLine(header);
+
+	// Anything counted before now would all land in the first row
+	FRSTestScopeCounters::Reset();
+	GStatsCsvFirstFrame = GFrameCounter;
+	GStatsCsvQueriesAtLastRow = FRSTestQueryCounters::GetTotal();
+
+	GStatsCsvEndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&WriteStatsCsvRow);
+	GStatsCsvPreExitHandle = FCoreDelegates::OnPreExit.AddStatic(&StopStatsCsvExport);
+
+	UE_LOG(LogStatsCsvExport, Log, TEXT("Stats CSV: writing to %s"), *GStatsCsvFilePath);
+}
+
+void StopStatsCsvExport()
+{
+	if (!GStatsCsvFile)
+	{
+		return;
+	}
+
+	FCoreDelegates::OnEndFrame.Remove(GStatsCsvEndFrameHandle);
+	FCoreDelegates::OnPreExit.Remove(GStatsCsvPreExitHandle);
+
+	const uint64 rowCount = GFrameCounter - GStatsCsvFirstFrame;
+	GStatsCsvFile->Close();
+	delete GStatsCsvFile;
+	GStatsCsvFile = nullptr;
+
+	UE_LOG(LogStatsCsvExport, Log, TEXT("Stats CSV: wrote %llu frames to %s"), rowCount, *GStatsCsvFilePath);
+}
+
+bool GetIsStatsCsvExportRunning()
+{
+	return GStatsCsvFile != nullptr;
+}
@@ -0,0 +1,19 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Writes one row per frame to Saved/Profiling/RSTest-<time>.csv: frame and game thread time, the time and calls of every
+ * RSTest hot path (ERSTestScope), the live entity gauges and the scene queries issued by game code that frame.
+ * Works without a stats build, so it can be left running on a headless -nullrhi run. Start it with -RSStatsCsv on the
+ * command line or RSTest.Stats.Csv from the console, it's closed when the game exits.
+ */
+
+// Opens a new file and starts writing rows at the end of every frame, does nothing if an export is already running
+RSTEST_API void StartStatsCsvExport();
+
+RSTEST_API void StopStatsCsvExport();
+
+RSTEST_API bool GetIsStatsCsvExportRunning();
@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TickPolicy.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "Systems/WorldManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTickPolicy, Log, All);
+
+static FAutoConsoleCommandWithWorld GTickListCommand(
+	TEXT("RSTest.Tick.List"),
+	TEXT("Logs every actor in the current world with its tick on, its tick interval and why it's ticking"),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* world)
+	{
+		const ATickReasonRegistry* tickReasons = ATickReasonRegistry::Get(world, false);
+
+		int32 actorCount = 0;
+		int32 tickingCount = 0;
+		for (TActorIterator<AActor> it(world); it; ++it)
+		{
+			const AActor* actor = *it;
+			actorCount++;
+
+			if (!actor->PrimaryActorTick.IsTickFunctionRegistered() || !actor->IsActorTickEnabled())
+			{
+				continue;
+			}
+			tickingCount++;
+
+			// Actors that don't use the policy are ticking because their class never turns it off
+			FName reason = tickReasons ? tickReasons->GetTickReason(actor) : NAME_None;
+			if (reason.IsNone())
+			{
+				reason = GetHasBlueprintTick(actor) ? FName(TEXT("BlueprintTick")) : FName(TEXT("AlwaysOn"));
+			}
+
+			UE_LOG(LogTickPolicy, Log, TEXT("  %s (%s) interval %.3f, %s"),
+				*actor->GetName(), *actor->GetClass()->GetName(), actor->GetActorTickInterval(), *reason.ToString());
+		}
+
+		UE_LOG(LogTickPolicy, Log, TEXT("%d of %d actors ticking"), tickingCount, actorCount);
+	})
+);
+
+void SetActorTickActive(AActor* actor, bool active, FName reason)
+{
+	if (!actor)
+	{
+		return;
+	}
+
+	actor->SetActorTickEnabled(active);
+
+	// Only spawn the registry when there's a reason to keep, turning ticks off can happen while the world is tearing down
+	ATickReasonRegistry* tickReasons = ATickReasonRegistry::Get(actor, active);
+	if (!tickReasons)
+	{
+		return;
+	}
+
+	if (active)
+	{
+		tickReasons->AddTickReason(actor, reason);
+	}
+	else
+	{
+		tickReasons->RemoveTickReason(actor);
+	}
+}
+
+bool GetHasBlueprintTick(const AActor* actor)
+{
+	static const FName receiveTickName = GET_FUNCTION_NAME_CHECKED(AActor, ReceiveTick);
+	return actor && actor->GetClass()->IsFunctionImplementedInBlueprint(receiveTickName);
+}
+
+ATickReasonRegistry::ATickReasonRegistry()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+}
+
+ATickReasonRegistry* ATickReasonRegistry::Get(const UObject* worldContextObject, bool spawnIfMissing)
+{
+	return GetWorldManager<ATickReasonRegistry>(worldContextObject, spawnIfMissing);
+}
+
+void ATickReasonRegistry::AddTickReason(AActor* actor, FName reason)
+{
+	_tickReasons.Add(actor, reason);
+	actor->OnEndPlay.AddUniqueDynamic(this, &ATickReasonRegistry::OnActorEndPlay);
+}
+
+void ATickReasonRegistry::RemoveTickReason(AActor* actor)
+{
+	if (_tickReasons.Remove(actor) > 0)
+	{
+		actor->OnEndPlay.RemoveDynamic(this, &ATickReasonRegistry::OnActorEndPlay);
+	}
+}
+
+void ATickReasonRegistry::OnActorEndPlay(AActor* actor, EEndPlayReason::Type endPlayReason)
+{
+	_tickReasons.Remove(actor);
+}
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "TickPolicy.generated.h"
+
+/**
+ * Powers and enemies start with their tick off and only switch it on while they have per-frame work.
+ * They go through here so RSTest.Tick.List can show every ticking actor in the world and why it's ticking.
+ */
+
+// Turns the actor's tick on or off, the reason is what RSTest.Tick.List reports while it's on
+RSTEST_API void SetActorTickActive(AActor* actor, bool active, FName reason);
+
+// True if the actor's blueprint implements Event Tick, that graph is per-frame work the native class can't see
+RSTEST_API bool GetHasBlueprintTick(const AActor* actor);
+
+/**
+ * Why each actor in this world that went through SetActorTickActive is ticking.
+ * Entries go away when the tick is turned off or the actor ends play, so destroyed actors don't pile up.
+ */
+UCLASS(notplaceable)
+class RSTEST_API ATickReasonRegistry : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ATickReasonRegistry();
+
+	static ATickReasonRegistry* Get(const UObject* worldContextObject, bool spawnIfMissing = true);
+
+	//Variables
+private:
+	TMap<TWeakObjectPtr<const AActor>, FName> _tickReasons;
+
+	//GettersAndSetters
+public:
+	FName GetTickReason(const AActor* actor) const { return _tickReasons.FindRef(actor); }
+
+	//Functions
+public:
+	void AddTickReason(AActor* actor, FName reason);
+
+	void RemoveTickReason(AActor* actor);
+
+protected:
+	UFUNCTION()
+	void OnActorEndPlay(AActor* actor, EEndPlayReason::Type endPlayReason);
+};
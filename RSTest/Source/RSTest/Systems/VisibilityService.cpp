@@ -0,0 +1,282 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "VisibilityService.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "RSTestStats.h"
+#include "Systems/WorldManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVisibilityService, Log, All);
+
+static FAutoConsoleCommandWithWorld GVisibilityStatsCommand(
+	TEXT("RSTest.Visibility.Stats"),
+	TEXT("Logs requester count and traced/prefiltered totals for the visibility service of the current world"),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* world)
+	{
+		if (AVisibilityService* service = GetWorldManager<AVisibilityService>(world, false))
+		{
+			service->LogStats();
+		}
+	})
+);
+
+AVisibilityService::AVisibilityService()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+	bReplicates = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+
+	_tracesPerFrame = 8;
+	_resultMaxAge = 0.2f;
+	_requestTimeout = 1.f;
+
+	_roundRobinCursor = 0;
+	_tracedCount = 0;
+	_prefilteredCount = 0;
+}
+
+AVisibilityService* AVisibilityService::Get(const UObject* worldContextObject)
+{
+	return GetWorldManager<AVisibilityService>(worldContextObject);
+}
+
+void AVisibilityService::RequestVisibility(APawn* viewer, float sightDistance, float coneHalfAngleDegrees)
+{
+	if (!viewer)
+	{
+		return;
+	}
+
+	const float worldTime = GetWorld()->GetTimeSeconds();
+	const float coneCosine = FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(coneHalfAngleDegrees, 0.f, 180.f)));
+
+	if (const int32* existingIndex = _viewerIndices.Find(viewer))
+	{
+		_sightDistancesSquared[*existingIndex] = FMath::Square(sightDistance);
+		_coneCosines[*existingIndex] = coneCosine;
+		_lastRequestTimes[*existingIndex] = worldTime;
+		return;
+	}
+
+	_viewerIndices.Add(viewer, _viewers.Num());
+	_viewers.Add(viewer);
+	_viewerLocations.Add(viewer->GetActorLocation());
+	_viewerForwards.Add(viewer->GetActorForwardVector());
+	_sightDistancesSquared.Add(FMath::Square(sightDistance));
+	_coneCosines.Add(coneCosine);
+	_lastRequestTimes.Add(worldTime);
+	_resultTimes.Add(-1.f);
+	_canSee.Add(0);
+	_inRange.Add(0);
+	_traceHandles.Add(FTraceHandle());
+}
+
+bool AVisibilityService::GetVisibility(const APawn* viewer, bool& outCanSee, float& outResultAge) const
+{
+	outCanSee = false;
+	outResultAge = MAX_FLT;
+
+	const int32* requestIndex = _viewerIndices.Find(viewer);
+	if (!requestIndex || _resultTimes[*requestIndex] < 0.f)
+	{
+		return false;
+	}
+
+	outCanSee = _canSee[*requestIndex] != 0;
+	outResultAge = GetWorld()->GetTimeSeconds() - _resultTimes[*requestIndex];
+	return true;
+}
+
+void AVisibilityService::RemoveRequest(const APawn* viewer)
+{
+	if (const int32* requestIndex = _viewerIndices.Find(viewer))
+	{
+		RemoveRequestAtSwap(*requestIndex);
+	}
+}
+
+void AVisibilityService::LogStats() const
+{
+	UE_LOG(LogVisibilityService, Log, TEXT("Visibility: %d requesters, %d traces per frame, %d traced, %d answered by the prefilter"),
+		_viewers.Num(), _tracesPerFrame, _tracedCount, _prefilteredCount);
+}
+
+void AVisibilityService::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const float worldTime = GetWorld()->GetTimeSeconds();
+
+	ResolveTraces(worldTime);
+	RemoveStaleRequests(worldTime);
+
+	if (_viewers.Num() == 0)
+	{
+		return;
+	}
+
+	if (!_target.IsValid())
+	{
+		_target = UGameplayStatics::GetPlayerPawn(this, 0);
+	}
+
+	if (!_target.IsValid())
+	{
+		return;
+	}
+
+	const FVector targetLocation = _target->GetActorLocation();
+	Prefilter(targetLocation, worldTime);
+	IssueTraces(targetLocation, worldTime);
+}
+
+// Reads back the traces issued last frame, the viewer can see the target if the first thing blocking the line is the target
+void AVisibilityService::ResolveTraces(float worldTime)
+{
+	UWorld* const world = GetWorld();
+	const AActor* target = _target.Get();
+	FTraceDatum traceData;
+
+	const int32 requestCount = _viewers.Num();
+	for (int32 i = 0; i < requestCount; i++)
+	{
+		if (!_traceHandles[i].IsValid())
+		{
+			continue;
+		}
+
+		const bool hasData = world->QueryTraceData(_traceHandles[i], traceData);
+		_traceHandles[i].Invalidate();
+		if (!hasData)
+		{
+			continue;
+		}
+
+		bool canSee = false;
+		for (const FHitResult& hit : traceData.OutHits)
+		{
+			if (hit.bBlockingHit)
+			{
+				canSee = target && hit.GetActor() == target;
+				break;
+			}
+		}
+
+		_canSee[i] = canSee ? 1 : 0;
+		_resultTimes[i] = worldTime;
+	}
+}
+
+void AVisibilityService::RemoveStaleRequests(float worldTime)
+{
+	for (int32 i = _viewers.Num() - 1; i >= 0; i--)
+	{
+		if (!_viewers[i].IsValid() || worldTime - _lastRequestTimes[i] > _requestTimeout)
+		{
+			RemoveRequestAtSwap(i);
+		}
+	}
+}
+
+// Distance and view cone for every requester at once. Anything outside either can't see the target and is answered without a trace
+void AVisibilityService::Prefilter(const FVector& targetLocation, float worldTime)
+{
+	const int32 requestCount = _viewers.Num();
+
+	FVector* viewerLocations = _viewerLocations.GetData();
+	FVector* viewerForwards = _viewerForwards.GetData();
+	for (int32 i = 0; i < requestCount; i++)
+	{
+		const APawn* viewer = _viewers[i].Get();
+		viewerLocations[i] = viewer->GetActorLocation();
+		viewerForwards[i] = viewer->GetActorForwardVector();
+	}
+
+	// Kept as a flat loop over the arrays so the compiler can vectorize it
+	const float* sightDistancesSquared = _sightDistancesSquared.GetData();
+	const float* coneCosines = _coneCosines.GetData();
+	uint8* inRange = _inRange.GetData();
+	for (int32 i = 0; i < requestCount; i++)
+	{
+		const FVector toTarget = targetLocation - viewerLocations[i];
+		const float distanceSquared = toTarget.SizeSquared();
+		const float forwardDot = FVector::DotProduct(toTarget, viewerForwards[i]);
+		inRange[i] = (distanceSquared <= sightDistancesSquared[i] && forwardDot >= coneCosines[i] * FMath::Sqrt(distanceSquared)) ? 1 : 0;
+	}
+
+	for (int32 i = 0; i < requestCount; i++)
+	{
+		if (!inRange[i])
+		{
+			_canSee[i] = 0;
+			_resultTimes[i] = worldTime;
+			_prefilteredCount++;
+		}
+	}
+}
+
+// Starts where the last frame's budget ran out so every requester gets a turn, however many there are
+void AVisibilityService::IssueTraces(const FVector& targetLocation, float worldTime)
+{
+	UWorld* const world = GetWorld();
+	const int32 requestCount = _viewers.Num();
+
+	// Camera channel like the blueprint, pawns ignore Visibility. Enemies don't block each other's view
+	FCollisionQueryParams traceParams(FName(TEXT("VisibilityServiceTrace")), false);
+	bool builtParams = false;
+
+	int32 budget = _tracesPerFrame;
+	int32 scanned = 0;
+	for (; scanned < requestCount && budget > 0; scanned++)
+	{
+		const int32 i = (_roundRobinCursor + scanned) % requestCount;
+		if (!_inRange[i] || _traceHandles[i].IsValid() || (_resultTimes[i] >= 0.f && worldTime - _resultTimes[i] < _resultMaxAge))
+		{
+			continue;
+		}
+
+		if (!builtParams)
+		{
+			for (const TWeakObjectPtr<APawn>& viewer : _viewers)
+			{
+				traceParams.AddIgnoredActor(viewer.Get());
+			}
+			builtParams = true;
+		}
+
+		_traceHandles[i] = world->AsyncLineTraceByChannel(EAsyncTraceType::Single, _viewerLocations[i], targetLocation, ECC_Camera, traceParams);
+		budget--;
+		_tracedCount++;
+	}
+
+	_roundRobinCursor = (_roundRobinCursor + scanned) % requestCount;
+
+	INC_DWORD_STAT_BY(STAT_VisibilityTraces, _tracesPerFrame - budget);
+	FRSTestQueryCounters::VisibilityTraces += _tracesPerFrame - budget;
+}
+
+void AVisibilityService::RemoveRequestAtSwap(int32 requestIndex)
+{
+	_viewerIndices.Remove(_viewers[requestIndex]);
+
+	_viewers.RemoveAtSwap(requestIndex, 1, false);
+	_viewerLocations.RemoveAtSwap(requestIndex, 1, false);
+	_viewerForwards.RemoveAtSwap(requestIndex, 1, false);
+	_sightDistancesSquared.RemoveAtSwap(requestIndex, 1, false);
+	_coneCosines.RemoveAtSwap(requestIndex, 1, false);
+	_lastRequestTimes.RemoveAtSwap(requestIndex, 1, false);
+	_resultTimes.RemoveAtSwap(requestIndex, 1, false);
+	_canSee.RemoveAtSwap(requestIndex, 1, false);
+	_inRange.RemoveAtSwap(requestIndex, 1, false);
+	_traceHandles.RemoveAtSwap(requestIndex, 1, false);
+
+	// The last request moved into the removed slot
+	if (_viewers.IsValidIndex(requestIndex))
+	{
+		_viewerIndices.Add(_viewers[requestIndex], requestIndex);
+	}
+}
@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "WorldCollision.h"
+#include "VisibilityService.generated.h"
+
+/**
+ * Answers "can this enemy see the player" for every enemy from one place. Each frame all requests go through a cheap
+ * distance and view cone check in flat arrays, then only the ones that pass and whose result has gone stale get a line trace.
+ * Traces are async, issued round-robin under a fixed per-frame budget and read back the next frame, so line of sight costs
+ * the same per frame however many enemies are spawned. Results are cached with the time they were made. Assumes there's only 1 player.
+ */
+UCLASS(config=Game, notplaceable)
+class RSTEST_API AVisibilityService : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AVisibilityService();
+
+	static AVisibilityService* Get(const UObject* worldContextObject);
+
+	//Variables
+protected:
+	// Hard cap on line of sight traces started per frame
+	UPROPERTY(config, EditDefaultsOnly, Category = "Visibility Data", meta = (ClampMin = 1))
+	int32 _tracesPerFrame;
+
+	// A result younger than this isn't traced again
+	UPROPERTY(config, EditDefaultsOnly, Category = "Visibility Data", meta = (ClampMin = 0))
+	float _resultMaxAge;
+
+	// Requests that haven't been renewed for this long are dropped
+	UPROPERTY(config, EditDefaultsOnly, Category = "Visibility Data", meta = (ClampMin = 0))
+	float _requestTimeout;
+
+private:
+	// Structure of arrays, index i is the same requester in all of them
+	TArray<TWeakObjectPtr<APawn>> _viewers;
+	TArray<FVector> _viewerLocations;
+	TArray<FVector> _viewerForwards;
+	TArray<float> _sightDistancesSquared;
+	TArray<float> _coneCosines;
+	TArray<float> _lastRequestTimes;
+	TArray<float> _resultTimes;
+	TArray<uint8> _canSee;
+	TArray<uint8> _inRange;
+	TArray<FTraceHandle> _traceHandles;
+
+	// Weak keys so a destroyed viewer's entry can still be found and removed
+	TMap<TWeakObjectPtr<const APawn>, int32> _viewerIndices;
+
+	TWeakObjectPtr<APawn> _target;
+
+	int32 _roundRobinCursor;
+
+	int32 _tracedCount;
+	int32 _prefilteredCount;
+
+	//GettersAndSetters
+public:
+	UFUNCTION(BlueprintCallable, Category = "Visibility GetSet")
+	int32 GetRequesterCount() const { return _viewers.Num(); }
+
+	//Functions
+public:
+	// Registers the viewer, or renews its request. Has to be renewed within the request timeout to stay registered
+	void RequestVisibility(APawn* viewer, float sightDistance, float coneHalfAngleDegrees);
+
+	// The last result for the viewer, false if there isn't one yet
+	bool GetVisibility(const APawn* viewer, bool& outCanSee, float& outResultAge) const;
+
+	void RemoveRequest(const APawn* viewer);
+
+	void LogStats() const;
+
+protected:
+	virtual void Tick(float DeltaTime) override;
+
+	void ResolveTraces(float worldTime);
+
+	void RemoveStaleRequests(float worldTime);
+
+	void Prefilter(const FVector& targetLocation, float worldTime);
+
+	void IssueTraces(const FVector& targetLocation, float worldTime);
+
+	void RemoveRequestAtSwap(int32 requestIndex);
+};
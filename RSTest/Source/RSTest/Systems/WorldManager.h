@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+/**
+ * Returns the single manager actor of type TManager for the world the context object lives in.
+ * A manager placed in the level is used if there is one, otherwise one is spawned on first use.
+ * Lookups are cached per world so this is cheap enough to call from gameplay hot paths.
+ */
+template<class TManager>
+TManager* GetWorldManager(const UObject* worldContextObject, bool spawnIfMissing = true)
+{
+	UWorld* world = GEngine ? GEngine->GetWorldFromContextObject(worldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	if (!world || !world->IsGameWorld())
+	{
+		return nullptr;
+	}
+
+	static TMap<TWeakObjectPtr<UWorld>, TWeakObjectPtr<TManager>> managersByWorld;
+
+	TWeakObjectPtr<TManager>* cachedManager = managersByWorld.Find(world);
+	if (cachedManager && cachedManager->IsValid())
+	{
+		return cachedManager->Get();
+	}
+
+	TManager* manager = nullptr;
+	for (TActorIterator<TManager> it(world); it; ++it)
+	{
+		if (!it->IsPendingKill())
+		{
+			manager = *it;
+			break;
+		}
+	}
+
+	if (!manager && spawnIfMissing && !world->bIsTearingDown)
+	{
+		FActorSpawnParameters spawnParams;
+		spawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		spawnParams.ObjectFlags |= RF_Transient;
+		manager = world->SpawnActor<TManager>(TManager::StaticClass(), FTransform::Identity, spawnParams);
+	}
+
+	if (manager)
+	{
+		// Drop entries for worlds that have since been torn down (PIE sessions, map travel)
+		for (auto it = managersByWorld.CreateIterator(); it; ++it)
+		{
+			if (!it.Key().IsValid())
+			{
+				it.RemoveCurrent();
+			}
+		}
+		managersByWorld.Add(world, manager);
+	}
+
+	return manager;
+}
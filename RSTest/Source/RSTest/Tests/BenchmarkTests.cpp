@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/AutomationCommon.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "Systems/BenchmarkRunner.h"
+#include "Systems/WorldManager.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// GameDefaultMap, the map a plain -RSBenchmark run uses
+static const TCHAR* const GBenchmarkMap = TEXT("/Game/FirstPersonCPP/Maps/FirstPersonExampleMap");
+
+static UWorld* GetBenchmarkWorld()
+{
+	for (const FWorldContext& worldContext : GEngine->GetWorldContexts())
+	{
+		if ((worldContext.WorldType == EWorldType::Game || worldContext.WorldType == EWorldType::PIE) && worldContext.World())
+		{
+			return worldContext.World();
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * Starts one benchmark scenario once the map's player has spawned and waits for it to finish. Fails if the scenario
+ * doesn't start, doesn't report a result or takes longer than timeoutSeconds
+ */
+class FRunBenchmarkScenarioCommand : public IAutomationLatentCommand
+{
+public:
+	FRunBenchmarkScenarioCommand(FAutomationTestBase* test, const FString& scenarioName, float timeoutSeconds)
+		: _test(test)
+		, _scenarioName(scenarioName)
+		, _timeoutSeconds(timeoutSeconds)
+		, _hasStarted(false)
+	{
+	}
+
+	virtual bool Update() override
+	{
+		if (GetCurrentRunTime() > _timeoutSeconds)
+		{
+			_test->AddError(FString::Printf(TEXT("Benchmark scenario %s didn't finish within %.0f seconds"), *_scenarioName, _timeoutSeconds));
+			return true;
+		}
+
+		UWorld* world = GetBenchmarkWorld();
+		ABenchmarkRunner* benchmarkRunner = world ? GetWorldManager<ABenchmarkRunner>(world) : nullptr;
+
+		if (!_hasStarted)
+		{
+			if (!benchmarkRunner || !UGameplayStatics::GetPlayerPawn(world, 0))
+			{
+				return false; // Still loading
+			}
+
+			benchmarkRunner->StartBenchmarks(_scenarioName, false);
+			_hasStarted = true;
+			if (!benchmarkRunner->GetIsRunning())
+			{
+				_test->AddError(FString::Printf(TEXT("Benchmark scenario %s didn't start"), *_scenarioName));
+				return true;
+			}
+			return false;
+		}
+
+		if (!benchmarkRunner)
+		{
+			_test->AddError(FString::Printf(TEXT("The world went away while benchmark scenario %s was running"), *_scenarioName));
+			return true;
+		}
+
+		if (benchmarkRunner->GetIsRunning())
+		{
+			return false;
+		}
+
+		_test->TestEqual(FString::Printf(TEXT("Results reported by %s"), *_scenarioName), benchmarkRunner->GetResultCount(), 1);
+		return true;
+	}
+
+private:
+	FAutomationTestBase* _test;
+	FString _scenarioName;
+	float _timeoutSeconds;
+	bool _hasStarted;
+};
+
+// Scenarios take warmup plus measure seconds, the timeouts leave room for loading on top
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBenchmarkIdleTest, "RSTest.Benchmark.Idle", EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FBenchmarkIdleTest::RunTest(const FString& Parameters)
+{
+	AutomationOpenMap(GBenchmarkMap);
+	ADD_LATENT_AUTOMATION_COMMAND(FRunBenchmarkScenarioCommand(this, TEXT("Idle"), 60.f));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBenchmarkChannelersTest, "RSTest.Benchmark.Channelers32", EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FBenchmarkChannelersTest::RunTest(const FString& Parameters)
+{
+	AutomationOpenMap(GBenchmarkMap);
+	ADD_LATENT_AUTOMATION_COMMAND(FRunBenchmarkScenarioCommand(this, TEXT("Channelers32"), 90.f));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PlayerHealthWidget.h"
+#include "Components/InvalidationBox.h"
+#include "Components/LifeSystem.h"
+#include "Components/ProgressBar.h"
+#include "Components/TextBlock.h"
+
+void UPlayerHealthWidget::SetLifeSystem(ULifeSystem* lifeSystem)
+{
+	if (_lifeSystem.IsValid())
+	{
+		_lifeSystem->OnHealthChangedNative.Remove(_healthChangedHandle);
+	}
+	_healthChangedHandle.Reset();
+
+	_lifeSystem = lifeSystem;
+	if (lifeSystem)
+	{
+		_healthChangedHandle = lifeSystem->OnHealthChangedNative.AddUObject(this, &UPlayerHealthWidget::OnHealthChanged);
+		ShowHealth(lifeSystem->GetHealth(), lifeSystem->GetMaxHealth());
+	}
+}
+
+void UPlayerHealthWidget::NativeDestruct()
+{
+	SetLifeSystem(nullptr);
+
+	Super::NativeDestruct();
+}
+
+void UPlayerHealthWidget::OnHealthChanged(ULifeSystem* lifeSystem, float newHealth, float oldHealth)
+{
+	ShowHealth(newHealth, lifeSystem->GetMaxHealth());
+}
+
+void UPlayerHealthWidget::ShowHealth(float health, float maxHealth)
+{
+	if (HealthBar)
+	{
+		HealthBar->SetPercent(maxHealth > 0.f ? health / maxHealth : 0.f);
+	}
+
+	if (HealthText)
+	{
+		HealthText->SetText(FText::AsNumber(FMath::CeilToInt(health)));
+	}
+
+	// The cached draw is stale now, everything else in the box stays cached
+	if (HealthInvalidationBox)
+	{
+		HealthInvalidationBox->InvalidateCache();
+	}
+
+	OnHealthUpdated(health, maxHealth);
+}
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "PlayerHealthWidget.generated.h"
+
+class UInvalidationBox;
+class ULifeSystem;
+class UProgressBar;
+class UTextBlock;
+
+/**
+ * Base class for PlayerWidget. Shows the player's health without polling: it listens to the life system's
+ * health changed event and only then updates the bar and text. Put the health widgets, and anything static, inside
+ * an invalidation box named HealthInvalidationBox so Slate reuses the cached draw between changes.
+ */
+UCLASS()
+class RSTEST_API UPlayerHealthWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+	//Variables
+protected:
+	UPROPERTY(BlueprintReadOnly, Category = "Player Health Widget", meta = (BindWidgetOptional))
+	UInvalidationBox* HealthInvalidationBox;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Player Health Widget", meta = (BindWidgetOptional))
+	UProgressBar* HealthBar;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Player Health Widget", meta = (BindWidgetOptional))
+	UTextBlock* HealthText;
+
+private:
+	TWeakObjectPtr<ULifeSystem> _lifeSystem;
+	FDelegateHandle _healthChangedHandle;
+
+	//Functions
+public:
+	// Stops listening to the previous life system, if any, and shows this one's health
+	void SetLifeSystem(ULifeSystem* lifeSystem);
+
+protected:
+	virtual void NativeDestruct() override;
+
+	void OnHealthChanged(ULifeSystem* lifeSystem, float newHealth, float oldHealth);
+
+	void ShowHealth(float health, float maxHealth);
+
+	// For anything extra the blueprint wants to do, called only when health changes
+	UFUNCTION(BlueprintImplementableEvent, Category = "Player Health Widget")
+	void OnHealthUpdated(float health, float maxHealth);
+};